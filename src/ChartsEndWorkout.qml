@@ -19,11 +19,33 @@ ChartsEndWorkoutForm {
         }
     }
 
+    function updatePowerCurve()
+    {
+        var durations = rootItem.power_curve_durations;
+        var points = rootItem.power_curve_points;
+        powerCurveSeries.clear();
+        for(var i=0;i<durations.length;i++)
+        {
+            // durations not reached yet are 0
+            if(points[i] <= 0)
+                break;
+            powerCurveSeries.append(durations[i], points[i]);
+        }
+    }
+
+    Connections {
+        target: rootItem
+        function onPowerCurveChanged() {
+            updatePowerCurve();
+        }
+    }
+
     function saveScreenshot()
     {
         rootItem.save_screenshot_chart(powerChart, "powerChart");
         rootItem.save_screenshot_chart(heartChart, "heartChart");
         rootItem.save_screenshot_chart(cadenceChart, "cadenceChart");
+        rootItem.save_screenshot_chart(powerCurveChart, "powerCurveChart");
         timer.stopTimer(saveScreenshot)
         timer.startTimer(sendMail, 100);
     }
@@ -38,15 +60,23 @@ ChartsEndWorkoutForm {
         headerToolbar.visible = true;
 
         //console.log("ChartsEndWorkoutForm completed " + rootItem.workout_sample_points)
-        for(var i=0;i<rootItem.workout_sample_points;i+=10)
+        // every property read copies a whole column, so read each one once
+        var samples = rootItem.workout_sample_points;
+        var watt = rootItem.workout_watt_points;
+        var heart = rootItem.workout_heart_points;
+        var cadence = rootItem.workout_cadence_points;
+        var resistance = rootItem.workout_resistance_points;
+        var pelotonResistance = rootItem.workout_peloton_resistance_points;
+        for(var i=0;i<samples;i+=10)
         {
-            //console.log("ChartsEndWorkoutForm completed " + i + " " + rootItem.workout_watt_points[i])
-            powerSeries.append(i * 1000, rootItem.workout_watt_points[i]);
-            heartSeries.append(i * 1000, rootItem.workout_heart_points[i]);
-            cadenceSeries.append(i * 1000, rootItem.workout_cadence_points[i]);
-            resistanceSeries.append(i * 1000, rootItem.workout_resistance_points[i]);
-            pelotonResistanceSeries.append(i * 1000, rootItem.workout_peloton_resistance_points[i]);
+            //console.log("ChartsEndWorkoutForm completed " + i + " " + watt[i])
+            powerSeries.append(i * 1000, watt[i]);
+            heartSeries.append(i * 1000, heart[i]);
+            cadenceSeries.append(i * 1000, cadence[i]);
+            resistanceSeries.append(i * 1000, resistance[i]);
+            pelotonResistanceSeries.append(i * 1000, pelotonResistance[i]);
         }
+        updatePowerCurve();
         rootItem.update_chart_power(powerChart);
         //rootItem.update_axes(valueAxisX, valueAxisY);
         rootItem.update_chart_heart(heartChart);
@@ -16,7 +16,7 @@ void bike::changeResistance(resistance_t resistance) {
 }
 
 void bike::changeInclination(double grade, double percentage) {
-    qDebug() << QStringLiteral("bike::changeInclination") << autoResistanceEnable << grade << percentage;
+    qzCDebug(qzDevice) << QStringLiteral("bike::changeInclination") << autoResistanceEnable << grade << percentage;
     if (autoResistanceEnable) {
         requestInclination = grade;
     }
@@ -48,16 +48,16 @@ void bike::changePower(int32_t power) {
 
     double deltaDown = wattsMetric().value() - ((double)power);
     double deltaUp = ((double)power) - wattsMetric().value();
-    qDebug() << QStringLiteral("filter  ") + QString::number(deltaUp) + " " + QString::number(deltaDown) + " " +
-                    QString::number(erg_filter_upper) + " " + QString::number(erg_filter_lower);
+    qzCDebug(qzDevice) << QStringLiteral("filter  ") + QString::number(deltaUp) + " " + QString::number(deltaDown) + " " +
+                   QString::number(erg_filter_upper) + " " + QString::number(erg_filter_lower);
     if (!ergModeSupported && force_resistance /*&& erg_mode*/ &&
         (deltaUp > erg_filter_upper || deltaDown > erg_filter_lower)) {
         resistance_t r = (resistance_t)resistanceFromPowerRequest(power);
         if ((double)r > zwift_erg_resistance_up) {
-            qDebug() << "zwift_erg_resistance_up filter enabled!";
+            qzCDebug(qzDevice) << "zwift_erg_resistance_up filter enabled!";
             r = (resistance_t)zwift_erg_resistance_up;
         } else if ((double)r < zwift_erg_resistance_down) {
-            qDebug() << "zwift_erg_resistance_down filter enabled!";
+            qzCDebug(qzDevice) << "zwift_erg_resistance_down filter enabled!";
             r = (resistance_t)zwift_erg_resistance_down;
         }
         changeResistance(r); // resistance start from 1
@@ -66,7 +66,7 @@ void bike::changePower(int32_t power) {
 
 int8_t bike::gears() { return m_gears; }
 void bike::setGears(int8_t gears) {
-    qDebug() << "setGears" << gears;
+    qzCDebug(qzDevice) << "setGears" << gears;
     m_gears = gears;
     if (lastRawRequestedResistanceValue != -1) {
         changeResistance(lastRawRequestedResistanceValue);
@@ -75,15 +75,15 @@ void bike::setGears(int8_t gears) {
 
 double bike::currentCrankRevolutions() { return CrankRevs; }
 uint16_t bike::lastCrankEventTime() { return LastCrankEventTime; }
-metric bike::lastRequestedResistance() { return RequestedResistance; }
-metric bike::lastRequestedPelotonResistance() { return RequestedPelotonResistance; }
-metric bike::lastRequestedCadence() { return RequestedCadence; }
-metric bike::lastRequestedPower() { return RequestedPower; }
-metric bike::currentResistance() { return Resistance; }
+const metric &bike::lastRequestedResistance() { return RequestedResistance; }
+const metric &bike::lastRequestedPelotonResistance() { return RequestedPelotonResistance; }
+const metric &bike::lastRequestedCadence() { return RequestedCadence; }
+const metric &bike::lastRequestedPower() { return RequestedPower; }
+const metric &bike::currentResistance() { return Resistance; }
 uint8_t bike::fanSpeed() { return FanSpeed; }
 bool bike::connected() { return false; }
 uint16_t bike::watts() { return 0; }
-metric bike::pelotonResistance() { return m_pelotonResistance; }
+const metric &bike::pelotonResistance() { return m_pelotonResistance; }
 resistance_t bike::pelotonToBikeResistance(int pelotonResistance) { return pelotonResistance; }
 resistance_t bike::resistanceFromPowerRequest(uint16_t power) { return power / 10; } // in order to have something
 void bike::cadenceSensor(uint8_t cadence) { Cadence.setValue(cadence); }
@@ -10,11 +10,11 @@ class bike : public bluetoothdevice {
 
   public:
     bike();
-    metric lastRequestedResistance();
-    metric lastRequestedPelotonResistance();
-    metric lastRequestedCadence();
-    metric lastRequestedPower();
-    virtual metric currentResistance();
+    const metric &lastRequestedResistance();
+    const metric &lastRequestedPelotonResistance();
+    const metric &lastRequestedCadence();
+    const metric &lastRequestedPower();
+    virtual const metric &currentResistance();
     virtual uint8_t fanSpeed();
     virtual double currentCrankRevolutions();
     virtual uint16_t lastCrankEventTime();
@@ -25,7 +25,7 @@ class bike : public bluetoothdevice {
     virtual uint16_t powerFromResistanceRequest(resistance_t requestResistance);
     virtual bool ergManagedBySS2K() { return false; }
     bluetoothdevice::BLUETOOTH_TYPE deviceType();
-    metric pelotonResistance();
+    const metric &pelotonResistance();
     void clearStats();
     void setLap();
     void setPaused(bool p);
@@ -41,7 +41,7 @@ class bike : public bluetoothdevice {
      * for the Elite Sterzo or emulating device. Expected range -45 to +45 degrees.
      * @return A metric object.
      */
-    metric currentSteeringAngle() { return m_steeringAngle; }
+    const metric &currentSteeringAngle() { return m_steeringAngle; }
     virtual bool inclinationAvailableByHardware();
 
   public Q_SLOTS:
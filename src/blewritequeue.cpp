@@ -0,0 +1,197 @@
+#include "blewritequeue.h"
+#include "latencytrace.h"
+#include "qzdebug.h"
+
+#include <QDateTime>
+#include <QDebug>
+
+blewritequeue::blewritequeue(QObject *parent) : QObject(parent) {
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, &blewritequeue::expired);
+}
+
+void blewritequeue::setMaxInFlight(int maxInFlight) {
+    m_maxInFlight = qMax(1, maxInFlight);
+    pump();
+}
+
+void blewritequeue::write(QLowEnergyService *service, const QLowEnergyCharacteristic &characteristic,
+                          const QByteArray &value, bool waitForResponse, completion done) {
+    if (!service || !characteristic.isValid()) {
+        qDebug() << QStringLiteral("blewritequeue: invalid service or characteristic, write dropped");
+        if (done)
+            done(false, QByteArray());
+        return;
+    }
+
+    if (!watched.contains(service)) {
+        watched.insert(service);
+        connect(service, &QLowEnergyService::characteristicWritten, this, &blewritequeue::characteristicWritten);
+        connect(service, &QLowEnergyService::characteristicChanged, this, &blewritequeue::characteristicChanged);
+        connect(service,
+                static_cast<void (QLowEnergyService::*)(QLowEnergyService::ServiceError)>(&QLowEnergyService::error),
+                this, &blewritequeue::serviceError);
+        connect(service, &QObject::destroyed, this, [this, service]() { watched.remove(service); });
+    }
+
+    request r;
+    r.service = service;
+    r.characteristic = characteristic;
+    r.value = value;
+    if (waitForResponse)
+        r.event = RESPONSE;
+    else if (!(characteristic.properties() & QLowEnergyCharacteristic::Write) &&
+             (characteristic.properties() & QLowEnergyCharacteristic::WriteNoResponse))
+        r.event = SENT;
+    else
+        r.event = WRITTEN;
+    r.done = std::move(done);
+    queue.enqueue(std::move(r));
+    pump();
+}
+
+void blewritequeue::delay(int msec) {
+    request r;
+    r.event = DELAY;
+    r.delay = msec;
+    queue.enqueue(std::move(r));
+    pump();
+}
+
+void blewritequeue::pump() {
+    while (!queue.isEmpty() && inFlight.size() < m_maxInFlight) {
+        if (!inFlight.isEmpty() && inFlight.constLast().event == DELAY)
+            break;
+        if (queue.head().event == DELAY) {
+            // a delay starts once everything before it completed
+            if (!inFlight.isEmpty())
+                break;
+            request r = queue.dequeue();
+            r.deadline = QDateTime::currentMSecsSinceEpoch() + r.delay;
+            inFlight.append(std::move(r));
+            break;
+        }
+
+        request r = queue.dequeue();
+        if (!r.service || r.service->state() != QLowEnergyService::ServiceDiscovered) {
+            qDebug() << QStringLiteral("blewritequeue: service gone, write dropped");
+            if (r.done)
+                r.done(false, QByteArray());
+            continue;
+        }
+
+        r.deadline = QDateTime::currentMSecsSinceEpoch() + m_timeout;
+        QLowEnergyService *service = r.service;
+        const QLowEnergyCharacteristic characteristic = r.characteristic;
+        const QByteArray value = r.value;
+        const bool sent = r.event == SENT;
+        inFlight.append(std::move(r));
+
+        service->writeCharacteristic(characteristic, value,
+                                     sent ? QLowEnergyService::WriteWithoutResponse
+                                          : QLowEnergyService::WriteWithResponse);
+        latencytrace::mark(latencytrace::COMMAND_WRITTEN);
+        qzCDebug(qzDeviceRaw) << characteristic.uuid() << QStringLiteral(" >> ") << value.toHex(' ');
+        if (sent) {
+            // no confirmation will come: free the slot once the stack had the chance to send it
+            QTimer::singleShot(0, this, [this, service]() {
+                for (int i = 0; i < inFlight.size(); i++) {
+                    if (inFlight.at(i).event == SENT && inFlight.at(i).service == service) {
+                        complete(i, true, QByteArray());
+                        return;
+                    }
+                }
+            });
+        }
+    }
+    armTimer();
+}
+
+void blewritequeue::complete(int index, bool ok, const QByteArray &response) {
+    request r = inFlight.takeAt(index);
+    if (r.done)
+        r.done(ok, response);
+    pump();
+    if (queue.isEmpty() && inFlight.isEmpty())
+        emit idle();
+}
+
+void blewritequeue::armTimer() {
+    if (inFlight.isEmpty()) {
+        timer.stop();
+        return;
+    }
+    qint64 first = inFlight.constFirst().deadline;
+    for (const request &r : qAsConst(inFlight))
+        first = qMin(first, r.deadline);
+    timer.start(qMax<qint64>(0, first - QDateTime::currentMSecsSinceEpoch()));
+}
+
+void blewritequeue::characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &value) {
+    Q_UNUSED(value);
+    QLowEnergyService *service = qobject_cast<QLowEnergyService *>(sender());
+    for (int i = 0; i < inFlight.size(); i++) {
+        const request &r = inFlight.at(i);
+        if (r.event == WRITTEN && r.service == service && r.characteristic.uuid() == characteristic.uuid()) {
+            complete(i, true, QByteArray());
+            return;
+        }
+    }
+}
+
+void blewritequeue::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &value) {
+    Q_UNUSED(characteristic);
+    if (m_manualResponses)
+        return;
+    QLowEnergyService *service = qobject_cast<QLowEnergyService *>(sender());
+    for (int i = 0; i < inFlight.size(); i++) {
+        if (inFlight.at(i).event == RESPONSE && inFlight.at(i).service == service) {
+            complete(i, true, value);
+            return;
+        }
+    }
+}
+
+void blewritequeue::responseReceived(const QByteArray &value) {
+    for (int i = 0; i < inFlight.size(); i++) {
+        if (inFlight.at(i).event == RESPONSE) {
+            complete(i, true, value);
+            return;
+        }
+    }
+}
+
+void blewritequeue::serviceError(QLowEnergyService::ServiceError error) {
+    if (error != QLowEnergyService::CharacteristicWriteError)
+        return;
+    QLowEnergyService *service = qobject_cast<QLowEnergyService *>(sender());
+    for (int i = 0; i < inFlight.size(); i++) {
+        if (inFlight.at(i).event != DELAY && inFlight.at(i).service == service) {
+            qDebug() << QStringLiteral("blewritequeue: write error") << inFlight.at(i).value.toHex(' ');
+            complete(i, false, QByteArray());
+            return;
+        }
+    }
+}
+
+void blewritequeue::expired() {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i < inFlight.size(); i++) {
+        if (inFlight.at(i).deadline <= now) {
+            if (inFlight.at(i).event == DELAY) {
+                complete(i, true, QByteArray());
+                return;
+            }
+            qDebug() << QStringLiteral("blewritequeue: exit for timeout") << inFlight.at(i).value.toHex(' ');
+            complete(i, false, QByteArray());
+            return; // complete() re-arms the timer for the next one
+        }
+    }
+    armTimer();
+}
+
+void blewritequeue::clear() {
+    queue.clear();
+    inFlight.clear();
+    timer.stop();
+}
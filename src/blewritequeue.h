@@ -0,0 +1,108 @@
+#ifndef BLEWRITEQUEUE_H
+#define BLEWRITEQUEUE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QSet>
+#include <QTimer>
+
+#include <QtBluetooth/qlowenergycharacteristic.h>
+#include <QtBluetooth/qlowenergyservice.h>
+
+#include <functional>
+
+/**
+ * @brief The blewritequeue class sends the characteristic writes of a device one after the other without blocking:
+ * write() returns immediately and the optional callback runs when the write completed, i.e.
+ * - on characteristicWritten for a write with response,
+ * - on the next notification of the service (or responseReceived()) if a response was requested,
+ * - on the next event loop pass for a write without response,
+ * - after the timeout (300 ms by default) if none of those happened, with ok = false.
+ * Writes are sent in the order they were queued; delay() spaces them out when a device needs it.
+ * Up to maxInFlight() writes are sent before waiting for a completion. The default of 1 keeps the device pacing of
+ * the QEventLoop based writes it replaces; devices that accept pipelined commands can raise it.
+ */
+class blewritequeue : public QObject {
+    Q_OBJECT
+
+  public:
+    typedef std::function<void(bool ok, const QByteArray &response)> completion;
+
+    explicit blewritequeue(QObject *parent = nullptr);
+
+    /**
+     * @brief write Queues a write of value to the characteristic. The write mode follows the characteristic
+     * properties: without response if it only allows that.
+     */
+    void write(QLowEnergyService *service, const QLowEnergyCharacteristic &characteristic, const QByteArray &value,
+               bool waitForResponse = false, completion done = completion());
+
+    /**
+     * @brief delay Holds the next writes for msec after the previous ones completed, the non-blocking equivalent
+     * of a QThread::msleep() between two writes of an init sequence.
+     */
+    void delay(int msec);
+
+    int maxInFlight() const { return m_maxInFlight; }
+    void setMaxInFlight(int maxInFlight);
+    void setTimeout(int msec) { m_timeout = msec; }
+
+    /**
+     * @brief setManualResponses By default any notification of the written service completes the oldest write
+     * waiting for a response. Devices that reassemble their responses call responseReceived() themselves instead.
+     */
+    void setManualResponses(bool manual) { m_manualResponses = manual; }
+
+    /**
+     * @brief pending Number of queued and in flight writes. The polling update() loops skip their writes while
+     * the previous ones are still pending, so the queue never grows.
+     */
+    int pending() const { return queue.size() + inFlight.size(); }
+
+    /**
+     * @brief clear Drops every pending write without calling the callbacks, e.g. on disconnection.
+     */
+    void clear();
+
+  public slots:
+    void responseReceived(const QByteArray &value = QByteArray());
+
+  signals:
+    void idle();
+
+  private slots:
+    void characteristicWritten(const QLowEnergyCharacteristic &characteristic, const QByteArray &value);
+    void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &value);
+    void serviceError(QLowEnergyService::ServiceError error);
+    void expired();
+
+  private:
+    enum completionEvent { WRITTEN, RESPONSE, SENT, DELAY };
+
+    struct request {
+        QPointer<QLowEnergyService> service;
+        QLowEnergyCharacteristic characteristic;
+        QByteArray value;
+        completionEvent event;
+        int delay = 0;
+        completion done;
+        qint64 deadline = 0;
+    };
+
+    void pump();
+    void complete(int index, bool ok, const QByteArray &response);
+    void armTimer();
+
+    QQueue<request> queue;
+    QList<request> inFlight;
+    QSet<QLowEnergyService *> watched;
+    QTimer timer;
+    int m_maxInFlight = 1;
+    int m_timeout = 300;
+    bool m_manualResponses = false;
+};
+
+#endif // BLEWRITEQUEUE_H
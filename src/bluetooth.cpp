@@ -1,5 +1,6 @@
 #include "bluetooth.h"
 #include "homeform.h"
+#include "qzsettingscache.h"
 #include <QBluetoothLocalDevice>
 #include <QDateTime>
 #include <QFile>
@@ -37,7 +38,7 @@ bluetooth::bluetooth(bool logs, const QString &deviceName, bool noWriteResistanc
         TemplateInfoSenderBuilder::getInstance(innerId, QStringList({QStringLiteral(":/inner_templates/")}), this);
 
 #ifdef TEST
-    schwinnIC4Bike = (schwinnic4bike *)new bike();
+    schwinnIC4Bike = (schwinnic4bike *)create<bike>();
     userTemplateManager->start(schwinnIC4Bike);
     innerTemplateManager->start(schwinnIC4Bike);
     connectedAndDiscovered();
@@ -81,7 +82,7 @@ bluetooth::bluetooth(bool logs, const QString &deviceName, bool noWriteResistanc
             (b.toUpper().startsWith("IC BIKE") || b.toUpper().startsWith("C7-"))) {
 
             this->stopDiscovery();
-            schwinnIC4Bike = new schwinnic4bike(noWriteResistance, noHeartService);
+            schwinnIC4Bike = create<schwinnic4bike>(noWriteResistance, noHeartService);
             // stateFileRead();
             QBluetoothDeviceInfo bt;
             bt.setDeviceUuid(QBluetoothUuid(
@@ -169,6 +170,7 @@ void bluetooth::finished() {
 }
 
 void bluetooth::startDiscovery() {
+    driverNamesCompiled = false;
 
 #ifndef Q_OS_IOS
     QSettings settings;
@@ -324,9 +326,53 @@ void bluetooth::setLastBluetoothDevice(const QBluetoothDeviceInfo &b) {
 #endif
 }
 
+#if defined(Q_OS_IOS)
+static QString deviceKey(const QBluetoothDeviceInfo &device) { return device.deviceUuid().toString(); }
+#else
+static QString deviceKey(const QBluetoothDeviceInfo &device) { return device.address().toString(); }
+#endif
+
+void bluetooth::storeDevice(const QBluetoothDeviceInfo &device) {
+    const QString key = deviceKey(device);
+    auto i = deviceIndex.constFind(key);
+    if (i != deviceIndex.constEnd() && !devices.at(i.value()).name().isEmpty()) {
+        devices[i.value()] = device; // in order to keep the freshest copy of this struct
+        indexDriverCandidate(i.value());
+        return;
+    }
+    deviceIndex.insert(key, devices.size());
+    devices.append(device);
+    indexDriverCandidate(devices.size() - 1);
+}
+
+void bluetooth::indexDriverCandidate(int position) {
+    const int rule = driverNames.match(devices.at(position).name());
+    if (rule == devicenamematcher::NO_MATCH)
+        driverCandidates.remove(position);
+    else
+        driverCandidates.insert(position, rule);
+}
+
+// Upper case prefixes of every name the driver chain of deviceDiscovered() looks for. A device matching none of
+// them (nor the name rules that depend on the settings) cannot select a driver and skips the chain, so a crowded
+// scan costs one trie walk per advertiser. Add the prefix here when adding a driver to the chain.
+static const char *const driverNamePrefixes[] = {
+    ">CABLE", "AFG SPORT", "ASSIOMA", "B01_", "B94", "BF70", "BFCP", "BH DUALKIT", "BIKE", "BOWFLEX T216", "C7-",
+    "C9/C10", "CARDIOFIT", "CHRONO ", "CR 00", "CT800", "D2RIDE", "DIRETO XR", "DKN MOTION", "DKN RUN", "DOMYOS",
+    "DS25-", "E25", "E35", "E55", "E95", "E98", "ECH", "ESANGLINKER", "ESLINKER", "EW-BK", "F63", "F65", "F80", "F85",
+    "FLXCY-", "FLYWHEEL", "FS-", "HORIZON", "I-CONSOIE+", "I-CONSOLE+", "I-ROWER", "I-RUNNING", "IBIKING+", "IC",
+    "INRIDE", "I_EB", "I_EL", "I_FS", "I_RW", "I_SB", "I_TL", "I_VE", "JFIC", "JFTM", "KAYAKPRO", "KEEP_BIKE_",
+    "KICKR BIKE", "KICKR ROLLR", "KICKR SNAP", "KINGSMITH", "KS-", "LCB", "M3", "MCF-", "MD", "MERACH-U3", "MKSM",
+    "MRK-", "MYRUN ", "NAUTILUS B", "NAUTILUS E", "NAUTILUS T", "PAFERS_", "PM5", "R1 PRO", "R92", "RE", "ROW-S", "RQ",
+    "RUNNERT", "S77", "SCH130", "SCHWINN 510T", "SMARTROW", "SMB1", "STAGES ", "SUITO", "SW", "T218_", "T318_",
+    "TACX NEO", "TACX SMART BIKE", "TF-", "TOORX", "TREADMILL", "TRUE", "TRX ROUTE KEY", "TRX3500", "TRX4500", "TT8",
+    "TUN ", "V-RUN", "VIFHTR2.1", "WAHOO KICKR", "WHIPR", "WLT2541", "X-BIKE", "XG400", "XT385", "XT485", "XT900",
+    "YS_C1_", "ZR7", "ZW-",
+};
+
 void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
 
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
     QString ftmsAccessoryName =
@@ -380,6 +426,28 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     QString tdf_10_ip = settings.value(QZSettings::tdf_10_ip, QZSettings::default_tdf_10_ip).toString();
     bool manufacturerDeviceFound = false;
 
+    // the settings only change between two discoveries: the name rules they enable are compiled once per discovery
+    if (!driverNamesCompiled) {
+        driverNames.clear();
+        for (const char *prefix : driverNamePrefixes)
+            driverNames.addPrefix(QLatin1String(prefix));
+        driverNames.addPrefix(QLatin1String(yesoulbike::bluetoothName));
+        if (csc_as_bike)
+            driverNames.addPrefix(cscName);
+        if (power_as_bike || power_as_treadmill)
+            driverNames.addPrefix(powerSensorName);
+        if (toorx_bike)
+            driverNames.addSubstring(QStringLiteral("CR011R"));
+        driverNames.setMatchAll(fake_bike || fakedevice_elliptical || fakedevice_treadmill ||
+                                !proformtdf4ip.isEmpty() || !proformtreadmillip.isEmpty() ||
+                                !nordictrack_2950_ip.isEmpty() || !tdf_10_ip.isEmpty());
+        driverNamesCompiled = true;
+        // the rules may have changed: match the devices kept from the previous discoveries again
+        driverCandidates.clear();
+        for (int i = 0; i < devices.size(); i++)
+            indexDriverCandidate(i);
+    }
+
     if (!heartRateBeltFound) {
 
         heartRateBeltFound = heartRateBeltAvaiable();
@@ -418,40 +486,14 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             qDebug() << "yesoulBikeFromManufacturerData forcing!";
             QBluetoothDeviceInfo manufacturerDevice(device.address(), yesoulbike::bluetoothName,
                                                     device.majorDeviceClass());
-
-            bool found = false;
-            QMutableListIterator<QBluetoothDeviceInfo> i(devices);
-            while (i.hasNext()) {
-                QBluetoothDeviceInfo b = i.next();
-                if (SAME_BLUETOOTH_DEVICE(b, manufacturerDevice) && !b.name().isEmpty()) {
-                    i.setValue(manufacturerDevice); // in order to keep the freshest copy of this struct
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                devices.append(manufacturerDevice);
-            }
+            storeDevice(manufacturerDevice);
             manufacturerDeviceFound = true;
         }
 #endif
     }
 
     if (manufacturerDeviceFound == false) {
-        bool found = false;
-        QMutableListIterator<QBluetoothDeviceInfo> i(devices);
-        while (i.hasNext()) {
-            QBluetoothDeviceInfo b = i.next();
-            if (SAME_BLUETOOTH_DEVICE(b, device) && !b.name().isEmpty()) {
-
-                i.setValue(device); // in order to keep the freshest copy of this struct
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            devices.append(device);
-        }
+        storeDevice(device);
     }
 
     emit deviceFound(device.name());
@@ -474,7 +516,9 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     if ((heartRateBeltFound && ftmsAccessoryFound && cscFound && powerSensorFound && eliteRizerFound &&
          eliteSterzoSmartFound) ||
         forceHeartBeltOffForTimeout) {
-        for (const QBluetoothDeviceInfo &b : qAsConst(devices)) {
+        // only the devices whose name was matched when they advertised: no name is walked again here
+        for (auto candidate = driverCandidates.constBegin(); candidate != driverCandidates.constEnd(); ++candidate) {
+            const QBluetoothDeviceInfo &b = devices.at(candidate.key());
 
             bool filter = true;
             if (!filterDevice.isEmpty() && !filterDevice.startsWith(QStringLiteral("Disabled"))) {
@@ -485,7 +529,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
 
                 if (m3ibike::isCorrectUnit(b)) {
                     this->stopDiscovery();
-                    m3iBike = new m3ibike(noWriteResistance, noHeartService);
+                    m3iBike = create<m3ibike>(noWriteResistance, noHeartService);
                     emit deviceConnected(b);
                     connect(m3iBike, &bluetoothdevice::connectedAndDiscovered, this,
                             &bluetooth::connectedAndDiscovered);
@@ -500,7 +544,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 }
             } else if (fake_bike && !fakeBike) {
                 this->stopDiscovery();
-                fakeBike = new fakebike(noWriteResistance, noHeartService, false);
+                fakeBike = create<fakebike>(noWriteResistance, noHeartService, false);
                 emit deviceConnected(b);
                 connect(fakeBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 connect(fakeBike, &fakebike::inclinationChanged, this, &bluetooth::inclinationChanged);
@@ -514,7 +558,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(fakeBike);
             } else if (fakedevice_elliptical && !fakeElliptical) {
                 this->stopDiscovery();
-                fakeElliptical = new fakeelliptical(noWriteResistance, noHeartService, false);
+                fakeElliptical = create<fakeelliptical>(noWriteResistance, noHeartService, false);
                 emit deviceConnected(b);
                 connect(fakeElliptical, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -529,7 +573,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(fakeElliptical);
             } else if (fakedevice_treadmill && !fakeTreadmill) {
                 this->stopDiscovery();
-                fakeTreadmill = new faketreadmill(noWriteResistance, noHeartService, false);
+                fakeTreadmill = create<faketreadmill>(noWriteResistance, noHeartService, false);
                 emit deviceConnected(b);
                 connect(fakeTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -546,7 +590,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (!proformtdf4ip.isEmpty() && !proformWifiBike) {
                 this->stopDiscovery();
                 proformWifiBike =
-                    new proformwifibike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<proformwifibike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(proformWifiBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -561,7 +605,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(proformWifiBike);
             } else if (!proformtreadmillip.isEmpty() && !proformWifiTreadmill) {
                 this->stopDiscovery();
-                proformWifiTreadmill = new proformwifitreadmill(noWriteResistance, noHeartService, bikeResistanceOffset,
+                proformWifiTreadmill = create<proformwifitreadmill>(noWriteResistance, noHeartService, bikeResistanceOffset,
                                                                 bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(proformWifiTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
@@ -577,7 +621,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(proformWifiTreadmill);
             } else if (!nordictrack_2950_ip.isEmpty() && !nordictrackifitadbTreadmill) {
                 this->stopDiscovery();
-                nordictrackifitadbTreadmill = new nordictrackifitadbtreadmill(noWriteResistance, noHeartService);
+                nordictrackifitadbTreadmill = create<nordictrackifitadbtreadmill>(noWriteResistance, noHeartService);
                 emit deviceConnected(b);
                 connect(nordictrackifitadbTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -591,7 +635,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(nordictrackifitadbTreadmill);
             } else if (!tdf_10_ip.isEmpty() && !nordictrackifitadbBike) {
                 this->stopDiscovery();
-                nordictrackifitadbBike = new nordictrackifitadbbike(noWriteResistance, noHeartService);
+                nordictrackifitadbBike = create<nordictrackifitadbbike>(noWriteResistance, noHeartService);
                 emit deviceConnected(b);
                 connect(nordictrackifitadbBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -606,7 +650,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (csc_as_bike && b.name().startsWith(cscName) && !cscBike && filter) {
 
                 this->stopDiscovery();
-                cscBike = new cscbike(noWriteResistance, noHeartService, false);
+                cscBike = create<cscbike>(noWriteResistance, noHeartService, false);
                 emit deviceConnected(b);
                 connect(cscBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -621,7 +665,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (power_as_bike && b.name().startsWith(powerSensorName) && !powerBike && filter) {
 
                 this->stopDiscovery();
-                powerBike = new stagesbike(noWriteResistance, noHeartService, false);
+                powerBike = create<stagesbike>(noWriteResistance, noHeartService, false);
                 emit deviceConnected(b);
                 connect(powerBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 // connect(cscBike, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -636,7 +680,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (power_as_treadmill && b.name().startsWith(powerSensorName) && !powerTreadmill && filter) {
 
                 this->stopDiscovery();
-                powerTreadmill = new strydrunpowersensor(noWriteResistance, noHeartService, false);
+                powerTreadmill = create<strydrunpowersensor>(noWriteResistance, noHeartService, false);
                 emit deviceConnected(b);
                 connect(powerTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -652,7 +696,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().toUpper().startsWith(QStringLiteral("DOMYOS-ROW")) &&
                        !b.name().startsWith(QStringLiteral("DomyosBridge")) && !domyosRower && filter) {
                 this->stopDiscovery();
-                domyosRower = new domyosrower(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
+                domyosRower = create<domyosrower>(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
                                               bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(domyosRower, &bluetoothdevice::connectedAndDiscovered, this,
@@ -669,7 +713,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().startsWith(QStringLiteral("Domyos-Bike")) &&
                        !b.name().startsWith(QStringLiteral("DomyosBridge")) && !domyosBike && filter) {
                 this->stopDiscovery();
-                domyosBike = new domyosbike(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
+                domyosBike = create<domyosbike>(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
                                             bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(domyosBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
@@ -685,7 +729,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().startsWith(QStringLiteral("Domyos-EL")) &&
                        !b.name().startsWith(QStringLiteral("DomyosBridge")) && !domyosElliptical && filter) {
                 this->stopDiscovery();
-                domyosElliptical = new domyoselliptical(noWriteResistance, noHeartService, testResistance,
+                domyosElliptical = create<domyoselliptical>(noWriteResistance, noHeartService, testResistance,
                                                         bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(domyosElliptical, &bluetoothdevice::connectedAndDiscovered, this,
@@ -703,7 +747,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !nautilusElliptical && // NAUTILUS E616
                        filter) {
                 this->stopDiscovery();
-                nautilusElliptical = new nautiluselliptical(noWriteResistance, noHeartService, testResistance,
+                nautilusElliptical = create<nautiluselliptical>(noWriteResistance, noHeartService, testResistance,
                                                             bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(nautilusElliptical, &bluetoothdevice::connectedAndDiscovered, this,
@@ -719,7 +763,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if ((b.name().toUpper().startsWith(QStringLiteral("NAUTILUS B"))) && !nautilusBike &&
                        filter) { // NAUTILUS B628
                 this->stopDiscovery();
-                nautilusBike = new nautilusbike(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
+                nautilusBike = create<nautilusbike>(noWriteResistance, noHeartService, testResistance, bikeResistanceOffset,
                                                 bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(nautilusBike, &bluetoothdevice::connectedAndDiscovered, this,
@@ -734,7 +778,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(nautilusBike);
             } else if ((b.name().toUpper().startsWith(QStringLiteral("I_FS"))) && !proformElliptical && filter) {
                 this->stopDiscovery();
-                proformElliptical = new proformelliptical(noWriteResistance, noHeartService);
+                proformElliptical = create<proformelliptical>(noWriteResistance, noHeartService);
                 emit deviceConnected(b);
                 connect(proformElliptical, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -748,7 +792,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(proformElliptical);
             } else if ((b.name().toUpper().startsWith(QStringLiteral("I_EL"))) && !nordictrackElliptical && filter) {
                 this->stopDiscovery();
-                nordictrackElliptical = new nordictrackelliptical(noWriteResistance, noHeartService,
+                nordictrackElliptical = create<nordictrackelliptical>(noWriteResistance, noHeartService,
                                                                   bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(nordictrackElliptical, &bluetoothdevice::connectedAndDiscovered, this,
@@ -764,7 +808,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
 
             } else if ((b.name().toUpper().startsWith(QStringLiteral("I_VE"))) && !proformEllipticalTrainer && filter) {
                 this->stopDiscovery();
-                proformEllipticalTrainer = new proformellipticaltrainer(noWriteResistance, noHeartService,
+                proformEllipticalTrainer = create<proformellipticaltrainer>(noWriteResistance, noHeartService,
                                                                         bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(proformEllipticalTrainer, &bluetoothdevice::connectedAndDiscovered, this,
@@ -780,7 +824,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(proformEllipticalTrainer);
             } else if ((b.name().toUpper().startsWith(QStringLiteral("I_RW"))) && !proformRower && filter) {
                 this->stopDiscovery();
-                proformRower = new proformrower(noWriteResistance, noHeartService);
+                proformRower = create<proformrower>(noWriteResistance, noHeartService);
                 emit deviceConnected(b);
                 connect(proformRower, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -794,7 +838,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(proformRower);
             } else if ((b.name().toUpper().startsWith(QStringLiteral("B01_"))) && !bhFitnessElliptical && filter) {
                 this->stopDiscovery();
-                bhFitnessElliptical = new bhfitnesselliptical(noWriteResistance, noHeartService, bikeResistanceOffset,
+                bhFitnessElliptical = create<bhfitnesselliptical>(noWriteResistance, noHeartService, bikeResistanceOffset,
                                                               bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(bhFitnessElliptical, &bluetoothdevice::connectedAndDiscovered, this,
@@ -817,7 +861,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         b.name().toUpper().startsWith(QStringLiteral("E98S"))) &&
                        !soleElliptical && filter) {
                 this->stopDiscovery();
-                soleElliptical = new soleelliptical(noWriteResistance, noHeartService, testResistance,
+                soleElliptical = create<soleelliptical>(noWriteResistance, noHeartService, testResistance,
                                                     bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(soleElliptical, &bluetoothdevice::connectedAndDiscovered, this,
@@ -835,7 +879,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !domyosBike && !domyosRower && filter) {
                 this->setLastBluetoothDevice(b);
                 this->stopDiscovery();
-                domyos = new domyostreadmill(this->pollDeviceTime, noConsole, noHeartService);
+                domyos = create<domyostreadmill>(this->pollDeviceTime, noConsole, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -866,7 +910,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !kingsmithR2Treadmill && filter) {
                 this->setLastBluetoothDevice(b);
                 this->stopDiscovery();
-                kingsmithR2Treadmill = new kingsmithr2treadmill(this->pollDeviceTime, noConsole, noHeartService);
+                kingsmithR2Treadmill = create<kingsmithr2treadmill>(this->pollDeviceTime, noConsole, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -893,7 +937,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !kingsmithR2Treadmill && filter) {
                 this->setLastBluetoothDevice(b);
                 this->stopDiscovery();
-                kingsmithR1ProTreadmill = new kingsmithr1protreadmill(this->pollDeviceTime, noConsole, noHeartService);
+                kingsmithR1ProTreadmill = create<kingsmithr1protreadmill>(this->pollDeviceTime, noConsole, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -916,7 +960,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if ((b.name().toUpper().startsWith(QStringLiteral("ZW-"))) && !shuaA5Treadmill && filter) {
                 this->setLastBluetoothDevice(b);
                 this->stopDiscovery();
-                shuaA5Treadmill = new shuaa5treadmill(noWriteResistance, noHeartService);
+                shuaA5Treadmill = create<shuaa5treadmill>(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -937,7 +981,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !trueTreadmill && filter) {
                 this->setLastBluetoothDevice(b);
                 this->stopDiscovery();
-                trueTreadmill = new truetreadmill(noWriteResistance, noHeartService);
+                trueTreadmill = create<truetreadmill>(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -960,7 +1004,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         b.name().toUpper().startsWith(QStringLiteral("F85"))) &&
                        !soleF80 && filter) {
                 this->stopDiscovery();
-                soleF80 = new solef80treadmill(noWriteResistance, noHeartService);
+                soleF80 = create<solef80treadmill>(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -995,7 +1039,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         b.name().toUpper().startsWith(QStringLiteral("ESANGLINKER"))) &&
                        !horizonTreadmill && filter) {
                 this->stopDiscovery();
-                horizonTreadmill = new horizontreadmill(noWriteResistance, noHeartService);
+                horizonTreadmill = create<horizontreadmill>(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -1031,7 +1075,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 if (!technogym_myrun_treadmill_experimental)
 #endif
                 {
-                    technogymmyrunTreadmill = new technogymmyruntreadmill(noWriteResistance, noHeartService);
+                    technogymmyrunTreadmill = create<technogymmyruntreadmill>(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                     stateFileRead();
 #endif
@@ -1056,7 +1100,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 }
 #ifndef Q_OS_IOS
                 else {
-                    technogymmyrunrfcommTreadmill = new technogymmyruntreadmillrfcomm();
+                    technogymmyrunrfcommTreadmill = create<technogymmyruntreadmillrfcomm>();
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                     stateFileRead();
 #endif
@@ -1084,7 +1128,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         (b.name().toUpper().startsWith("TACX SMART BIKE"))) &&
                        !tacxneo2Bike && filter) {
                 this->stopDiscovery();
-                tacxneo2Bike = new tacxneo2(noWriteResistance, noHeartService);
+                tacxneo2Bike = create<tacxneo2>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit(deviceConnected(b));
                 connect(tacxneo2Bike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
@@ -1102,7 +1146,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                          b.name().length() == 6)) &&
                        !npeCableBike && filter) {
                 this->stopDiscovery();
-                npeCableBike = new npecablebike(noWriteResistance, noHeartService);
+                npeCableBike = create<npecablebike>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(npeCableBike, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1127,7 +1171,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         (b.name().toUpper().startsWith("SMB1")) || (b.name().toUpper().startsWith("INRIDE"))) &&
                        !ftmsBike && !snodeBike && !fitPlusBike && !stagesBike && filter) {
                 this->stopDiscovery();
-                ftmsBike = new ftmsbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                ftmsBike = create<ftmsbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(ftmsBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -1140,7 +1184,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !wahooKickrSnapBike && filter) {
                 this->stopDiscovery();
                 wahooKickrSnapBike =
-                    new wahookickrsnapbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<wahookickrsnapbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(wahooKickrSnapBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1154,7 +1198,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !horizonGr7Bike && filter) {
                 this->stopDiscovery();
                 horizonGr7Bike =
-                    new horizongr7bike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<horizongr7bike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(horizonGr7Bike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1168,7 +1212,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                          powerSensorName.startsWith(QStringLiteral("Disabled")))) &&
                        !stagesBike && !ftmsBike && filter) {
                 this->stopDiscovery();
-                stagesBike = new stagesbike(noWriteResistance, noHeartService, false);
+                stagesBike = create<stagesbike>(noWriteResistance, noHeartService, false);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(stagesBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
@@ -1182,7 +1226,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().startsWith(QStringLiteral("SMARTROW")) && !smartrowRower && filter) {
                 this->stopDiscovery();
                 smartrowRower =
-                    new smartrowrower(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<smartrowrower>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(smartrowRower, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1198,7 +1242,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         b.name().toUpper().endsWith(QStringLiteral("SKI"))) &&
                        !concept2Skierg && filter) {
                 this->stopDiscovery();
-                concept2Skierg = new concept2skierg(noWriteResistance, noHeartService);
+                concept2Skierg = create<concept2skierg>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(concept2Skierg, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1218,7 +1262,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                          b.name().toUpper().contains(QStringLiteral("ROW")))) &&
                        !ftmsRower && filter) {
                 this->stopDiscovery();
-                ftmsRower = new ftmsrower(noWriteResistance, noHeartService);
+                ftmsRower = create<ftmsrower>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(ftmsRower, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
@@ -1233,7 +1277,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         b.name().toUpper().startsWith(QLatin1String("ECH-SD-SPT"))) &&
                        !echelonStride && filter) {
                 this->stopDiscovery();
-                echelonStride = new echelonstride(this->pollDeviceTime, noConsole, noHeartService);
+                echelonStride = create<echelonstride>(this->pollDeviceTime, noConsole, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(echelonStride, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1247,7 +1291,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(echelonStride);
             } else if ((b.name().toUpper().startsWith(QLatin1String("ZR7"))) && !octaneTreadmill && filter) {
                 this->stopDiscovery();
-                octaneTreadmill = new octanetreadmill(this->pollDeviceTime, noConsole, noHeartService);
+                octaneTreadmill = create<octanetreadmill>(this->pollDeviceTime, noConsole, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(octaneTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1264,7 +1308,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !echelonRower && filter) {
                 this->stopDiscovery();
                 echelonRower =
-                    new echelonrower(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<echelonrower>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(echelonRower, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1279,7 +1323,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().startsWith(QStringLiteral("ECH")) && !echelonRower && !echelonStride &&
                        !echelonConnectSport && filter) {
                 this->stopDiscovery();
-                echelonConnectSport = new echelonconnectsport(noWriteResistance, noHeartService, bikeResistanceOffset,
+                echelonConnectSport = create<echelonconnectsport>(noWriteResistance, noHeartService, bikeResistanceOffset,
                                                               bikeResistanceGain);
                 // stateFileRead();
                 emit deviceConnected(b);
@@ -1299,7 +1343,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !schwinnIC4Bike && filter) {
                 this->setLastBluetoothDevice(b);
                 this->stopDiscovery();
-                schwinnIC4Bike = new schwinnic4bike(noWriteResistance, noHeartService);
+                schwinnIC4Bike = create<schwinnic4bike>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(schwinnIC4Bike, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1314,7 +1358,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(schwinnIC4Bike);
             } else if (b.name().toUpper().startsWith(QStringLiteral("EW-BK")) && !sportsTechBike && filter) {
                 this->stopDiscovery();
-                sportsTechBike = new sportstechbike(noWriteResistance, noHeartService);
+                sportsTechBike = create<sportstechbike>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(sportsTechBike, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1329,7 +1373,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(sportsTechBike);
             } else if (b.name().toUpper().startsWith(QStringLiteral("CARDIOFIT")) && !sportsPlusBike && filter) {
                 this->stopDiscovery();
-                sportsPlusBike = new sportsplusbike(noWriteResistance, noHeartService);
+                sportsPlusBike = create<sportsplusbike>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(sportsPlusBike, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1344,7 +1388,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(sportsPlusBike);
             } else if (b.name().startsWith(yesoulbike::bluetoothName) && !yesoulBike && filter) {
                 this->stopDiscovery();
-                yesoulBike = new yesoulbike(noWriteResistance, noHeartService);
+                yesoulBike = create<yesoulbike>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(yesoulBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
@@ -1360,7 +1404,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !proformBike && filter) {
                 this->stopDiscovery();
                 proformBike =
-                    new proformbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<proformbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(proformBike, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1374,7 +1418,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(proformBike);
             } else if ((b.name().startsWith(QStringLiteral("I_TL"))) && !proformTreadmill && filter) {
                 this->stopDiscovery();
-                proformTreadmill = new proformtreadmill(noWriteResistance, noHeartService);
+                proformTreadmill = create<proformtreadmill>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(proformTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1389,7 +1433,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(proformTreadmill);
             } else if (b.name().toUpper().startsWith(QStringLiteral("ESLINKER")) && !eslinkerTreadmill && filter) {
                 this->stopDiscovery();
-                eslinkerTreadmill = new eslinkertreadmill(this->pollDeviceTime, noConsole, noHeartService);
+                eslinkerTreadmill = create<eslinkertreadmill>(this->pollDeviceTime, noConsole, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(eslinkerTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1405,7 +1449,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().toUpper().startsWith(QStringLiteral("PAFERS_")) && !pafersTreadmill &&
                        pafers_treadmill && filter) {
                 this->stopDiscovery();
-                pafersTreadmill = new paferstreadmill(this->pollDeviceTime, noConsole, noHeartService);
+                pafersTreadmill = create<paferstreadmill>(this->pollDeviceTime, noConsole, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(pafersTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1421,7 +1465,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().toUpper().startsWith(QStringLiteral("BOWFLEX T216")) && !bowflexT216Treadmill &&
                        filter) {
                 this->stopDiscovery();
-                bowflexT216Treadmill = new bowflext216treadmill(this->pollDeviceTime, noConsole, noHeartService);
+                bowflexT216Treadmill = create<bowflext216treadmill>(this->pollDeviceTime, noConsole, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(bowflexT216Treadmill, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1436,7 +1480,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(bowflexT216Treadmill);
             } else if (b.name().toUpper().startsWith(QStringLiteral("NAUTILUS T")) && !nautilusTreadmill && filter) {
                 this->stopDiscovery();
-                nautilusTreadmill = new nautilustreadmill(this->pollDeviceTime, noConsole, noHeartService);
+                nautilusTreadmill = create<nautilustreadmill>(this->pollDeviceTime, noConsole, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(nautilusTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1455,7 +1499,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                          b.name().length() == 6)) &&
                        !flywheelBike && filter) {
                 this->stopDiscovery();
-                flywheelBike = new flywheelbike(noWriteResistance, noHeartService);
+                flywheelBike = create<flywheelbike>(noWriteResistance, noHeartService);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(flywheelBike, &bluetoothdevice::connectedAndDiscovered, this,
@@ -1470,7 +1514,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(flywheelBike);
             } else if ((b.name().toUpper().startsWith(QStringLiteral("MCF-"))) && !mcfBike && filter) {
                 this->stopDiscovery();
-                mcfBike = new mcfbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                mcfBike = create<mcfbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 // stateFileRead();
                 emit deviceConnected(b);
                 connect(mcfBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
@@ -1484,7 +1528,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(mcfBike);
             } else if ((b.name().startsWith(QStringLiteral("TRX ROUTE KEY"))) && !toorx && filter) {
                 this->stopDiscovery();
-                toorx = new toorxtreadmill();
+                toorx = create<toorxtreadmill>();
                 emit deviceConnected(b);
                 connect(toorx, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 // connect(toorx, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -1494,7 +1538,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(toorx);
             } else if ((b.name().toUpper().startsWith(QStringLiteral("BH DUALKIT"))) && !iConceptBike && filter) {
                 this->stopDiscovery();
-                iConceptBike = new iconceptbike();
+                iConceptBike = create<iconceptbike>();
                 emit deviceConnected(b);
                 connect(iConceptBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1508,7 +1552,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         b.name().toUpper().startsWith(QStringLiteral("XT900"))) &&
                        !spiritTreadmill && filter) {
                 this->stopDiscovery();
-                spiritTreadmill = new spirittreadmill();
+                spiritTreadmill = create<spirittreadmill>();
                 emit deviceConnected(b);
                 connect(spiritTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1519,7 +1563,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(spiritTreadmill);
             } else if (b.name().toUpper().startsWith(QStringLiteral("RUNNERT")) && !activioTreadmill && filter) {
                 this->stopDiscovery();
-                activioTreadmill = new activiotreadmill();
+                activioTreadmill = create<activiotreadmill>();
                 emit deviceConnected(b);
                 connect(activioTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1537,7 +1581,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         (b.name().toUpper().startsWith(QStringLiteral("REEBOK")))) &&
                        !trxappgateusb && !trxappgateusbBike && !toorx_bike && filter) {
                 this->stopDiscovery();
-                trxappgateusb = new trxappgateusbtreadmill();
+                trxappgateusb = create<trxappgateusbtreadmill>();
                 emit deviceConnected(b);
                 connect(trxappgateusb, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1559,7 +1603,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !trxappgateusb && !trxappgateusbBike && filter) {
                 this->stopDiscovery();
                 trxappgateusbBike =
-                    new trxappgateusbbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<trxappgateusbbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(trxappgateusbBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1571,7 +1615,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if ((b.name().toUpper().startsWith(QStringLiteral("X-BIKE"))) && !ultraSportBike && filter) {
                 this->stopDiscovery();
                 ultraSportBike =
-                    new ultrasportbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<ultrasportbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(ultraSportBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1582,7 +1626,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(ultraSportBike);
             } else if ((b.name().toUpper().startsWith(QStringLiteral("KEEP_BIKE_"))) && !keepBike && filter) {
                 this->stopDiscovery();
-                keepBike = new keepbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                keepBike = create<keepbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(keepBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 // connect(keepBike, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -1594,7 +1638,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         b.name().toUpper().startsWith(QStringLiteral("R92"))) &&
                        !soleBike && filter) {
                 this->stopDiscovery();
-                soleBike = new solebike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                soleBike = create<solebike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(soleBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 // connect(soleBike, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -1605,7 +1649,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().toUpper().startsWith(QStringLiteral("BFCP")) && !skandikaWiriBike && filter) {
                 this->stopDiscovery();
                 skandikaWiriBike =
-                    new skandikawiribike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<skandikawiribike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(skandikaWiriBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1619,7 +1663,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         ((b.name().startsWith(QStringLiteral("TOORX"))) && toorx_ftms)) &&
                        !renphoBike && !snodeBike && !fitPlusBike && filter) {
                 this->stopDiscovery();
-                renphoBike = new renphobike(noWriteResistance, noHeartService);
+                renphoBike = create<renphobike>(noWriteResistance, noHeartService);
                 emit(deviceConnected(b));
                 connect(renphoBike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
                 // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -1630,7 +1674,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if ((b.name().toUpper().startsWith("PAFERS_")) && !pafersBike && !pafers_treadmill && filter) {
                 this->stopDiscovery();
                 pafersBike =
-                    new pafersbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<pafersbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit(deviceConnected(b));
                 connect(pafersBike, SIGNAL(connectedAndDiscovered()), this, SLOT(connectedAndDiscovered()));
                 // connect(pafersBike, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -1643,7 +1687,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !snodeBike &&
                        !ftmsBike && !fitPlusBike && filter) {
                 this->stopDiscovery();
-                snodeBike = new snodebike(noWriteResistance, noHeartService);
+                snodeBike = create<snodebike>(noWriteResistance, noHeartService);
                 emit deviceConnected(b);
                 connect(snodeBike, &bluetoothdevice::connectedAndDiscovered, this, &bluetooth::connectedAndDiscovered);
                 // connect(trxappgateusb, SIGNAL(disconnected()), this, SLOT(restart()));
@@ -1656,7 +1700,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                        !fitPlusBike && !ftmsBike && !snodeBike && filter) {
                 this->stopDiscovery();
                 fitPlusBike =
-                    new fitplusbike(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
+                    create<fitplusbike>(noWriteResistance, noHeartService, bikeResistanceOffset, bikeResistanceGain);
                 emit deviceConnected(b);
                 connect(fitPlusBike, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1671,7 +1715,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                         (b.name().startsWith(QStringLiteral("BF70")))) &&
                        !fitshowTreadmill && filter) {
                 this->stopDiscovery();
-                fitshowTreadmill = new fitshowtreadmill(this->pollDeviceTime, noConsole, noHeartService);
+                fitshowTreadmill = create<fitshowtreadmill>(this->pollDeviceTime, noConsole, noHeartService);
                 emit deviceConnected(b);
                 connect(fitshowTreadmill, &bluetoothdevice::connectedAndDiscovered, this,
                         &bluetooth::connectedAndDiscovered);
@@ -1685,7 +1729,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             } else if (b.name().toUpper().startsWith(QStringLiteral("IC")) && b.name().length() == 8 && !inspireBike &&
                        filter) {
                 this->stopDiscovery();
-                inspireBike = new inspirebike(noWriteResistance, noHeartService);
+                inspireBike = create<inspirebike>(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -1707,7 +1751,7 @@ void bluetooth::deviceDiscovered(const QBluetoothDeviceInfo &device) {
                 innerTemplateManager->start(inspireBike);
             } else if (b.name().toUpper().startsWith(QStringLiteral("CHRONO ")) && !chronoBike && filter) {
                 this->stopDiscovery();
-                chronoBike = new chronobike(noWriteResistance, noHeartService);
+                chronoBike = create<chronobike>(noWriteResistance, noHeartService);
 #if !defined(Q_OS_ANDROID) && !defined(Q_OS_IOS)
                 stateFileRead();
 #endif
@@ -1792,7 +1836,7 @@ void bluetooth::connectedAndDiscovered() {
             qDebug() << "last hrm name" << b;
             if (!b.compare(heartRateBeltName) && b.length()) {
 
-                heartRateBelt = new heartratebelt();
+                heartRateBelt = create<heartratebelt>();
                 // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
                 connect(heartRateBelt, SIGNAL(debug(QString)), this, SLOT(debug(QString)));
@@ -1816,7 +1860,7 @@ void bluetooth::connectedAndDiscovered() {
 #else
                 settings.setValue(QZSettings::hrm_lastdevice_address, b.deviceUuid().toString());
 #endif
-                heartRateBelt = new heartratebelt();
+                heartRateBelt = create<heartratebelt>();
                 // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
                 connect(heartRateBelt, &heartratebelt::debug, this, &bluetooth::debug);
@@ -1837,7 +1881,7 @@ void bluetooth::connectedAndDiscovered() {
 #else
                 settings.setValue(QZSettings::ftms_accessory_address, b.deviceUuid().toString());
 #endif
-                ftmsAccessory = new smartspin2k(false, false, this->device()->maxResistance(), (bike *)this->device());
+                ftmsAccessory = create<smartspin2k>(false, false, this->device()->maxResistance(), (bike *)this->device());
                 // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
                 connect(ftmsAccessory, &smartspin2k::debug, this, &bluetooth::debug);
@@ -1857,7 +1901,7 @@ void bluetooth::connectedAndDiscovered() {
         if (fitmetriaFanfitEnabled) {
             for (const QBluetoothDeviceInfo &b : qAsConst(devices)) {
                 if (((b.name().startsWith("FITFAN-"))) && !fitmetria_fanfit_isconnected(b.name())) {
-                    fitmetria_fanfit *f = new fitmetria_fanfit(this->device());
+                    fitmetria_fanfit *f = create<fitmetria_fanfit>(this->device());
 
                     connect(f, &fitmetria_fanfit::debug, this, &bluetooth::debug);
 
@@ -1881,7 +1925,7 @@ void bluetooth::connectedAndDiscovered() {
 #else
                     settings.setValue(QZSettings::csc_sensor_address, b.deviceUuid().toString());
 #endif
-                    cadenceSensor = new cscbike(false, false, true);
+                    cadenceSensor = create<cscbike>(false, false, true);
                     // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
                     connect(cadenceSensor, &cscbike::debug, this, &bluetooth::debug);
@@ -1906,14 +1950,14 @@ void bluetooth::connectedAndDiscovered() {
                 settings.setValue(QZSettings::power_sensor_address, b.deviceUuid().toString());
 #endif
                 if (device() && device()->deviceType() == bluetoothdevice::BIKE) {
-                    powerSensor = new stagesbike(false, false, true);
+                    powerSensor = create<stagesbike>(false, false, true);
                     // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
                     connect(powerSensor, &stagesbike::debug, this, &bluetooth::debug);
                     connect(powerSensor, &bluetoothdevice::powerChanged, this->device(), &bluetoothdevice::powerSensor);
                     powerSensor->deviceDiscovered(b);
                 } else if (device() && device()->deviceType() == bluetoothdevice::TREADMILL) {
-                    powerSensorRun = new strydrunpowersensor(false, false, true);
+                    powerSensorRun = create<strydrunpowersensor>(false, false, true);
                     // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
                     connect(powerSensorRun, &strydrunpowersensor::debug, this, &bluetooth::debug);
@@ -1946,7 +1990,7 @@ void bluetooth::connectedAndDiscovered() {
 #else
             settings.setValue(QZSettings::elite_rizer_address, b.deviceUuid().toString());
 #endif
-            eliteRizer = new eliterizer(false, false);
+            eliteRizer = create<eliterizer>(false, false);
             // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
             connect(eliteRizer, &eliterizer::debug, this, &bluetooth::debug);
@@ -1969,7 +2013,7 @@ void bluetooth::connectedAndDiscovered() {
 #else
             settings.setValue(QZSettings::elite_sterzo_smart_address, b.deviceUuid().toString());
 #endif
-            eliteSterzoSmart = new elitesterzosmart(false, false);
+            eliteSterzoSmart = create<elitesterzosmart>(false, false);
             // connect(heartRateBelt, SIGNAL(disconnected()), this, SLOT(restart()));
 
             connect(eliteSterzoSmart, &elitesterzosmart::debug, this, &bluetooth::debug);
@@ -2028,6 +2072,8 @@ void bluetooth::restart() {
     }
 
     devices.clear();
+    deviceIndex.clear();
+    driverCandidates.clear();
     userTemplateManager->stop();
     innerTemplateManager->stop();
 
@@ -2042,429 +2088,12 @@ void bluetooth::restart() {
         }
     }
 
-    if (domyos) {
-
-        delete domyos;
-        domyos = nullptr;
-    }
-    if (m3iBike) {
-
-        delete m3iBike;
-        m3iBike = nullptr;
-    }
-    if (fitshowTreadmill) {
-
-        delete fitshowTreadmill;
-        fitshowTreadmill = nullptr;
-    }
-    if (horizonTreadmill) {
-
-        delete horizonTreadmill;
-        horizonTreadmill = nullptr;
-    }
-    if (technogymmyrunTreadmill) {
-
-        delete technogymmyrunTreadmill;
-        technogymmyrunTreadmill = nullptr;
-    }
-#ifndef Q_OS_IOS
-    if (technogymmyrunrfcommTreadmill) {
-
-        delete technogymmyrunrfcommTreadmill;
-        technogymmyrunrfcommTreadmill = nullptr;
-    }
-#endif
-    if (soleF80) {
-
-        delete soleF80;
-        soleF80 = nullptr;
-    }
-    if (kingsmithR2Treadmill) {
-
-        delete kingsmithR2Treadmill;
-        kingsmithR2Treadmill = nullptr;
-    }
-    if (kingsmithR1ProTreadmill) {
-
-        delete kingsmithR1ProTreadmill;
-        kingsmithR1ProTreadmill = nullptr;
-    }
-    if (shuaA5Treadmill) {
-
-        delete shuaA5Treadmill;
-        shuaA5Treadmill = nullptr;
-    }
-    if (trueTreadmill) {
-
-        delete trueTreadmill;
-        trueTreadmill = nullptr;
-    }
-    if (domyosBike) {
-
-        delete domyosBike;
-        domyosBike = nullptr;
-    }
-    if (domyosRower) {
-
-        delete domyosRower;
-        domyosRower = nullptr;
-    }
-    if (domyosElliptical) {
-
-        delete domyosElliptical;
-        domyosElliptical = nullptr;
-    }
-    if (soleElliptical) {
-
-        delete soleElliptical;
-        soleElliptical = nullptr;
-    }
-    if (nautilusElliptical) {
-
-        delete nautilusElliptical;
-        nautilusElliptical = nullptr;
-    }
-    if (nautilusBike) {
-
-        delete nautilusBike;
-        nautilusBike = nullptr;
-    }
-    if (bhFitnessElliptical) {
-
-        delete bhFitnessElliptical;
-        bhFitnessElliptical = nullptr;
-    }
-    if (cscBike) {
-
-        delete cscBike;
-        cscBike = nullptr;
-    }
-    if (proformWifiBike) {
-
-        delete proformWifiBike;
-        proformWifiBike = nullptr;
-    }
-    if (proformWifiTreadmill) {
-
-        delete proformWifiTreadmill;
-        proformWifiTreadmill = nullptr;
-    }
-    if (nordictrackifitadbTreadmill) {
-
-        delete nordictrackifitadbTreadmill;
-        nordictrackifitadbTreadmill = nullptr;
-    }
-    if (nordictrackifitadbBike) {
-
-        delete nordictrackifitadbBike;
-        nordictrackifitadbBike = nullptr;
-    }
-    if (powerBike) {
-
-        delete powerBike;
-        powerBike = nullptr;
-    }
-    if (powerTreadmill) {
-
-        delete powerTreadmill;
-        powerTreadmill = nullptr;
-    }
-    if (fakeBike) {
-
-        delete fakeBike;
-        fakeBike = nullptr;
-    }
-    if (fakeElliptical) {
-
-        delete fakeElliptical;
-        fakeElliptical = nullptr;
-    }
-    if (fakeTreadmill) {
-
-        delete fakeTreadmill;
-        fakeTreadmill = nullptr;
-    }
-    if (npeCableBike) {
-
-        delete npeCableBike;
-        npeCableBike = nullptr;
-    }
-    if (tacxneo2Bike) {
-
-        delete tacxneo2Bike;
-        tacxneo2Bike = nullptr;
-    }
-    if (stagesBike) {
-
-        delete stagesBike;
-
-        stagesBike = nullptr;
-    }
-    if (toorx) {
-
-        delete toorx;
-        toorx = nullptr;
-    }
-    if (iConceptBike) {
-
-        delete iConceptBike;
-        iConceptBike = nullptr;
-    }
-    if (trxappgateusb) {
-
-        delete trxappgateusb;
-        trxappgateusb = nullptr;
-    }
-    if (spiritTreadmill) {
-
-        delete spiritTreadmill;
-        spiritTreadmill = nullptr;
-    }
-    if (activioTreadmill) {
-
-        delete activioTreadmill;
-        activioTreadmill = nullptr;
-    }
-    if (trxappgateusbBike) {
-
-        delete trxappgateusbBike;
-        trxappgateusbBike = nullptr;
-    }
-    if (soleBike) {
-
-        delete soleBike;
-        soleBike = nullptr;
-    }
-    if (keepBike) {
-
-        delete keepBike;
-        keepBike = nullptr;
-    }
-    if (ultraSportBike) {
-
-        delete ultraSportBike;
-        ultraSportBike = nullptr;
-    }
-    if (echelonConnectSport) {
-
-        delete echelonConnectSport;
-        echelonConnectSport = nullptr;
-    }
-    if (echelonRower) {
-
-        delete echelonRower;
-        echelonRower = nullptr;
-    }
-    if (echelonStride) {
-
-        delete echelonStride;
-        echelonStride = nullptr;
-    }
-    if (octaneTreadmill) {
-
-        delete octaneTreadmill;
-        octaneTreadmill = nullptr;
-    }
-    if (ftmsRower) {
-
-        delete ftmsRower;
-        ftmsRower = nullptr;
-    }
-    if (concept2Skierg) {
-
-        delete concept2Skierg;
-        concept2Skierg = nullptr;
-    }
-    if (smartrowRower) {
-
-        delete smartrowRower;
-        smartrowRower = nullptr;
-    }
-    if (yesoulBike) {
-
-        delete yesoulBike;
-        yesoulBike = nullptr;
-    }
-    if (proformBike) {
-
-        delete proformBike;
-        proformBike = nullptr;
-    }
-    if (proformTreadmill) {
-
-        delete proformTreadmill;
-        proformTreadmill = nullptr;
-    }
-    if (proformElliptical) {
-
-        delete proformElliptical;
-        proformElliptical = nullptr;
-    }
-    if (nordictrackElliptical) {
-
-        delete nordictrackElliptical;
-        nordictrackElliptical = nullptr;
-    }
-    if (proformEllipticalTrainer) {
-
-        delete proformEllipticalTrainer;
-        proformEllipticalTrainer = nullptr;
-    }
-    if (proformRower) {
-
-        delete proformRower;
-        proformRower = nullptr;
-    }
-    if (eslinkerTreadmill) {
-
-        delete eslinkerTreadmill;
-        eslinkerTreadmill = nullptr;
-    }
-    if (bowflexTreadmill) {
-
-        delete bowflexTreadmill;
-        bowflexTreadmill = nullptr;
-    }
-    if (bowflexT216Treadmill) {
-
-        delete bowflexT216Treadmill;
-        bowflexT216Treadmill = nullptr;
-    }
-    if (pafersTreadmill) {
-
-        delete pafersTreadmill;
-        pafersTreadmill = nullptr;
-    }
-    if (nautilusTreadmill) {
-
-        delete nautilusTreadmill;
-        nautilusTreadmill = nullptr;
-    }
-    if (flywheelBike) {
-
-        delete flywheelBike;
-        flywheelBike = nullptr;
-    }
-    if (mcfBike) {
-
-        delete mcfBike;
-        mcfBike = nullptr;
-    }
-    if (schwinnIC4Bike) {
-
-        delete schwinnIC4Bike;
-        schwinnIC4Bike = nullptr;
-    }
-    if (sportsTechBike) {
-
-        delete sportsTechBike;
-        sportsTechBike = nullptr;
-    }
-    if (sportsPlusBike) {
-
-        delete sportsPlusBike;
-        sportsPlusBike = nullptr;
-    }
-    if (inspireBike) {
-
-        delete inspireBike;
-        inspireBike = nullptr;
-    }
-    if (chronoBike) {
-
-        delete chronoBike;
-        chronoBike = nullptr;
-    }
-    if (snodeBike) {
-
-        delete snodeBike;
-        snodeBike = nullptr;
-    }
-    if (ftmsBike) {
-
-        delete ftmsBike;
-        ftmsBike = nullptr;
-    }
-    if (wahooKickrSnapBike) {
-
-        delete wahooKickrSnapBike;
-        wahooKickrSnapBike = nullptr;
-    }
-    if (horizonGr7Bike) {
-
-        delete horizonGr7Bike;
-        horizonGr7Bike = nullptr;
-    }
-    if (renphoBike) {
-
-        delete renphoBike;
-        renphoBike = nullptr;
-    }
-    if (pafersBike) {
-
-        delete pafersBike;
-        pafersBike = nullptr;
-    }
-    if (fitPlusBike) {
-
-        delete fitPlusBike;
-        fitPlusBike = nullptr;
-    }
-    if (skandikaWiriBike) {
-
-        delete skandikaWiriBike;
-        skandikaWiriBike = nullptr;
-    }
-    if (heartRateBelt) {
-
-        // heartRateBelt->disconnectBluetooth(); // to test
-        delete heartRateBelt;
-        heartRateBelt = nullptr;
-    }
-    if (ftmsAccessory) {
-
-        // heartRateBelt->disconnectBluetooth(); // to test
-        delete ftmsAccessory;
-        ftmsAccessory = nullptr;
-    }
-    if (fitmetriaFanfit.length()) {
-
-        foreach (fitmetria_fanfit *f, fitmetriaFanfit) {
-            delete f;
-            f = nullptr;
-        }
-        fitmetriaFanfit.clear();
-    }
-    if (cadenceSensor) {
-
-        // heartRateBelt->disconnectBluetooth(); // to test
-        delete cadenceSensor;
-        cadenceSensor = nullptr;
-    }
-    if (powerSensor) {
-
-        // heartRateBelt->disconnectBluetooth(); // to test
-        delete powerSensor;
-        powerSensor = nullptr;
-    }
-    if (powerSensorRun) {
-
-        // heartRateBelt->disconnectBluetooth(); // to test
-        delete powerSensorRun;
-        powerSensorRun = nullptr;
-    }
-    if (eliteRizer) {
-
-        // heartRateBelt->disconnectBluetooth(); // to test
-        delete eliteRizer;
-        eliteRizer = nullptr;
-    }
-    if (eliteSterzoSmart) {
-
-        // heartRateBelt->disconnectBluetooth(); // to test
-        delete eliteSterzoSmart;
-        eliteSterzoSmart = nullptr;
+    // the device, then its accessories, in creation order: the QPointer members reset themselves
+    for (const QPointer<bluetoothdevice> &d : qAsConst(drivers)) {
+        delete d.data();
     }
+    drivers.clear();
+    fitmetriaFanfit.clear();
     this->startDiscovery();
 }
 
@@ -3,7 +3,9 @@
 
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QFile>
+#include <QMap>
 #include <QObject>
+#include <QPointer>
 #include <QtBluetooth/qlowenergyadvertisingdata.h>
 #include <QtBluetooth/qlowenergyadvertisingparameters.h>
 #include <QtBluetooth/qlowenergycharacteristic.h>
@@ -27,6 +29,7 @@
 #include "chronobike.h"
 #include "concept2skierg.h"
 #include "cscbike.h"
+#include "devicenamematcher.h"
 #include "domyosbike.h"
 #include "domyoselliptical.h"
 #include "domyosrower.h"
@@ -130,90 +133,91 @@ class bluetooth : public QObject, public SignalHandler {
     TemplateInfoSenderBuilder *innerTemplateManager = nullptr;
     QFile *debugCommsLog = nullptr;
     QBluetoothDeviceDiscoveryAgent *discoveryAgent;
-    bhfitnesselliptical *bhFitnessElliptical = nullptr;
-    bowflextreadmill *bowflexTreadmill = nullptr;
-    bowflext216treadmill *bowflexT216Treadmill = nullptr;
-    fitshowtreadmill *fitshowTreadmill = nullptr;
-    concept2skierg *concept2Skierg = nullptr;
-    domyostreadmill *domyos = nullptr;
-    domyosbike *domyosBike = nullptr;
-    domyosrower *domyosRower = nullptr;
-    domyoselliptical *domyosElliptical = nullptr;
-    toorxtreadmill *toorx = nullptr;
-    iconceptbike *iConceptBike = nullptr;
-    trxappgateusbtreadmill *trxappgateusb = nullptr;
-    spirittreadmill *spiritTreadmill = nullptr;
-    activiotreadmill *activioTreadmill = nullptr;
-    nautilusbike *nautilusBike = nullptr;
-    nautiluselliptical *nautilusElliptical = nullptr;
-    nautilustreadmill *nautilusTreadmill = nullptr;
-    trxappgateusbbike *trxappgateusbBike = nullptr;
-    echelonconnectsport *echelonConnectSport = nullptr;
-    yesoulbike *yesoulBike = nullptr;
-    flywheelbike *flywheelBike = nullptr;
-    nordictrackelliptical *nordictrackElliptical = nullptr;
-    nordictrackifitadbtreadmill *nordictrackifitadbTreadmill = nullptr;
-    nordictrackifitadbbike *nordictrackifitadbBike = nullptr;
-    octanetreadmill *octaneTreadmill = nullptr;
-    proformrower *proformRower = nullptr;
-    proformbike *proformBike = nullptr;
-    proformwifibike *proformWifiBike = nullptr;
-    proformwifitreadmill *proformWifiTreadmill = nullptr;
-    proformelliptical *proformElliptical = nullptr;
-    proformellipticaltrainer *proformEllipticalTrainer = nullptr;
-    proformtreadmill *proformTreadmill = nullptr;
-    horizontreadmill *horizonTreadmill = nullptr;
-    technogymmyruntreadmill *technogymmyrunTreadmill = nullptr;
+    QPointer<bhfitnesselliptical> bhFitnessElliptical;
+    QPointer<bowflextreadmill> bowflexTreadmill;
+    QPointer<bowflext216treadmill> bowflexT216Treadmill;
+    QPointer<fitshowtreadmill> fitshowTreadmill;
+    QPointer<concept2skierg> concept2Skierg;
+    QPointer<domyostreadmill> domyos;
+    QPointer<domyosbike> domyosBike;
+    QPointer<domyosrower> domyosRower;
+    QPointer<domyoselliptical> domyosElliptical;
+    QPointer<toorxtreadmill> toorx;
+    QPointer<iconceptbike> iConceptBike;
+    QPointer<trxappgateusbtreadmill> trxappgateusb;
+    QPointer<spirittreadmill> spiritTreadmill;
+    QPointer<activiotreadmill> activioTreadmill;
+    QPointer<nautilusbike> nautilusBike;
+    QPointer<nautiluselliptical> nautilusElliptical;
+    QPointer<nautilustreadmill> nautilusTreadmill;
+    QPointer<trxappgateusbbike> trxappgateusbBike;
+    QPointer<echelonconnectsport> echelonConnectSport;
+    QPointer<yesoulbike> yesoulBike;
+    QPointer<flywheelbike> flywheelBike;
+    QPointer<nordictrackelliptical> nordictrackElliptical;
+    QPointer<nordictrackifitadbtreadmill> nordictrackifitadbTreadmill;
+    QPointer<nordictrackifitadbbike> nordictrackifitadbBike;
+    QPointer<octanetreadmill> octaneTreadmill;
+    QPointer<proformrower> proformRower;
+    QPointer<proformbike> proformBike;
+    QPointer<proformwifibike> proformWifiBike;
+    QPointer<proformwifitreadmill> proformWifiTreadmill;
+    QPointer<proformelliptical> proformElliptical;
+    QPointer<proformellipticaltrainer> proformEllipticalTrainer;
+    QPointer<proformtreadmill> proformTreadmill;
+    QPointer<horizontreadmill> horizonTreadmill;
+    QPointer<technogymmyruntreadmill> technogymmyrunTreadmill;
 #ifndef Q_OS_IOS
-    technogymmyruntreadmillrfcomm *technogymmyrunrfcommTreadmill = nullptr;
+    QPointer<technogymmyruntreadmillrfcomm> technogymmyrunrfcommTreadmill;
 #endif
-    truetreadmill *trueTreadmill = nullptr;
-    horizongr7bike *horizonGr7Bike = nullptr;
-    schwinnic4bike *schwinnIC4Bike = nullptr;
-    sportstechbike *sportsTechBike = nullptr;
-    sportsplusbike *sportsPlusBike = nullptr;
-    inspirebike *inspireBike = nullptr;
-    snodebike *snodeBike = nullptr;
-    eslinkertreadmill *eslinkerTreadmill = nullptr;
-    m3ibike *m3iBike = nullptr;
-    skandikawiribike *skandikaWiriBike = nullptr;
-    cscbike *cscBike = nullptr;
-    mcfbike *mcfBike = nullptr;
-    npecablebike *npeCableBike = nullptr;
-    stagesbike *stagesBike = nullptr;
-    solebike *soleBike = nullptr;
-    soleelliptical *soleElliptical = nullptr;
-    solef80treadmill *soleF80 = nullptr;
-    chronobike *chronoBike = nullptr;
-    fitplusbike *fitPlusBike = nullptr;
-    echelonrower *echelonRower = nullptr;
-    ftmsrower *ftmsRower = nullptr;
-    smartrowrower *smartrowRower = nullptr;
-    echelonstride *echelonStride = nullptr;
-    keepbike *keepBike = nullptr;
-    kingsmithr1protreadmill *kingsmithR1ProTreadmill = nullptr;
-    kingsmithr2treadmill *kingsmithR2Treadmill = nullptr;
-    ftmsbike *ftmsBike = nullptr;
-    pafersbike *pafersBike = nullptr;
-    paferstreadmill *pafersTreadmill = nullptr;
-    tacxneo2 *tacxneo2Bike = nullptr;
-    renphobike *renphoBike = nullptr;
-    shuaa5treadmill *shuaA5Treadmill = nullptr;
-    heartratebelt *heartRateBelt = nullptr;
-    smartspin2k *ftmsAccessory = nullptr;
-    cscbike *cadenceSensor = nullptr;
-    stagesbike *powerSensor = nullptr;
-    strydrunpowersensor *powerSensorRun = nullptr;
-    stagesbike *powerBike = nullptr;
-    ultrasportbike *ultraSportBike = nullptr;
-    wahookickrsnapbike *wahooKickrSnapBike = nullptr;
-    strydrunpowersensor *powerTreadmill = nullptr;
-    eliterizer *eliteRizer = nullptr;
-    elitesterzosmart *eliteSterzoSmart = nullptr;
-    fakebike *fakeBike = nullptr;
-    fakeelliptical *fakeElliptical = nullptr;
-    faketreadmill *fakeTreadmill = nullptr;
+    QPointer<truetreadmill> trueTreadmill;
+    QPointer<horizongr7bike> horizonGr7Bike;
+    QPointer<schwinnic4bike> schwinnIC4Bike;
+    QPointer<sportstechbike> sportsTechBike;
+    QPointer<sportsplusbike> sportsPlusBike;
+    QPointer<inspirebike> inspireBike;
+    QPointer<snodebike> snodeBike;
+    QPointer<eslinkertreadmill> eslinkerTreadmill;
+    QPointer<m3ibike> m3iBike;
+    QPointer<skandikawiribike> skandikaWiriBike;
+    QPointer<cscbike> cscBike;
+    QPointer<mcfbike> mcfBike;
+    QPointer<npecablebike> npeCableBike;
+    QPointer<stagesbike> stagesBike;
+    QPointer<solebike> soleBike;
+    QPointer<soleelliptical> soleElliptical;
+    QPointer<solef80treadmill> soleF80;
+    QPointer<chronobike> chronoBike;
+    QPointer<fitplusbike> fitPlusBike;
+    QPointer<echelonrower> echelonRower;
+    QPointer<ftmsrower> ftmsRower;
+    QPointer<smartrowrower> smartrowRower;
+    QPointer<echelonstride> echelonStride;
+    QPointer<keepbike> keepBike;
+    QPointer<kingsmithr1protreadmill> kingsmithR1ProTreadmill;
+    QPointer<kingsmithr2treadmill> kingsmithR2Treadmill;
+    QPointer<ftmsbike> ftmsBike;
+    QPointer<pafersbike> pafersBike;
+    QPointer<paferstreadmill> pafersTreadmill;
+    QPointer<tacxneo2> tacxneo2Bike;
+    QPointer<renphobike> renphoBike;
+    QPointer<shuaa5treadmill> shuaA5Treadmill;
+    QPointer<heartratebelt> heartRateBelt;
+    QPointer<smartspin2k> ftmsAccessory;
+    QPointer<cscbike> cadenceSensor;
+    QPointer<stagesbike> powerSensor;
+    QPointer<strydrunpowersensor> powerSensorRun;
+    QPointer<stagesbike> powerBike;
+    QPointer<ultrasportbike> ultraSportBike;
+    QPointer<wahookickrsnapbike> wahooKickrSnapBike;
+    QPointer<strydrunpowersensor> powerTreadmill;
+    QPointer<eliterizer> eliteRizer;
+    QPointer<elitesterzosmart> eliteSterzoSmart;
+    QPointer<fakebike> fakeBike;
+    QPointer<fakeelliptical> fakeElliptical;
+    QPointer<faketreadmill> fakeTreadmill;
     QList<fitmetria_fanfit *> fitmetriaFanfit;
+    QList<QPointer<bluetoothdevice>> drivers; // every driver created by create(), in creation order
     QString filterDevice = QLatin1String("");
 
     bool testResistance = false;
@@ -226,6 +230,12 @@ class bluetooth : public QObject, public SignalHandler {
     double bikeResistanceGain = 1.0;
     bool forceHeartBeltOffForTimeout = false;
 
+    QHash<QString, int> deviceIndex; // position in devices, by address (device uuid on iOS)
+    devicenamematcher driverNames;
+    // the devices whose name matches a rule of driverNames: position in devices -> rule id, in discovery order
+    QMap<int, int> driverCandidates;
+    bool driverNamesCompiled = false;
+
     /**
      * @brief Start the Bluetooth discovery agent.
      */
@@ -236,6 +246,26 @@ class bluetooth : public QObject, public SignalHandler {
      */
     void stopDiscovery();
 
+    /**
+     * @brief Creates a device driver and registers it, so that restart() can destroy it whatever its type.
+     */
+    template <class T, class... Args> T *create(Args &&...args) {
+        T *driver = new T(std::forward<Args>(args)...);
+        drivers.append(driver);
+        return driver;
+    }
+
+    /**
+     * @brief Adds the device to the devices list, or refreshes the entry with the same address.
+     */
+    void storeDevice(const QBluetoothDeviceInfo &device);
+
+    /**
+     * @brief Matches the name of the device at this position in devices against driverNames, once per
+     * advertisement, and keeps driverCandidates up to date.
+     */
+    void indexDriverCandidate(int position);
+
     bool handleSignal(int signal) override;
     void stateFileUpdate();
     void stateFileRead();
@@ -1,10 +1,15 @@
 #include "bluetoothdevice.h"
+#include "qzsettingscache.h"
 
 #include <QFile>
 #include <QSettings>
 #include <QTime>
 
-bluetoothdevice::bluetoothdevice() {}
+bluetoothdevice::bluetoothdevice() {
+    m_watt.addWindow(3);
+    m_watt.addWindow(10);
+    m_watt.enableNormalizedPower(); // registers the 30s window too
+}
 
 bluetoothdevice::BLUETOOTH_TYPE bluetoothdevice::deviceType() { return bluetoothdevice::UNKNOWN; }
 void bluetoothdevice::start() { requestStart = 1; }
@@ -13,9 +18,9 @@ void bluetoothdevice::stop(bool pause) {
     if (pause)
         requestPause = 1;
 }
-metric bluetoothdevice::currentHeart() { return Heart; }
-metric bluetoothdevice::currentSpeed() { return Speed; }
-metric bluetoothdevice::currentInclination() { return Inclination; }
+const metric &bluetoothdevice::currentHeart() { return Heart; }
+const metric &bluetoothdevice::currentSpeed() { return Speed; }
+const metric &bluetoothdevice::currentInclination() { return Inclination; }
 QTime bluetoothdevice::movingTime() {
     int hours = (int)(moving.value() / 3600.0);
     return QTime(hours, (int)(moving.value() - ((double)hours * 3600.0)) / 60.0, ((uint32_t)moving.value()) % 60, 0);
@@ -30,8 +35,8 @@ QTime bluetoothdevice::lapElapsedTime() {
                  ((uint32_t)elapsed.lapValue()) % 60, 0);
 }
 
-metric bluetoothdevice::currentResistance() { return Resistance; }
-metric bluetoothdevice::currentCadence() { return Cadence; }
+const metric &bluetoothdevice::currentResistance() { return Resistance; }
+const metric &bluetoothdevice::currentCadence() { return Cadence; }
 double bluetoothdevice::currentCrankRevolutions() { return 0; }
 uint16_t bluetoothdevice::lastCrankEventTime() { return 0; }
 void bluetoothdevice::changeResistance(resistance_t resistance) {}
@@ -91,8 +96,8 @@ QTime bluetoothdevice::maxPace() {
 }
 
 double bluetoothdevice::odometer() { return Distance.value(); }
-metric bluetoothdevice::calories() { return KCal; }
-metric bluetoothdevice::jouls() { return m_jouls; }
+const metric &bluetoothdevice::calories() { return KCal; }
+const metric &bluetoothdevice::jouls() { return m_jouls; }
 uint8_t bluetoothdevice::fanSpeed() { return FanSpeed; };
 void *bluetoothdevice::VirtualDevice() { return nullptr; }
 bool bluetoothdevice::changeFanSpeed(uint8_t speed) {
@@ -114,14 +119,23 @@ bool bluetoothdevice::changeFanSpeed(uint8_t speed) {
     return false;
 }
 bool bluetoothdevice::connected() { return false; }
-metric bluetoothdevice::elevationGain() { return elevationAcc; }
+const metric &bluetoothdevice::elevationGain() { return elevationAcc; }
 void bluetoothdevice::heartRate(uint8_t heart) { Heart.setValue(heart); }
 void bluetoothdevice::disconnectBluetooth() {
+    if (m_writeQueue) {
+        m_writeQueue->clear();
+    }
     if (m_control) {
         m_control->disconnectFromDevice();
     }
 }
-metric bluetoothdevice::wattsMetric() { return m_watt; }
+
+blewritequeue *bluetoothdevice::writeQueue() {
+    if (!m_writeQueue)
+        m_writeQueue = new blewritequeue(this);
+    return m_writeQueue;
+}
+const metric &bluetoothdevice::wattsMetric() { return m_watt; }
 void bluetoothdevice::setDifficult(double d) { m_difficult = d; }
 double bluetoothdevice::difficult() { return m_difficult; }
 void bluetoothdevice::cadenceSensor(uint8_t cadence) { Q_UNUSED(cadence) }
@@ -138,7 +152,7 @@ void bluetoothdevice::update_metrics(bool watt_calc, const double watts) {
 
     QDateTime current = QDateTime::currentDateTime();
     double deltaTime = (((double)_lastTimeUpdate.msecsTo(current)) / ((double)1000.0));
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     bool power_as_bike = settings.value(QZSettings::power_sensor_as_bike, QZSettings::default_power_sensor_as_bike).toBool();
     bool power_as_treadmill = settings.value(QZSettings::power_sensor_as_treadmill, QZSettings::default_power_sensor_as_treadmill).toBool();
 
@@ -184,6 +198,9 @@ void bluetoothdevice::update_metrics(bool watt_calc, const double watts) {
 
     _lastTimeUpdate = current;
     _firstUpdate = false;
+
+    qzCDebug(qzDeviceMetrics) << QStringLiteral("update_metrics") << currentSpeed().value() << m_watt.value()
+                              << elapsed.value() << moving.value() << elevationAcc.value();
 }
 
 void bluetoothdevice::clearStats() {
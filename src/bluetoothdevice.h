@@ -1,8 +1,10 @@
 #ifndef BLUETOOTHDEVICE_H
 #define BLUETOOTHDEVICE_H
 
+#include "blewritequeue.h"
 #include "definitions.h"
 #include "metric.h"
+#include "qzdebug.h"
 #include "qzsettings.h"
 
 #include <QBluetoothDeviceDiscoveryAgent>
@@ -53,12 +55,12 @@ class bluetoothdevice : public QObject {
     /**
      * @brief currentHeart Gets a metric object for getting and setting the current heart rate. Units: beats per minute
      */
-    virtual metric currentHeart();
+    virtual const metric &currentHeart();
 
     /**
      * @brief currentSpeed Gets a metric object for getting and setting the speed. Units: km/h
      */
-    virtual metric currentSpeed();
+    virtual const metric &currentSpeed();
 
     /**
      * @brief currentPace Gets the current pace. Units: time per km
@@ -70,7 +72,7 @@ class bluetoothdevice : public QObject {
      * Units: Percentage vertical to horizontal
      * Expected range: Depends on device.
      */
-    virtual metric currentInclination();
+    virtual const metric &currentInclination();
 
     /**
      * @brief setInclination Set the protected Inclination metric, which could be different from that
@@ -101,12 +103,12 @@ class bluetoothdevice : public QObject {
      * Other implementations could have different units.
      * @return
      */
-    virtual metric calories();
+    virtual const metric &calories();
 
     /**
      * @brief jouls Gets a metric object to get and set the number of joules expended. Units: joules
      */
-    metric jouls();
+    const metric &jouls();
 
     /**
      * @brief fanSpeed Gets the current fan speed. Units: depends on device
@@ -144,12 +146,12 @@ class bluetoothdevice : public QObject {
      * @brief currentResistance Gets a metric object to get or set the currently requested resistance.
      * Expected range: 0 to maxResistance()
      */
-    virtual metric currentResistance();
+    virtual const metric &currentResistance();
 
     /**
      * @brief currentCadence Gets a metric object to get and set the current cadence. Units: revolutions per minute
      */
-    virtual metric currentCadence();
+    virtual const metric &currentCadence();
 
     /**
      * @brief currentCrankRevolutions Gets the current total number of crank revolutions.
@@ -203,7 +205,7 @@ class bluetoothdevice : public QObject {
     /**
      * @brief wattsMetric Gets a metric object to get or set the amount of power used.  Units: watts
      */
-    metric wattsMetric();
+    const metric &wattsMetric();
 
     /**
      * @brief changeFanSpeed Tries to change the fan speed.
@@ -214,7 +216,7 @@ class bluetoothdevice : public QObject {
     /**
      * @brief elevationGain Gets a metric object to get and set the elevation gain. Units: ?
      */
-    virtual metric elevationGain();
+    virtual const metric &elevationGain();
 
     /**
      * @brief clearStats Clear the statistics.
@@ -280,26 +282,26 @@ class bluetoothdevice : public QObject {
      * @brief wattKg Gets a metric object to get and set the watt kg of something. Units: watt kg
      * @return
      */
-    metric wattKg() { return WattKg; }
+    const metric &wattKg() { return WattKg; }
 
     /**
      * @brief currentMETS Gets a metric object to get and set the current METS (Metabolic Equivalent of Tasks)
      * Units: METs (1 MET is approximately 3.5mL of Oxygen consumed per kg of body weight per minute)
      */
-    metric currentMETS() { return METS; }
+    const metric &currentMETS() { return METS; }
 
     /**
      * @brief currentHeartZone Gets a metric object to get or set the current heart zone. Units: depends on
      * implementation.
      */
-    metric currentHeartZone() { return HeartZone; }
+    const metric &currentHeartZone() { return HeartZone; }
 
     /**
      * @brief currentPowerZone Gets a metric object to get or set the current power zome. Units: depends on
      * implementation.
      * @return
      */
-    metric currentPowerZone() { return PowerZone; }
+    const metric &currentPowerZone() { return PowerZone; }
 
     /**
      * @brief setGPXFile Sets the file for GPS data exchange.
@@ -384,6 +386,12 @@ class bluetoothdevice : public QObject {
   protected:
     QLowEnergyController *m_control = nullptr;
 
+    /**
+     * @brief writeQueue The non-blocking characteristic write queue of the device, created on first use and
+     * cleared by disconnectBluetooth().
+     */
+    blewritequeue *writeQueue();
+
     /**
      * @brief elapsed A metric object to get and set the elapsed time for the session. Units: seconds
      */
@@ -568,6 +576,9 @@ class bluetoothdevice : public QObject {
      * Units: METs (1 MET is approximately 3.5mL of Oxygen consumed per kg of body weight per minute)
      */
     double calculateMETS();
+
+  private:
+    blewritequeue *m_writeQueue = nullptr;
 };
 
 #endif // BLUETOOTHDEVICE_H
@@ -1,10 +1,16 @@
 #ifndef CHARACTERISTICNOTIFIER_H
 #define CHARACTERISTICNOTIFIER_H
 
+#include "characteristicsnapshot.h"
 #include <QObject>
 
 #define CN_INVALID -1
 #define CN_OK 0
+// returned by encode() when the frame doesn't come from the metrics: notify(QByteArray &) builds it
+#define CN_NOT_ENCODED -2
+
+// the largest notification payload with the default ATT MTU of 23 bytes
+#define CN_MAX_FRAME 20
 
 class CharacteristicNotifier : public QObject {
     Q_OBJECT
@@ -13,7 +19,49 @@ class CharacteristicNotifier : public QObject {
   public:
     explicit CharacteristicNotifier(quint16 uuid, QObject *parent = nullptr) : QObject(parent), my_uuid(uuid) {}
     virtual int notify(QByteArray &out) = 0;
+
+    /**
+     * @brief notify Appends the frame encoded from the snapshot to out. Encoding several characteristics from the
+     * same snapshot keeps them consistent within one notification tick.
+     */
+    int notify(const CharacteristicSnapshot &snapshot, QByteArray &out) {
+        uint8_t frame[CN_MAX_FRAME];
+        int length = encode(snapshot, frame);
+        if (length == CN_NOT_ENCODED)
+            return notify(out);
+        if (length < 0)
+            return CN_INVALID;
+        out.append((const char *)frame, length);
+        return CN_OK;
+    }
+
     quint16 uuid() const { return my_uuid; }
+
+  protected:
+    /**
+     * @brief encode Writes the frame for the snapshot in out (CN_MAX_FRAME bytes) and returns its length,
+     * or CN_INVALID if the characteristic has nothing to send for this kind of device. Notifiers whose frames
+     * don't come from the metrics keep the default.
+     */
+    virtual int encode(const CharacteristicSnapshot &snapshot, uint8_t *out) {
+        Q_UNUSED(snapshot);
+        Q_UNUSED(out);
+        return CN_NOT_ENCODED;
+    }
+
+    static uint8_t *put8(uint8_t *p, uint8_t v) {
+        *p = v;
+        return p + 1;
+    }
+    static uint8_t *put16(uint8_t *p, uint16_t v) {
+        p[0] = v & 0xFF;
+        p[1] = (v >> 8) & 0xFF;
+        return p + 2;
+    }
+    static uint8_t *put32(uint8_t *p, uint32_t v) {
+        p = put16(p, v & 0xFFFF);
+        return put16(p, v >> 16);
+    }
   signals:
 };
 
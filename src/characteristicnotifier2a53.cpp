@@ -1,23 +1,19 @@
 #include "characteristicnotifier2a53.h"
-#include "treadmill.h"
 
 CharacteristicNotifier2A53::CharacteristicNotifier2A53(bluetoothdevice *Bike, QObject *parent)
     : CharacteristicNotifier(0x2a53, parent), Bike(Bike) {}
 
-int CharacteristicNotifier2A53::notify(QByteArray &value) {
-    bluetoothdevice::BLUETOOTH_TYPE dt = Bike->deviceType();
-    if (dt == bluetoothdevice::TREADMILL || dt == bluetoothdevice::ELLIPTICAL) {
-        value.append(0x02); // total distance
-        uint16_t speed = Bike->currentSpeed().value() / 3.6 * 256;
-        uint32_t distance = Bike->odometer() * 10000.0;
-        value.append((char)((speed & 0xFF)));
-        value.append((char)((speed >> 8) & 0xFF));
-        value.append((char)(Bike->currentCadence().value()));
-        value.append((char)((distance & 0xFF)));
-        value.append((char)((distance >> 8) & 0xFF));
-        value.append((char)((distance >> 16) & 0xFF));
-        value.append((char)((distance >> 24) & 0xFF));
-        return CN_OK;
-    } else
+int CharacteristicNotifier2A53::notify(QByteArray &value) { return notify(CharacteristicSnapshot(Bike), value); }
+
+int CharacteristicNotifier2A53::encode(const CharacteristicSnapshot &s, uint8_t *out) {
+    bluetoothdevice::BLUETOOTH_TYPE dt = s.deviceType;
+    if (dt != bluetoothdevice::TREADMILL && dt != bluetoothdevice::ELLIPTICAL)
         return CN_INVALID;
+
+    uint8_t *p = out;
+    p = put8(p, 0x02); // total distance
+    p = put16(p, (uint16_t)(s.speed / 3.6 * 256));   // speed
+    p = put8(p, (uint8_t)s.cadence);                // cadence
+    p = put32(p, (uint32_t)(s.odometer * 10000.0)); // distance
+    return p - out;
 }
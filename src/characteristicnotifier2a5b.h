@@ -12,7 +12,11 @@ class CharacteristicNotifier2A5B : public CharacteristicNotifier {
 
   public:
     explicit CharacteristicNotifier2A5B(bluetoothdevice *Bike, QObject *parent = nullptr);
+    using CharacteristicNotifier::notify;
     virtual int notify(QByteArray &out);
+
+  protected:
+    virtual int encode(const CharacteristicSnapshot &snapshot, uint8_t *out);
 };
 
 #endif // CHARACTERISTICNOTIFIER2A5B_H
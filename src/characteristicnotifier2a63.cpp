@@ -3,21 +3,16 @@
 CharacteristicNotifier2A63::CharacteristicNotifier2A63(bluetoothdevice *Bike, QObject *parent)
     : CharacteristicNotifier(0x2a63, parent), Bike(Bike) {}
 
-int CharacteristicNotifier2A63::notify(QByteArray &value) {
-    double normalizeWattage = Bike->wattsMetric().value();
-    if (normalizeWattage < 0)
-        normalizeWattage = 0;
-    
-    if (Bike->deviceType() == bluetoothdevice::BIKE) {
-      value.append((char)0x20); // crank data present
-      value.append((char)0x00);
-      value.append((char)(((uint16_t)normalizeWattage) & 0xFF));                     // watt
-      value.append((char)(((uint16_t)normalizeWattage) >> 8) & 0xFF);                // watt
-      value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) & 0xFF));      // revs count
-      value.append((char)(((uint16_t)Bike->currentCrankRevolutions()) >> 8) & 0xFF); // revs count
-      value.append((char)(Bike->lastCrankEventTime() & 0xff));                       // eventtime
-      value.append((char)(Bike->lastCrankEventTime() >> 8) & 0xFF);                  // eventtime
-      return CN_OK;
-    } else
+int CharacteristicNotifier2A63::notify(QByteArray &value) { return notify(CharacteristicSnapshot(Bike), value); }
+
+int CharacteristicNotifier2A63::encode(const CharacteristicSnapshot &s, uint8_t *out) {
+    if (s.deviceType != bluetoothdevice::BIKE)
         return CN_INVALID;
+
+    uint8_t *p = out;
+    p = put16(p, 0x0020);                       // crank data present
+    p = put16(p, (uint16_t)s.watt);             // watt
+    p = put16(p, (uint16_t)s.crankRevolutions); // revs count
+    p = put16(p, s.lastCrankEventTime);         // eventtime
+    return p - out;
 }
@@ -9,6 +9,7 @@ class CharacteristicNotifier2ACC : public CharacteristicNotifier {
 
   public:
     explicit CharacteristicNotifier2ACC(bluetoothdevice *Bike, QObject *parent = nullptr);
+    using CharacteristicNotifier::notify;
     virtual int notify(QByteArray &out);
 };
 
@@ -1,48 +1,27 @@
 #include "characteristicnotifier2acd.h"
-#include "treadmill.h"
 #include <qmath.h>
 
 CharacteristicNotifier2ACD::CharacteristicNotifier2ACD(bluetoothdevice *Bike, QObject *parent)
     : CharacteristicNotifier(0x2acd, parent), Bike(Bike) {}
 
-int CharacteristicNotifier2ACD::notify(QByteArray &value) {
-    bluetoothdevice::BLUETOOTH_TYPE dt = Bike->deviceType();
-    if (dt == bluetoothdevice::TREADMILL || dt == bluetoothdevice::ELLIPTICAL) {
-        value.append(0x08);       // Inclination avaiable
-        value.append((char)0x01); // heart rate avaiable
+int CharacteristicNotifier2ACD::notify(QByteArray &value) { return notify(CharacteristicSnapshot(Bike), value); }
 
-        uint16_t normalizeSpeed = (uint16_t)qRound(Bike->currentSpeed().value() * 100);
-        char a = (normalizeSpeed >> 8) & 0XFF;
-        char b = normalizeSpeed & 0XFF;
-        QByteArray speedBytes;
-        speedBytes.append(b);
-        speedBytes.append(a);
-        uint16_t normalizeIncline = 0;
-        if (dt == bluetoothdevice::TREADMILL)
-            normalizeIncline = (uint32_t)qRound(((treadmill *)Bike)->currentInclination().value() * 10);
-        a = (normalizeIncline >> 8) & 0XFF;
-        b = normalizeIncline & 0XFF;
-        QByteArray inclineBytes;
-        inclineBytes.append(b);
-        inclineBytes.append(a);
-        double ramp = 0;
-        if (dt == bluetoothdevice::TREADMILL)
-            ramp = qRadiansToDegrees(qAtan(((treadmill *)Bike)->currentInclination().value() / 100));
-        int16_t normalizeRamp = (int32_t)qRound(ramp * 10);
-        a = (normalizeRamp >> 8) & 0XFF;
-        b = normalizeRamp & 0XFF;
-        QByteArray rampBytes;
-        rampBytes.append(b);
-        rampBytes.append(a);
-
-        value.append(speedBytes); // Actual value.
-
-        value.append(inclineBytes); // incline
+int CharacteristicNotifier2ACD::encode(const CharacteristicSnapshot &s, uint8_t *out) {
+    bluetoothdevice::BLUETOOTH_TYPE dt = s.deviceType;
+    if (dt != bluetoothdevice::TREADMILL && dt != bluetoothdevice::ELLIPTICAL)
+        return CN_INVALID;
 
-        value.append(rampBytes); // ramp angle
+    // the snapshot inclination is 0 for the ellipticals
+    int16_t normalizeIncline = (int16_t)qRound(s.inclination * 10);
+    double ramp = qRadiansToDegrees(qAtan(s.inclination / 100));
+    int16_t normalizeRamp = (int16_t)qRound(ramp * 10);
 
-        value.append(Bike->currentHeart().value()); // current heart rate
-        return CN_OK;
-    } else
-        return CN_INVALID;
+    uint8_t *p = out;
+    p = put8(p, 0x08);                             // Inclination avaiable
+    p = put8(p, 0x01);                             // heart rate avaiable
+    p = put16(p, (uint16_t)qRound(s.speed * 100)); // Actual value.
+    p = put16(p, (uint16_t)normalizeIncline);      // incline
+    p = put16(p, (uint16_t)normalizeRamp);         // ramp angle
+    p = put8(p, s.heart);                          // current heart rate
+    return p - out;
 }
@@ -8,7 +8,11 @@ class CharacteristicNotifier2ACD : public CharacteristicNotifier {
 
   public:
     explicit CharacteristicNotifier2ACD(bluetoothdevice *Bike, QObject *parent = nullptr);
+    using CharacteristicNotifier::notify;
     virtual int notify(QByteArray &out);
+
+  protected:
+    virtual int encode(const CharacteristicSnapshot &snapshot, uint8_t *out);
 };
 
 #endif // CHARACTERISTICNOTIFIER2ACD_H
@@ -0,0 +1,22 @@
+#include "characteristicnotifier2ad1.h"
+
+CharacteristicNotifier2AD1::CharacteristicNotifier2AD1(bluetoothdevice *Rower, QObject *parent)
+    : CharacteristicNotifier(0x2ad1, parent), Rower(Rower) {}
+
+int CharacteristicNotifier2AD1::notify(QByteArray &value) { return notify(CharacteristicSnapshot(Rower), value); }
+
+int CharacteristicNotifier2AD1::encode(const CharacteristicSnapshot &s, uint8_t *out) {
+    if (s.deviceType != bluetoothdevice::ROWING)
+        return CN_INVALID;
+
+    uint8_t *p = out;
+    p = put8(p, 0xA0);                      // resistance level, power and speed
+    p = put8(p, 0x02);                      // heart rate
+    p = put8(p, (uint8_t)s.cadence);        // Stroke Rate
+    p = put16(p, (uint16_t)s.strokesCount); // Stroke Count
+    p = put16(p, (uint16_t)s.watt);         // watts
+    p = put16(p, (uint16_t)s.resistance);   // resistance
+    p = put8(p, s.heart);                   // Actual value.
+    p = put8(p, 0);                         // Bkool FTMS protocol HRM offset 1280 fix
+    return p - out;
+}
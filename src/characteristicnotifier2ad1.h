@@ -0,0 +1,19 @@
+#ifndef CHARACTERISTICNOTIFIER2AD1_H
+#define CHARACTERISTICNOTIFIER2AD1_H
+
+#include "bluetoothdevice.h"
+#include "characteristicnotifier.h"
+
+class CharacteristicNotifier2AD1 : public CharacteristicNotifier {
+    bluetoothdevice *Rower;
+
+  public:
+    explicit CharacteristicNotifier2AD1(bluetoothdevice *Rower, QObject *parent = nullptr);
+    using CharacteristicNotifier::notify;
+    virtual int notify(QByteArray &out);
+
+  protected:
+    virtual int encode(const CharacteristicSnapshot &snapshot, uint8_t *out);
+};
+
+#endif // CHARACTERISTICNOTIFIER2AD1_H
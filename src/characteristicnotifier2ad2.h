@@ -9,7 +9,11 @@ class CharacteristicNotifier2AD2 : public CharacteristicNotifier {
 
   public:
     explicit CharacteristicNotifier2AD2(bluetoothdevice *Bike, QObject *parent = nullptr);
+    using CharacteristicNotifier::notify;
     virtual int notify(QByteArray &out);
+
+  protected:
+    virtual int encode(const CharacteristicSnapshot &snapshot, uint8_t *out);
 };
 
 #endif // CHARACTERISTICNOTIFIER2AD2_H
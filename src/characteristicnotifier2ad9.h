@@ -9,6 +9,7 @@ class CharacteristicNotifier2AD9 : public CharacteristicNotifier {
 
   public:    
     explicit CharacteristicNotifier2AD9(bluetoothdevice *Bike, QObject *parent = nullptr);
+    using CharacteristicNotifier::notify;
     virtual int notify(QByteArray &out);
     QByteArray answer;
 };
@@ -0,0 +1,33 @@
+#include "characteristicsnapshot.h"
+#include "qzsettings.h"
+#include "qzsettingscache.h"
+#include "rower.h"
+#include "treadmill.h"
+
+CharacteristicSnapshot::CharacteristicSnapshot(bluetoothdevice *device) {
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
+
+    deviceType = device->deviceType();
+    speed = device->currentSpeed().value();
+    cadence = device->currentCadence().value();
+    resistance = device->currentResistance().value();
+    watt = qMax(0.0, device->wattsMetric().value());
+    inclination = deviceType == bluetoothdevice::TREADMILL ? device->currentInclination().value() : 0;
+    odometer = device->odometer();
+    strokesCount = deviceType == bluetoothdevice::ROWING ? ((rower *)device)->currentStrokesCount().value() : 0;
+    crankRevolutions = device->currentCrankRevolutions();
+    lastCrankEventTime = device->lastCrankEventTime();
+    heart = (uint8_t)device->currentHeart().value();
+    heartOverride = device->metrics_override_heartrate();
+    runningCadenceDouble = settings.toBool(QZSettings::powr_sensor_running_cadence_double,
+                                           QZSettings::default_powr_sensor_running_cadence_double);
+}
+
+bool CharacteristicSnapshot::operator==(const CharacteristicSnapshot &other) const {
+    return deviceType == other.deviceType && speed == other.speed && cadence == other.cadence &&
+           resistance == other.resistance && watt == other.watt && inclination == other.inclination &&
+           odometer == other.odometer && strokesCount == other.strokesCount &&
+           crankRevolutions == other.crankRevolutions && lastCrankEventTime == other.lastCrankEventTime &&
+           heart == other.heart && heartOverride == other.heartOverride &&
+           runningCadenceDouble == other.runningCadenceDouble;
+}
@@ -0,0 +1,33 @@
+#ifndef CHARACTERISTICSNAPSHOT_H
+#define CHARACTERISTICSNAPSHOT_H
+
+#include "bluetoothdevice.h"
+
+/**
+ * @brief The CharacteristicSnapshot class is a copy of the device metrics the virtual device notifications are
+ * built from, taken once per notification tick. Every characteristic encoded from the same snapshot reports the
+ * same values, even if the device updates its metrics in between.
+ */
+class CharacteristicSnapshot {
+  public:
+    explicit CharacteristicSnapshot(bluetoothdevice *device);
+
+    bool operator==(const CharacteristicSnapshot &other) const;
+    bool operator!=(const CharacteristicSnapshot &other) const { return !(*this == other); }
+
+    bluetoothdevice::BLUETOOTH_TYPE deviceType;
+    double speed;       // km/h
+    double cadence;     // rpm, steps/min or strokes/min
+    double resistance;  // device level
+    double watt;        // W, never negative
+    double inclination; // %, treadmills only
+    double odometer;    // km
+    double strokesCount;
+    double crankRevolutions;
+    uint16_t lastCrankEventTime; // 1/1024 s
+    uint8_t heart;               // as read from the device
+    uint8_t heartOverride;       // as it has to be advertised, see bluetoothdevice::metrics_override_heartrate()
+    bool runningCadenceDouble;   // powr_sensor_running_cadence_double
+};
+
+#endif // CHARACTERISTICSNAPSHOT_H
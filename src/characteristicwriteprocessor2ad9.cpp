@@ -1,6 +1,7 @@
 #include "characteristicwriteprocessor2ad9.h"
 #include "elliptical.h"
 #include "ftmsbike.h"
+#include "latencytrace.h"
 #include "treadmill.h"
 #include <QSettings>
 #include <QtMath>
@@ -14,6 +15,7 @@ CharacteristicWriteProcessor2AD9::CharacteristicWriteProcessor2AD9(double bikeRe
 
 int CharacteristicWriteProcessor2AD9::writeProcess(quint16 uuid, const QByteArray &data, QByteArray &reply) {
     if (data.size()) {
+        latencytrace::mark(latencytrace::CONTROL_RECEIVED);
         bluetoothdevice::BLUETOOTH_TYPE dt = Bike->deviceType();
         if (dt == bluetoothdevice::BIKE) {
             QSettings settings;
@@ -28,6 +30,7 @@ int CharacteristicWriteProcessor2AD9::writeProcess(quint16 uuid, const QByteArra
                 uresistance = uresistance / 10;
                 if (force_resistance && !erg_mode) {
                     Bike->changeResistance(uresistance);
+                    latencytrace::mark(latencytrace::CONTROL_APPLIED);
                 }
                 qDebug() << QStringLiteral("new requested resistance ") + QString::number(uresistance) +
                                 QStringLiteral(" enabled ") + force_resistance;
@@ -84,6 +87,7 @@ int CharacteristicWriteProcessor2AD9::writeProcess(quint16 uuid, const QByteArra
                 double requestSpeed = (double)uspeed / 100.0;
                 if (dt == bluetoothdevice::TREADMILL) {
                     ((treadmill *)Bike)->changeSpeed(requestSpeed);
+                    latencytrace::mark(latencytrace::CONTROL_APPLIED);
                 }
                 qDebug() << QStringLiteral("new requested speed ") + QString::number(requestSpeed);
             } else if ((char)data.at(0) == 0x03) // Set Target Inclination
@@ -101,6 +105,7 @@ int CharacteristicWriteProcessor2AD9::writeProcess(quint16 uuid, const QByteArra
                 // Resistance as incline on Sole E95s Elliptical #419
                 else if (dt == bluetoothdevice::ELLIPTICAL)
                     ((elliptical *)Bike)->changeInclination(requestIncline, requestIncline);
+                latencytrace::mark(latencytrace::CONTROL_APPLIED);
                 qDebug() << "new requested incline " + QString::number(requestIncline);
             } else if ((char)data.at(0) == 0x07) // Start request
             {
@@ -128,7 +133,10 @@ int CharacteristicWriteProcessor2AD9::writeProcess(quint16 uuid, const QByteArra
         return CP_INVALID;
 }
 
-void CharacteristicWriteProcessor2AD9::changePower(uint16_t power) { Bike->changePower(power); }
+void CharacteristicWriteProcessor2AD9::changePower(uint16_t power) {
+    Bike->changePower(power);
+    latencytrace::mark(latencytrace::CONTROL_APPLIED);
+}
 
 void CharacteristicWriteProcessor2AD9::changeSlope(int16_t iresistance) {
     bluetoothdevice::BLUETOOTH_TYPE dt = Bike->deviceType();
@@ -175,5 +183,7 @@ void CharacteristicWriteProcessor2AD9::changeSlope(int16_t iresistance) {
       emit changeInclination(((iresistance / 100.0) * gain) + offset,
                              ((qTan(qDegreesToRadians(iresistance / 100.0)) * 100.0) * gain) + offset);
     }
+    // changeInclination reaches the device through a direct connection
+    latencytrace::mark(latencytrace::CONTROL_APPLIED);
     emit slopeChanged();
 }
@@ -1,4 +1,5 @@
 #include "chronobike.h"
+#include "qzsettingscache.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualbike.h"
@@ -127,7 +128,7 @@ void chronobike::serviceDiscovered(const QBluetoothUuid &gatt) {
 void chronobike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
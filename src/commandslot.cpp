@@ -0,0 +1,40 @@
+#include "commandslot.h"
+#include "qzdebug.h"
+
+#include <QtMath>
+
+void commandslot::post(double target) {
+    m_posted++;
+    if (m_pending)
+        m_coalesced++;
+    m_target = target;
+    m_pending = true;
+}
+
+bool commandslot::take(double current, double *value) {
+    if (!m_pending)
+        return false;
+    if (lastWrite.isValid() && lastWrite.elapsed() < m_minInterval)
+        return false;
+
+    const double delta = m_target - current;
+    if (qFabs(delta) < m_deadband) {
+        m_pending = false;
+        m_dropped++;
+        qzCDebug(qzDevice) << m_name << "target" << m_target << "within the deadband of" << current;
+        return false;
+    }
+
+    if (m_slewRate > 0 && qFabs(delta) > m_slewRate) {
+        // one step now, the target stays pending for the next writes
+        *value = current + (delta > 0 ? m_slewRate : -m_slewRate);
+    } else {
+        *value = m_target;
+        m_pending = false;
+    }
+    m_written++;
+    lastWrite.start();
+    qzCDebug(qzDevice) << m_name << "writing" << *value << "target" << m_target << "posted" << m_posted << "coalesced"
+                      << m_coalesced << "dropped" << m_dropped << "written" << m_written;
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef COMMANDSLOT_H
+#define COMMANDSLOT_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+/**
+ * @brief The commandslot class holds the pending target of one control (speed, inclination, resistance, power)
+ * between the request fields the trainprogram and the virtual devices write and the physical write of a driver.
+ * A new target replaces the pending one (latest wins), so a burst of requests costs a single write, and take()
+ * hands out at most one target per minimum interval:
+ * - a target within the deadband of the current value is dropped,
+ * - a target further than the slew rate from the current value is approached one step per write.
+ * The counters tell how many requests a given interval saved; they are logged on every write.
+ */
+class commandslot {
+  public:
+    explicit commandslot(const char *name, int minInterval = 0, double deadband = 0, double slewRate = 0)
+        : m_name(name), m_minInterval(minInterval), m_deadband(deadband), m_slewRate(slewRate) {}
+
+    void setMinInterval(int msec) { m_minInterval = msec; }
+    void setDeadband(double deadband) { m_deadband = deadband; }
+    void setSlewRate(double maxStep) { m_slewRate = maxStep; }
+
+    /**
+     * @brief post Stores target as the pending one, replacing the previous target if it was not written yet.
+     */
+    void post(double target);
+
+    /**
+     * @brief take Returns true and the value to write when a target is pending, the minimum interval since the
+     * previous write elapsed and the target is out of the deadband of current.
+     */
+    bool take(double current, double *value);
+
+    bool pending() const { return m_pending; }
+    double target() const { return m_target; }
+    void clear() { m_pending = false; }
+
+    quint32 posted() const { return m_posted; }
+    quint32 coalesced() const { return m_coalesced; }
+    quint32 dropped() const { return m_dropped; }
+    quint32 written() const { return m_written; }
+
+  private:
+    const char *m_name;
+    int m_minInterval;
+    double m_deadband;
+    double m_slewRate;
+
+    double m_target = 0;
+    bool m_pending = false;
+    QElapsedTimer lastWrite;
+
+    quint32 m_posted = 0;
+    quint32 m_coalesced = 0;
+    quint32 m_dropped = 0;
+    quint32 m_written = 0;
+};
+
+#endif // COMMANDSLOT_H
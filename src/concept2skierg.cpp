@@ -1,4 +1,5 @@
 #include "concept2skierg.h"
+#include "qzsettingscache.h"
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
 #include "virtualtreadmill.h"
@@ -129,7 +130,7 @@ void concept2skierg::characteristicChanged(const QLowEnergyCharacteristic &chara
 
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
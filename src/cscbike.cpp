@@ -1,4 +1,5 @@
 #include "cscbike.h"
+#include "qzsettingscache.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -156,7 +157,7 @@ void cscbike::serviceDiscovered(const QBluetoothUuid &gatt) {
 void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     // QString heartRateBeltName = //unused QString
     // settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
@@ -166,7 +167,7 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
     double _WheelRevs = 0;
     uint8_t battery = 0;
 
-    emit debug(QStringLiteral(" << ") + newValue.toHex(' '));
+    qzEmitDebug(qzDeviceRaw, QStringLiteral(" << ") + newValue.toHex(' '));
 
     if (characteristic.uuid() == QBluetoothUuid((quint16)0x2A19)) {
         battery = newValue.at(0);
@@ -191,21 +192,21 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
         _WheelRevs =
             (((uint32_t)((uint8_t)newValue.at(index + 3)) << 24) | ((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
              ((uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)));
-        emit debug(QStringLiteral("Current Wheel Revs: ") + QString::number(_WheelRevs));
+        qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Wheel Revs: ") + QString::number(_WheelRevs));
         index += 4;
 
         _LastWheelEventTime =
             (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
-        emit debug(QStringLiteral("Current Wheel Event Time: ") + QString::number(_LastWheelEventTime));
+        qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Wheel Event Time: ") + QString::number(_LastWheelEventTime));
         index += 2;
     }
     if (CrankPresent) {
         _CrankRevs = (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
-        emit debug(QStringLiteral("Current Crank Revs: ") + QString::number(_CrankRevs));
+        qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Crank Revs: ") + QString::number(_CrankRevs));
         index += 2;
         _LastCrankEventTime =
             (((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)));
-        emit debug(QStringLiteral("Current Crank Event Time: ") + QString::number(_LastCrankEventTime));
+        qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Crank Event Time: ") + QString::number(_LastCrankEventTime));
     }
 
     if ((!CrankPresent || _CrankRevs == 0) && WheelPresent) {
@@ -230,7 +231,7 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
         Cadence = 0;
     }
     emit cadenceChanged(Cadence.value());
-    emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
 
     oldLastCrankEventTime = LastCrankEventTime;
     oldCrankRevs = CrankRevs;
@@ -240,11 +241,11 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
     } else {
         Speed = metric::calculateSpeedFromPower(watts(), Inclination.value(), Speed.value(),fabs(QDateTime::currentDateTime().msecsTo(Speed.lastChanged()) / 1000.0),  this->speedLimit());
     }
-    emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
 
     Distance += ((Speed.value() / 3600000.0) *
                  ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-    emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
     double ac = 0.01243107769;
     double bc = 1.145964912;
@@ -277,7 +278,7 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
              (60000.0 / ((double)lastRefreshCharacteristicChanged.msecsTo(
                             QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight in kg
                                                               //* 3.5) / 200 ) / 60
-    emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
     if (Cadence.value() > 0) {
         CrankRevs++;
@@ -299,8 +300,8 @@ void cscbike::characteristicChanged(const QLowEnergyCharacteristic &characterist
 #endif
     }
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
     if (m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
@@ -0,0 +1,61 @@
+#include "devicenamematcher.h"
+
+void devicenamematcher::clear() {
+    nodes.clear();
+    nodes.push_back({0, NO_MATCH, -1, -1});
+    substrings.clear();
+    substringIds.clear();
+    rules = 0;
+    m_matchAll = false;
+}
+
+int devicenamematcher::addPrefix(const QString &prefix) {
+    int n = 0;
+    for (const QChar ch : prefix) {
+        const ushort c = ch.toUpper().unicode();
+        int child = nodes[n].child;
+        while (child >= 0 && nodes[child].c != c)
+            child = nodes[child].sibling;
+        if (child < 0) {
+            child = (int)nodes.size();
+            nodes.push_back({c, NO_MATCH, -1, nodes[n].child});
+            nodes[n].child = child;
+        }
+        n = child;
+    }
+    if (nodes[n].id == NO_MATCH)
+        nodes[n].id = rules++;
+    return nodes[n].id;
+}
+
+int devicenamematcher::addSubstring(const QString &substring) {
+    substrings.append(substring);
+    substringIds.append(rules);
+    return rules++;
+}
+
+int devicenamematcher::match(const QString &name) const {
+    if (m_matchAll)
+        return MATCH_ALL;
+    if (nodes[0].id != NO_MATCH)
+        return nodes[0].id;
+
+    int n = 0;
+    for (const QChar ch : name) {
+        const ushort c = ch.toUpper().unicode();
+        int child = nodes[n].child;
+        while (child >= 0 && nodes[child].c != c)
+            child = nodes[child].sibling;
+        if (child < 0)
+            break;
+        if (nodes[child].id != NO_MATCH)
+            return nodes[child].id;
+        n = child;
+    }
+
+    for (int i = 0; i < substrings.size(); i++) {
+        if (name.contains(substrings.at(i), Qt::CaseInsensitive))
+            return substringIds.at(i);
+    }
+    return NO_MATCH;
+}
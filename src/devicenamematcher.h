@@ -0,0 +1,57 @@
+#ifndef DEVICENAMEMATCHER_H
+#define DEVICENAMEMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+/**
+ * @brief The devicenamematcher class tells whether an advertised name can belong to one of the supported devices.
+ * The name prefixes are compiled into a trie, so a lookup walks the name once whatever the number of prefixes,
+ * without allocating. The comparison ignores the case: the matcher answers "maybe", the driver rules decide.
+ */
+class devicenamematcher {
+  public:
+    enum { NO_MATCH = -1, MATCH_ALL = -2 };
+
+    devicenamematcher() { clear(); }
+
+    void clear();
+    /**
+     * @brief addPrefix Returns the id match() reports for the names starting with prefix.
+     */
+    int addPrefix(const QString &prefix);
+    /**
+     * @brief addSubstring For the few names that are matched anywhere: checked after the trie, one by one.
+     */
+    int addSubstring(const QString &substring);
+    /**
+     * @brief setMatchAll For the rules that do not look at the name at all.
+     */
+    void setMatchAll(bool matchAll) { m_matchAll = matchAll; }
+
+    /**
+     * @brief match The id of the shortest prefix (or else the first substring) the name matches, MATCH_ALL if
+     * setMatchAll() is on, NO_MATCH if no rule can select a driver for it.
+     */
+    int match(const QString &name) const;
+    bool matches(const QString &name) const { return match(name) != NO_MATCH; }
+
+  private:
+    struct node {
+        ushort c;
+        int id; // the rule ending here, NO_MATCH for the inner nodes
+        int child;
+        int sibling;
+    };
+
+    std::vector<node> nodes; // nodes[0] is the root
+    QStringList substrings;
+    QVector<int> substringIds;
+    int rules = 0;
+    bool m_matchAll = false;
+};
+
+#endif // DEVICENAMEMATCHER_H
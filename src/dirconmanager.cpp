@@ -1,4 +1,5 @@
 #include "dirconmanager.h"
+#include "latencytrace.h"
 #include <QNetworkInterface>
 #include <QSettings>
 
@@ -138,7 +139,7 @@ QString DirconManager::getMacAddress() {
 
 DirconManager::DirconManager(bluetoothdevice *Bike, uint8_t bikeResistanceOffset, double bikeResistanceGain,
                              QObject *parent)
-    : QObject(parent) {
+    : QObject(parent), Bike(Bike) {
     QSettings settings;
     DirconProcessorService *service;
     QList<DirconProcessorService *> services, proc_services;
@@ -154,21 +155,23 @@ DirconManager::DirconManager(bluetoothdevice *Bike, uint8_t bikeResistanceOffset
     connect(writeP2AD9, SIGNAL(changeInclination(double, double)), this, SIGNAL(changeInclination(double, double)));
     connect(writeP2AD9, SIGNAL(ftmsCharacteristicChanged(QLowEnergyCharacteristic, QByteArray)), this,
             SIGNAL(ftmsCharacteristicChanged(QLowEnergyCharacteristic, QByteArray)));
-    QObject::connect(&bikeTimer, &QTimer::timeout, this, &DirconManager::bikeProvider);
+    QObject::connect(&bikeScheduler, &NotificationScheduler::notify, this, &DirconManager::bikeProvider);
     QString mac = getMacAddress();
     DM_MACHINE_OP(DM_MACHINE_INIT_OP, services, proc_services, type)
-    bikeTimer.start(1000);
+    bikeScheduler.start(Bike);
 }
 
 #define DM_CHAR_NOTIF_NOTIF1_OP(UUID, P1, P2, P3)                                                                      \
     QByteArray all##UUID;                                                                                              \
-    int rv##UUID = notif##UUID->notify(all##UUID);
+    int rv##UUID = notif##UUID->notify(snapshot, all##UUID);
 
 #define DM_CHAR_NOTIF_NOTIF2_OP(UUID, P1, P2, P3)                                                                      \
     if (rv##UUID == CN_OK)                                                                                             \
         P1->sendCharacteristicNotification(0x##UUID, all##UUID);
 
-void DirconManager::bikeProvider() {
+void DirconManager::bikeProvider(const CharacteristicSnapshot &snapshot) {
+    // the scheduler's snapshot: every characteristic reports the same values
+    latencytrace::mark(latencytrace::SNAPSHOT_TAKEN);
     DM_CHAR_NOTIF_OP(DM_CHAR_NOTIF_NOTIF1_OP, 0, 0, 0)
     foreach (DirconProcessor *processor, processors) { DM_CHAR_NOTIF_OP(DM_CHAR_NOTIF_NOTIF2_OP, processor, 0, 0) }
 }
@@ -13,6 +13,7 @@
 #include "characteristicwriteprocessor2ad9.h"
 #include "dirconpacket.h"
 #include "dirconprocessor.h"
+#include "notificationscheduler.h"
 #include <QObject>
 
 #define DM_CHAR_NOTIF_OP(OP, P1, P2, P3)                                                                               \
@@ -23,7 +24,8 @@
 
 class DirconManager : public QObject {
     Q_OBJECT
-    QTimer bikeTimer;
+    NotificationScheduler bikeScheduler;
+    bluetoothdevice *Bike = 0;
     CharacteristicWriteProcessor2AD9 *writeP2AD9 = 0;
     DM_CHAR_NOTIF_OP(DM_CHAR_NOTIF_DEFINE_OP, 0, 0, 0)
     QList<DirconProcessor *> processors;
@@ -33,7 +35,7 @@ class DirconManager : public QObject {
     explicit DirconManager(bluetoothdevice *t, uint8_t bikeResistanceOffset = 4, double bikeResistanceGain = 1.0,
                            QObject *parent = nullptr);
   private slots:
-    void bikeProvider();
+    void bikeProvider(const CharacteristicSnapshot &snapshot);
   signals:
     void changeInclination(double grade, double percentage);
     void ftmsCharacteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
@@ -2,6 +2,13 @@
 
 DirconPacket::DirconPacket() {}
 
+// the 16 bit uuid inside the 128 bit one starting at p
+static inline quint16 readUuid(const quint8 *p) { return (p[DPKT_POS_SH8] << 8) | p[DPKT_POS_SH0]; }
+
+static inline QByteArray payload(const quint8 *buf, int from, int length) {
+    return QByteArray(reinterpret_cast<const char *>(buf) + from, length);
+}
+
 DirconPacket::operator QString() const {
     QString us = QString();
     foreach (quint16 u, uuids) { us += QString(QStringLiteral("%1,")).arg(u, 4, 16, QLatin1Char('0')); }
@@ -17,15 +24,15 @@ DirconPacket::operator QString() const {
         .arg(us);
 }
 
-int DirconPacket::parse(const QByteArray &buf, int last_seq_number) {
-    if (buf.size() >= DPKT_MESSAGE_HEADER_LENGTH) {
-        this->MessageVersion = ((quint8)buf.at(0));
-        this->Identifier = ((quint8)buf.at(1));
-        this->SequenceNumber = ((quint8)buf.at(2));
-        this->ResponseCode = ((quint8)buf.at(3));
-        this->Length = (((quint8)buf.at(4)) << 8) | ((quint8)buf.at(5));
+int DirconPacket::parse(const quint8 *buf, int size, int last_seq_number) {
+    if (size >= DPKT_MESSAGE_HEADER_LENGTH) {
+        this->MessageVersion = buf[0];
+        this->Identifier = buf[1];
+        this->SequenceNumber = buf[2];
+        this->ResponseCode = buf[3];
+        this->Length = (buf[4] << 8) | buf[5];
         this->isRequest = false;
-        int difflen = buf.size() - DPKT_MESSAGE_HEADER_LENGTH;
+        int difflen = size - DPKT_MESSAGE_HEADER_LENGTH;
         int rembuf = DPKT_MESSAGE_HEADER_LENGTH + this->Length;
         if (difflen < this->Length)
             return DPKT_PARSE_WAIT;
@@ -39,8 +46,7 @@ int DirconPacket::parse(const QByteArray &buf, int last_seq_number) {
                 int idx = 0;
                 this->uuids.clear();
                 while (this->Length >= idx + 16) {
-                    quint16 uuid = (((quint16)buf.at(idx + DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH8)) << 8);
-                    uuid |= ((quint16)buf.at(idx + DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH0)) & 0x00FF;
+                    quint16 uuid = readUuid(buf + DPKT_MESSAGE_HEADER_LENGTH + idx);
                     this->uuids.append(uuid);
                     idx += 16;
                 }
@@ -49,9 +55,7 @@ int DirconPacket::parse(const QByteArray &buf, int last_seq_number) {
                 return DPKT_PARSE_ERROR - rembuf;
         } else if (this->Identifier == DPKT_MSGID_DISCOVER_CHARACTERISTICS) {
             if (this->Length >= 16) {
-                quint16 uuid = ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH8)) << 8;
-                uuid |= ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH0)) & 0x00FF;
-                this->uuid = uuid;
+                this->uuid = readUuid(buf + DPKT_MESSAGE_HEADER_LENGTH);
                 if (this->Length == 16) {
                     this->isRequest = this->checkIsRequest(last_seq_number);
                     return rembuf;
@@ -60,10 +64,9 @@ int DirconPacket::parse(const QByteArray &buf, int last_seq_number) {
                     this->additional_data.clear();
                     int idx = 16;
                     while (this->Length >= idx + 17) {
-                        quint16 uuid = (((quint16)buf.at(idx + DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH8)) << 8);
-                        uuid |= ((quint16)buf.at(idx + DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH0)) & 0x00FF;
+                        quint16 uuid = readUuid(buf + DPKT_MESSAGE_HEADER_LENGTH + idx);
                         this->uuids.append(uuid);
-                        this->additional_data.append(((quint8)buf.at(idx + DPKT_MESSAGE_HEADER_LENGTH + 16)));
+                        this->additional_data.append((char)buf[idx + DPKT_MESSAGE_HEADER_LENGTH + 16]);
                         idx += 17;
                     }
                     return rembuf;
@@ -73,47 +76,39 @@ int DirconPacket::parse(const QByteArray &buf, int last_seq_number) {
                 return DPKT_PARSE_ERROR - rembuf;
         } else if (this->Identifier == DPKT_MSGID_READ_CHARACTERISTIC) {
             if (this->Length >= 16) {
-                quint16 uuid = ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH8)) << 8;
-                uuid |= ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH0)) & 0x00FF;
-                this->uuid = uuid;
+                this->uuid = readUuid(buf + DPKT_MESSAGE_HEADER_LENGTH);
                 if (this->Length == 16)
                     this->isRequest = this->checkIsRequest(last_seq_number);
                 else
                     this->additional_data =
-                        buf.mid(DPKT_MESSAGE_HEADER_LENGTH + 16, rembuf - (DPKT_MESSAGE_HEADER_LENGTH + 16));
+                        payload(buf, DPKT_MESSAGE_HEADER_LENGTH + 16, rembuf - (DPKT_MESSAGE_HEADER_LENGTH + 16));
                 return rembuf;
             } else
                 return DPKT_PARSE_ERROR - rembuf;
         } else if (this->Identifier == DPKT_MSGID_WRITE_CHARACTERISTIC) {
             if (this->Length > 16) {
-                quint16 uuid = ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH8)) << 8;
-                uuid |= ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH0)) & 0x00FF;
-                this->uuid = uuid;
+                this->uuid = readUuid(buf + DPKT_MESSAGE_HEADER_LENGTH);
                 this->additional_data =
-                    buf.mid(DPKT_MESSAGE_HEADER_LENGTH + 16, rembuf - (DPKT_MESSAGE_HEADER_LENGTH + 16));
+                    payload(buf, DPKT_MESSAGE_HEADER_LENGTH + 16, rembuf - (DPKT_MESSAGE_HEADER_LENGTH + 16));
                 this->isRequest = this->checkIsRequest(last_seq_number);
                 return rembuf;
             } else
                 return DPKT_PARSE_ERROR - rembuf;
         } else if (this->Identifier == DPKT_MSGID_ENABLE_CHARACTERISTIC_NOTIFICATIONS) {
             if (this->Length == 16 || this->Length == 17) {
-                quint16 uuid = ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH8)) << 8;
-                uuid |= ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH0)) & 0x00FF;
-                this->uuid = uuid;
+                this->uuid = readUuid(buf + DPKT_MESSAGE_HEADER_LENGTH);
                 if (this->Length == 17) {
                     this->isRequest = true;
-                    this->additional_data = buf.mid(DPKT_MESSAGE_HEADER_LENGTH + 16, 1);
+                    this->additional_data = payload(buf, DPKT_MESSAGE_HEADER_LENGTH + 16, 1);
                 }
                 return rembuf;
             } else
                 return DPKT_PARSE_ERROR - rembuf;
         } else if (this->Identifier == DPKT_MSGID_UNSOLICITED_CHARACTERISTIC_NOTIFICATION) {
             if (this->Length > 16) {
-                quint16 uuid = ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH8)) << 8;
-                uuid |= ((quint16)buf.at(DPKT_MESSAGE_HEADER_LENGTH + DPKT_POS_SH0)) & 0x00FF;
-                this->uuid = uuid;
+                this->uuid = readUuid(buf + DPKT_MESSAGE_HEADER_LENGTH);
                 this->additional_data =
-                    buf.mid(DPKT_MESSAGE_HEADER_LENGTH + 16, rembuf - (DPKT_MESSAGE_HEADER_LENGTH + 16));
+                    payload(buf, DPKT_MESSAGE_HEADER_LENGTH + 16, rembuf - (DPKT_MESSAGE_HEADER_LENGTH + 16));
                 return rembuf;
             } else
                 return DPKT_PARSE_ERROR - rembuf;
@@ -143,11 +138,12 @@ DirconPacket &DirconPacket::operator=(const DirconPacket &cp) {
     return *this;
 }
 
-QByteArray DirconPacket::encode(int last_seq_number) {
+void DirconPacket::encode(int last_seq_number, QByteArray &byteout) {
     quint16 u;
     int i = 0;
+    byteout.resize(0);
     if (this->Identifier == DPKT_MSGID_ERROR)
-        return QByteArray();
+        return;
     else if (this->isRequest)
         this->SequenceNumber = last_seq_number & 0xFF;
     else if (this->Identifier == DPKT_MSGID_UNSOLICITED_CHARACTERISTIC_NOTIFICATION)
@@ -155,7 +151,6 @@ QByteArray DirconPacket::encode(int last_seq_number) {
     else
         this->SequenceNumber = last_seq_number;
     this->MessageVersion = 1;
-    QByteArray byteout;
     byteout.append((char)this->MessageVersion);
     byteout.append((char)this->Identifier);
     byteout.append((char)this->SequenceNumber);
@@ -211,5 +206,4 @@ QByteArray DirconPacket::encode(int last_seq_number) {
         byteout.append((char *)this->uuid_bytes, 16);
         byteout.append(this->additional_data);
     }
-    return byteout;
 }
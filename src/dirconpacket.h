@@ -44,8 +44,25 @@ class DirconPacket {
     bool isRequest = false;
     DirconPacket(const DirconPacket &cp);
     DirconPacket &operator=(const DirconPacket &cp);
-    QByteArray encode(int last_seq_number);
-    int parse(const QByteArray &buf, int last_seq_number);
+    QByteArray encode(int last_seq_number) {
+        QByteArray out;
+        encode(last_seq_number, out);
+        return out;
+    }
+    /**
+     * @brief encode Encodes the packet into out, replacing its content. A buffer with reserved capacity keeps it,
+     * so a caller encoding many packets can reuse the same one.
+     */
+    void encode(int last_seq_number, QByteArray &out);
+    /**
+     * @brief parse Parses the packet at the start of buf, in place: only the payload is copied.
+     * @return the length of the packet, DPKT_PARSE_WAIT if buf does not hold a whole packet yet, or
+     * DPKT_PARSE_ERROR minus the length of an invalid packet.
+     */
+    int parse(const quint8 *buf, int size, int last_seq_number);
+    int parse(const QByteArray &buf, int last_seq_number) {
+        return parse(reinterpret_cast<const quint8 *>(buf.constData()), buf.size(), last_seq_number);
+    }
     operator QString() const;
 
   private:
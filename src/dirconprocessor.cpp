@@ -1,14 +1,25 @@
 #include "dirconprocessor.h"
 #include "dirconpacket.h"
+#include "latencytrace.h"
 #include "qzsettings.h"
 #include <QSettings>
+#include <cstring>
 
 DirconProcessor::DirconProcessor(const QList<DirconProcessorService *> &my_services, const QString &serv_name,
                                  quint16 serv_port, const QString &serv_sn, const QString &my_mac, QObject *parent)
     : QObject(parent), services(my_services), mac(my_mac), serverPort(serv_port), serialN(serv_sn),
       serverName(serv_name) {
     qDebug() << "In the constructor of dircon processor for" << serverName;
-    foreach (DirconProcessorService *my_service, my_services) { my_service->setParent(this); }
+    foreach (DirconProcessorService *my_service, my_services) {
+        my_service->setParent(this);
+        foreach (DirconProcessorCharacteristic *c, my_service->chars)
+            if ((c->type & DPKT_CHAR_PROP_FLAG_NOTIFY) && !notifyIndex.contains(c->uuid))
+                notifyIndex.insert(c->uuid, notifyIndex.size());
+    }
+    QSettings settings;
+    notifyUnsubscribed =
+        !settings.value(QZSettings::wahoo_rgt_dircon, QZSettings::default_wahoo_rgt_dircon).toBool();
+    notification.reserve(64);
 }
 
 DirconProcessor::~DirconProcessor() {}
@@ -69,9 +80,10 @@ bool DirconProcessor::init() {
     qDebug() << "Dircon Processor init for" << serverName;
     bool rv = initServer();
     qDebug() << "Dircon TCP Server RV" << rv;
-    if (rv)
+    QSettings settings;
+    if (rv && settings.value(QZSettings::dircon_mdns, QZSettings::default_dircon_mdns).toBool())
         initAdvertising();
-    else
+    else if (!rv)
         qDebug() << "Cannot init dircon TCP server at port" << serverPort;
     return rv;
 }
@@ -80,9 +92,12 @@ void DirconProcessor::tcpNewConnection() {
     QTcpSocket *socket = server->nextPendingConnection();
     qDebug() << "New connection from" << socket->peerAddress().toString() << ":" << socket->peerPort()
              << " uuid = " << serverName;
+    // the packets are small and latency bound: do not let Nagle hold the responses and the notifications
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
     connect(socket, SIGNAL(disconnected()), this, SLOT(tcpDisconnected()));
     connect(socket, SIGNAL(readyRead()), this, SLOT(tcpDataAvailable()));
     DirconProcessorClient *client = new DirconProcessorClient(socket);
+    client->char_notify.resize(notifyIndex.size());
     clientsMap.insert(socket, client);
 }
 
@@ -171,14 +186,9 @@ DirconPacket DirconProcessor::processPacket(DirconProcessorClient *client, const
                     if (cc->uuid == pkt.uuid) {
                         cfound = true;
                         if (cc->type & DPKT_CHAR_PROP_FLAG_NOTIFY) {
-                            int idx;
                             char notif = pkt.additional_data.at(0);
                             out.uuid = pkt.uuid;
-
-                            if ((idx = client->char_notify.indexOf(pkt.uuid)) >= 0 && !notif)
-                                client->char_notify.removeAt(idx);
-                            else if (idx < 0 && notif)
-                                client->char_notify.append(pkt.uuid);
+                            client->char_notify.setBit(notifyIndex.value(pkt.uuid), notif != 0);
                             out.ResponseCode = DPKT_RESPCODE_SUCCESS_REQUEST;
                             emit onCharacteristicNotificationSwitch(cc->uuid, notif);
                         } else
@@ -197,73 +207,107 @@ DirconPacket DirconProcessor::processPacket(DirconProcessorClient *client, const
 }
 
 bool DirconProcessor::sendCharacteristicNotification(quint16 uuid, const QByteArray &data) {
-    DirconPacket pkt;
-    QTcpSocket *socket;
-    DirconProcessorClient *client;
-    QSettings settings;
-    bool rv = true, rvs;
-    pkt.additional_data = data;
-    pkt.Identifier = DPKT_MSGID_UNSOLICITED_CHARACTERISTIC_NOTIFICATION;
-    pkt.ResponseCode = DPKT_RESPCODE_SUCCESS_REQUEST;
-    pkt.uuid = uuid;
-    for (QHash<QTcpSocket *, DirconProcessorClient *>::iterator i = clientsMap.begin(); i != clientsMap.end(); ++i) {
-        client = i.value();
-        if (client->char_notify.indexOf(uuid) >= 0 || !settings.value(QZSettings::wahoo_rgt_dircon, QZSettings::default_wahoo_rgt_dircon).toBool()) {
-            socket = i.key();
-            rvs = socket->write(pkt.encode(0)) < 0;
-            if (rvs)
-                rv = false;
-            qDebug() << serverName << "sending to" << socket->peerAddress().toString() << ":" << socket->peerPort()
-                     << " notification for uuid = " << QString(QStringLiteral("%1")).arg(uuid, 4, 16, QLatin1Char('0'))
-                     << "rv=" << (!rvs) << data.toHex(' ');
+    const int bit = notifyIndex.value(uuid, -1);
+    if (bit < 0 && !notifyUnsubscribed)
+        return true;
+    bool rv = true;
+    int sent = 0;
+    for (QHash<QTcpSocket *, DirconProcessorClient *>::const_iterator i = clientsMap.constBegin();
+         i != clientsMap.constEnd(); ++i) {
+        if (!notifyUnsubscribed && !i.value()->char_notify.testBit(bit))
+            continue;
+        if (!sent++) {
+            DirconPacket pkt;
+            pkt.additional_data = data;
+            pkt.Identifier = DPKT_MSGID_UNSOLICITED_CHARACTERISTIC_NOTIFICATION;
+            pkt.ResponseCode = DPKT_RESPCODE_SUCCESS_REQUEST;
+            pkt.uuid = uuid;
+            pkt.encode(0, notification);
         }
+        if (i.key()->write(notification.constData(), notification.size()) < 0)
+            rv = false;
+    }
+    if (sent) {
+        latencytrace::mark(latencytrace::FRAME_SENT);
+        qzCDebug(qzDircon) << serverName << "sending notification for uuid = "
+                          << QString(QStringLiteral("%1")).arg(uuid, 4, 16, QLatin1Char('0')) << "to" << sent
+                          << "clients rv=" << rv << data.toHex(' ');
     }
     return rv;
 }
 
+qint64 DirconRingBuffer::read(QIODevice *device) {
+    const int wanted = (int)qBound<qint64>(1, device->bytesAvailable(), DP_READ_CHUNK);
+    if (buf.size() - tail < wanted) {
+        if (head) {
+            memmove(buf.data(), buf.constData() + head, tail - head);
+            tail -= head;
+            head = 0;
+        }
+        if (buf.size() - tail < wanted)
+            buf.resize(tail + qMax(wanted, DP_READ_CHUNK));
+    }
+    const qint64 n = device->read(buf.data() + tail, buf.size() - tail);
+    if (n > 0)
+        tail += n;
+    return n;
+}
+
 void DirconProcessor::tcpDataAvailable() {
     QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
     DirconProcessorClient *client = clientsMap.value(socket);
-    QByteArray data = socket->readAll();
-    qDebug() << "Data available for uuid " << serverName << ":" << data.toHex();
-    if (client) {
-        int buflimit, rembuf;
-        client->buffer.append(data);
-        while (1) {
-            DirconPacket pkt;
-            buflimit = pkt.parse(client->buffer, client->seq);
-            qDebug() << "Pkt for uuid" << serverName << "parsed rv=" << buflimit << " ->" << pkt;
-            if (buflimit > 0) {
-                rembuf = buflimit;
-                if (pkt.isRequest)
-                    client->seq = pkt.SequenceNumber;
-                else if (pkt.Identifier != DPKT_MSGID_UNSOLICITED_CHARACTERISTIC_NOTIFICATION)
-                    client->seq += 1;
-            } else if (buflimit < DPKT_PARSE_ERROR) {
-                rembuf = -buflimit - DPKT_PARSE_ERROR;
-                qDebug() << "Unexpected packet" << client->buffer.mid(0, rembuf).toHex();
-            } else
-                rembuf = -1;
-            if (rembuf >= 0)
-                client->buffer = client->buffer.mid(rembuf);
-            if (buflimit > 0) {
-                DirconPacket resp = processPacket(client, pkt);
-                qDebug() << "Sending resp for uuid" << serverName << ":" << resp;
-                if (resp.Identifier != DPKT_MSGID_ERROR) {
-                    QByteArray byteout = resp.encode(pkt.SequenceNumber);
-                    if (byteout.size())
-                        client->sock->write(byteout);
-                }
-            } else if (rembuf >= 0) {
-                DirconPacket resp;
-                resp.isRequest = false;
-                resp.ResponseCode = DPKT_RESPCODE_UNEXPECTED_ERROR;
-                resp.Identifier = pkt.Identifier;
-                QByteArray byteout = resp.encode(pkt.SequenceNumber);
-                if (byteout.size())
-                    client->sock->write(byteout);
-            } else
-                break;
-        }
+    if (!client) {
+        socket->readAll();
+        return;
+    }
+    qint64 n;
+    while (socket->bytesAvailable() > 0 && (n = client->buffer.read(socket)) > 0) {
+        qzCDebug(qzDircon) << "Data available for uuid " << serverName << ":"
+                          << QByteArray::fromRawData(reinterpret_cast<const char *>(client->buffer.data()),
+                                                     client->buffer.size())
+                                 .toHex();
+        processBuffer(client);
+    }
+}
+
+void DirconProcessor::processBuffer(DirconProcessorClient *client) {
+    int buflimit, rembuf;
+    while (1) {
+        DirconPacket pkt;
+        buflimit = pkt.parse(client->buffer.data(), client->buffer.size(), client->seq);
+        qzCDebug(qzDircon) << "Pkt for uuid" << serverName << "parsed rv=" << buflimit << " ->" << pkt;
+        if (buflimit > 0) {
+            rembuf = buflimit;
+            if (pkt.isRequest)
+                client->seq = pkt.SequenceNumber;
+            else if (pkt.Identifier != DPKT_MSGID_UNSOLICITED_CHARACTERISTIC_NOTIFICATION)
+                client->seq += 1;
+        } else if (buflimit < DPKT_PARSE_ERROR) {
+            rembuf = -buflimit - DPKT_PARSE_ERROR;
+            qzCDebug(qzDircon) << "Unexpected packet"
+                              << QByteArray::fromRawData(reinterpret_cast<const char *>(client->buffer.data()), rembuf)
+                                     .toHex();
+        } else
+            rembuf = -1;
+        if (rembuf >= 0)
+            client->buffer.consume(rembuf);
+        if (buflimit > 0) {
+            DirconPacket resp = processPacket(client, pkt);
+            qzCDebug(qzDircon) << "Sending resp for uuid" << serverName << ":" << resp;
+            if (resp.Identifier != DPKT_MSGID_ERROR) {
+                resp.encode(pkt.SequenceNumber, client->out);
+                if (client->out.size())
+                    client->sock->write(client->out.constData(), client->out.size());
+            }
+        } else if (rembuf >= 0) {
+            DirconPacket resp;
+            resp.isRequest = false;
+            resp.ResponseCode = DPKT_RESPCODE_UNEXPECTED_ERROR;
+            resp.Identifier = pkt.Identifier;
+            resp.encode(pkt.SequenceNumber, client->out);
+            if (client->out.size())
+                client->sock->write(client->out.constData(), client->out.size());
+        } else
+            break;
     }
 }
@@ -7,6 +7,7 @@
 #include "qmdnsengine/provider.h"
 #include "qmdnsengine/server.h"
 #include "qmdnsengine/service.h"
+#include <QBitArray>
 #include <QHash>
 #include <QObject>
 #include <QTcpServer>
@@ -59,14 +60,42 @@ class DirconProcessorService : public QObject {
 
 #define DP_BASE_UUID "0000u-0000-1000-8000-00805F9B34FB"
 // QString("%1").arg(iTest & 0xFFFF, 4, 16);
+#define DP_READ_CHUNK 1024
+
+/**
+ * @brief The DirconRingBuffer class is the receive buffer of a client. The socket is read straight after the last
+ * unread byte and the packets are parsed in place, so consuming one only moves the read cursor. The unread bytes
+ * go back to the start only when the free space at the end runs out, which keeps every packet contiguous.
+ */
+class DirconRingBuffer {
+  public:
+    const quint8 *data() const { return reinterpret_cast<const quint8 *>(buf.constData()) + head; }
+    int size() const { return tail - head; }
+    void consume(int n) {
+        head += n;
+        if (head >= tail)
+            head = tail = 0;
+    }
+    /**
+     * @brief read Reads what the device has available, at most DP_READ_CHUNK bytes at a time.
+     * @return the bytes read, 0 or less if there was nothing to read
+     */
+    qint64 read(QIODevice *device);
+
+  private:
+    QByteArray buf;
+    int head = 0;
+    int tail = 0;
+};
 
 class DirconProcessorClient : public QObject {
   public:
-    DirconProcessorClient(QTcpSocket *sock) : QObject(sock), sock(sock) {}
+    DirconProcessorClient(QTcpSocket *sock) : QObject(sock), sock(sock) { out.reserve(256); }
     quint8 seq = 0;
-    QList<quint16> char_notify;
+    QBitArray char_notify; // by DirconProcessor::notifyIndex
     QTcpSocket *sock;
-    QByteArray buffer;
+    DirconRingBuffer buffer;
+    QByteArray out; // responses are encoded here, its capacity is kept between packets
 };
 
 class DirconProcessor : public QObject {
@@ -81,9 +110,13 @@ class DirconProcessor : public QObject {
     QMdnsEngine::Provider *mdnsProvider = 0;
     QMdnsEngine::Hostname *mdnsHostname = 0;
     QHash<QTcpSocket *, DirconProcessorClient *> clientsMap;
+    QHash<quint16, int> notifyIndex; // bit of each notifying characteristic in the clients' char_notify
+    bool notifyUnsubscribed;         // !wahoo_rgt_dircon: every client gets every notification
+    QByteArray notification;         // encoded once per notification, written to every client
     bool initServer();
     void initAdvertising();
     DirconPacket processPacket(DirconProcessorClient *client, const DirconPacket &pkt);
+    void processBuffer(DirconProcessorClient *client);
 
   public:
     ~DirconProcessor();
@@ -1,4 +1,5 @@
 #include "domyosrower.h"
+#include "qzsettingscache.h"
 
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -261,7 +262,7 @@ void domyosrower::serviceDiscovered(const QBluetoothUuid &gatt) {
 void domyosrower::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
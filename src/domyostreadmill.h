@@ -93,6 +93,11 @@ class domyostreadmill : public treadmill {
 
   public slots:
     void deviceDiscovered(const QBluetoothDeviceInfo &device);
+    /**
+     * @brief parseNotification Decodes a notification of the characteristic uuid. characteristicChanged forwards
+     * here, the btsnoop replay tool (src/test/btsnoop-replay) calls it directly with recorded packets.
+     */
+    void parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue);
     void searchingStop();
 
   private slots:
@@ -193,10 +193,13 @@ double echelonconnectsport::bikeResistanceToPeloton(double resistance) {
            settings.value(QZSettings::peloton_offset, QZSettings::default_peloton_offset).toDouble();
 }
 
-void echelonconnectsport::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                                const QByteArray &newValue) {
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
-    Q_UNUSED(characteristic);
+void echelonconnectsport::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
+    parseNotification(characteristic.uuid(), newValue);
+}
+
+void echelonconnectsport::parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue) {
+    // qDebug() << "characteristicChanged" << uuid << newValue << newValue.length();
+    Q_UNUSED(uuid);
     QSettings settings;
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
@@ -300,7 +303,7 @@ void echelonconnectsport::characteristicChanged(const QLowEnergyCharacteristic &
     qDebug() << QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime);
     qDebug() << QStringLiteral("Current Watt: ") + QString::number(watts());
 
-    if (m_control->error() != QLowEnergyController::NoError) {
+    if (m_control && m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
     }
 }
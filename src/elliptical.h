@@ -8,19 +8,19 @@ class elliptical : public bluetoothdevice {
 
   public:
     elliptical();
-    metric lastRequestedPelotonResistance();
+    const metric &lastRequestedPelotonResistance();
     void update_metrics(bool watt_calc, const double watts);
-    metric lastRequestedCadence();
-    metric lastRequestedResistance();
-    metric lastRequestedSpeed() { return RequestedSpeed; }
-    virtual metric currentInclination();
-    virtual metric currentResistance();
+    const metric &lastRequestedCadence();
+    const metric &lastRequestedResistance();
+    const metric &lastRequestedSpeed() { return RequestedSpeed; }
+    virtual const metric &currentInclination();
+    virtual const metric &currentResistance();
     virtual double requestedSpeed();
     virtual uint8_t fanSpeed();
     virtual double currentCrankRevolutions();
     virtual uint16_t lastCrankEventTime();
     virtual bool connected();
-    metric pelotonResistance();
+    const metric &pelotonResistance();
     virtual int pelotonToEllipticalResistance(int pelotonResistance);
     bluetoothdevice::BLUETOOTH_TYPE deviceType();
     void clearStats();
@@ -138,45 +138,25 @@ void fitmetria_fanfit::fanSpeedRequest(uint8_t speed) {
 
 void fitmetria_fanfit::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
                                            bool wait_for_response) {
-    QEventLoop loop;
-    QTimer timeout;
-
     if (gattCommunicationChannelService == nullptr || gattWriteCharacteristic.isValid() == false) {
         qDebug() << QStringLiteral(
             "fitmetria_fanfit trying to change the fan speed before the connection is estabilished");
         return;
     }
 
-    // if there are some crash here, maybe it's better to use 2 separate event for the characteristicChanged.
-    // one for the resistance changed event (spontaneous), and one for the other ones.
-    if (wait_for_response) {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicChanged, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    } else {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    }
-
     if (gattCommunicationChannelService->state() != QLowEnergyService::ServiceState::ServiceDiscovered ||
         m_control->state() == QLowEnergyController::UnconnectedState) {
         qDebug() << QStringLiteral("writeCharacteristic error because the connection is closed");
         return;
     }
 
-    if (!gattWriteCharacteristic.isValid()) {
-        qDebug() << QStringLiteral("gattWriteCharacteristic is invalid");
-        return;
-    }
-
-    gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
-                                                         QByteArray((const char *)data, data_len));
+    writeQueue()->write(gattCommunicationChannelService, gattWriteCharacteristic,
+                        QByteArray((const char *)data, data_len), wait_for_response);
 
     if (!disable_log) {
         qDebug() << QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
                         QStringLiteral(" // ") + info;
     }
-
-    loop.exec();
 }
 
 void fitmetria_fanfit::stateChanged(QLowEnergyService::ServiceState state) {
@@ -1,4 +1,5 @@
 #include "flywheelbike.h"
+#include "qzsettingscache.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualbike.h"
@@ -244,7 +245,7 @@ void flywheelbike::characteristicChanged(const QLowEnergyCharacteristic &charact
     static uint8_t zero_fix_filter = 0;
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     //    QString heartRateBeltName = settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name)
     //                                    .toString(); // NOTE: clazy-unused-non-trivial-variable
 
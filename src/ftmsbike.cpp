@@ -1,4 +1,7 @@
 #include "ftmsbike.h"
+#include "ftmsdata.h"
+#include "latencytrace.h"
+#include "qzsettingscache.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -47,10 +50,11 @@ void ftmsbike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QStrin
     }
 
     gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
+    latencytrace::mark(latencytrace::COMMAND_WRITTEN);
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        qzEmitDebug(qzDeviceRaw, QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+                                     QStringLiteral(" // ") + info);
     }
 
     loop.exec();
@@ -110,6 +114,9 @@ void ftmsbike::update() {
             // updateDisplay(elapsed);
         }
 
+        // resistance and power share the control point: the requests received in between (the 0x2AD9 writes of
+        // the virtual bike, the trainprogram, the 1 s power resend) collapse to the newest one, written at most
+        // once per slot interval
         if (requestResistance != -1) {
             if (requestResistance > 100) {
                 requestResistance = 100;
@@ -117,25 +124,30 @@ void ftmsbike::update() {
             else if (requestResistance == 0) {
                 requestResistance = 1;
             }
-
-            if (requestResistance != currentResistance().value()) {
-                emit debug(QStringLiteral("writing resistance ") + QString::number(requestResistance));
-                // if the FTMS is connected, the ftmsCharacteristicChanged event will do all the stuff because it's a
-                // FTMS bike. This condition handles the peloton requests
-                if (((virtualBike && !virtualBike->ftmsDeviceConnected()) || !virtualBike) &&
-                    (requestPower == 0 || requestPower == -1)) {
-                    init();
-                    forceResistance(requestResistance);
-                }
-            }
+            resistanceSlot.post(requestResistance);
             requestResistance = -1;
         }
         if (requestPower != -1) {
-            qDebug() << QStringLiteral("writing power") << requestPower;
-            init();
-            forcePower(requestPower);
+            powerSlot.post(requestPower);
             requestPower = -1;
         }
+
+        double target;
+        if (resistanceSlot.take(currentResistance().value(), &target)) {
+            emit debug(QStringLiteral("writing resistance ") + QString::number(target));
+            // if the FTMS is connected, the ftmsCharacteristicChanged event will do all the stuff because it's a
+            // FTMS bike. This condition handles the peloton requests
+            if (((virtualBike && !virtualBike->ftmsDeviceConnected()) || !virtualBike) &&
+                (!powerSlot.pending() || powerSlot.target() == 0)) {
+                init();
+                forceResistance((resistance_t)target);
+            }
+        }
+        if (powerSlot.take(m_watt.value(), &target)) {
+            qDebug() << QStringLiteral("writing power") << target;
+            init();
+            forcePower((int16_t)target);
+        }
         if (requestStart != -1) {
             emit debug(QStringLiteral("starting..."));
 
@@ -157,107 +169,71 @@ void ftmsbike::serviceDiscovered(const QBluetoothUuid &gatt) {
 }
 
 void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
-    Q_UNUSED(characteristic);
-    QSettings settings;
+    latencytrace::mark(latencytrace::NOTIFICATION_RECEIVED);
+    if (QLowEnergyService *s = qobject_cast<QLowEnergyService *>(sender()))
+        gattCache.notified(s->serviceUuid(), characteristic.uuid());
+    parseNotification(characteristic.uuid(), newValue);
+    latencytrace::mark(latencytrace::METRIC_UPDATED);
+}
+
+void ftmsbike::parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue) {
+    // qDebug() << "characteristicChanged" << uuid << newValue << newValue.length();
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
     bool disable_hr_frommachinery = settings.value(QZSettings::heart_ignore_builtin, QZSettings::default_heart_ignore_builtin).toBool();
     bool heart = false;
 
-    qDebug() << characteristic.uuid() << QStringLiteral(" << ") << newValue.toHex(' ');
+    qzCDebug(qzDeviceRaw) << uuid << QStringLiteral(" << ") << newValue.toHex(' ');
 
     lastPacket = newValue;
 
-    if (characteristic.uuid() == QBluetoothUuid((quint16)0x2AD2)) {
-
-        union flags {
-            struct {
-                uint16_t moreData : 1;
-                uint16_t avgSpeed : 1;
-                uint16_t instantCadence : 1;
-                uint16_t avgCadence : 1;
-                uint16_t totDistance : 1;
-                uint16_t resistanceLvl : 1;
-                uint16_t instantPower : 1;
-                uint16_t avgPower : 1;
-                uint16_t expEnergy : 1;
-                uint16_t heartRate : 1;
-                uint16_t metabolic : 1;
-                uint16_t elapsedTime : 1;
-                uint16_t remainingTime : 1;
-                uint16_t spare : 3;
-            };
-
-            uint16_t word_flags;
-        };
-
-        flags Flags;
-        int index = 0;
-        Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-        index += 2;
-
-        if (!Flags.moreData) {
+    if (uuid == QBluetoothUuid((quint16)ftmsdata::INDOOR_BIKE_DATA) ||
+        uuid == QBluetoothUuid((quint16)ftmsdata::CROSS_TRAINER_DATA)) {
+        // the cross trainer data carries the step rate where the bike data has the cadence
+        ftmsdata data;
+        if (!data.decode((ftmsdata::characteristic)uuid.toUInt16(), newValue))
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("FTMS packet shorter than its flags"));
+
+        if (data.has(ftmsdata::FIELD_SPEED)) {
             if (!settings.value(QZSettings::speed_power_based, QZSettings::default_speed_power_based).toBool()) {
-                Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                  (uint16_t)((uint8_t)newValue.at(index)))) /
-                        100.0;
+                Speed = data.speed;
             } else {
                 Speed = metric::calculateSpeedFromPower(watts(), Inclination.value(), Speed.value(),fabs(QDateTime::currentDateTime().msecsTo(Speed.lastChanged()) / 1000.0),  this->speedLimit());
             }
-            index += 2;
-            emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }
 
-        if (Flags.avgSpeed) {
-            double avgSpeed;
-            avgSpeed =
-                ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-                100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        if (data.has(ftmsdata::FIELD_AVERAGE_SPEED)) {
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Average Speed: ") + QString::number(data.averageSpeed));
         }
 
-        if (Flags.instantCadence) {
+        if (data.has(ftmsdata::FIELD_CADENCE)) {
             if (settings.value(QZSettings::cadence_sensor_name, QZSettings::default_cadence_sensor_name)
                     .toString()
                     .startsWith(QStringLiteral("Disabled"))) {
-                Cadence = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index)))) /
-                          2.0;
+                Cadence = data.cadence;
             }
-            index += 2;
-            emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
         }
 
-        if (Flags.avgCadence) {
-            double avgCadence;
-            avgCadence =
-                ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-                2.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Cadence: ") + QString::number(avgCadence));
+        if (data.has(ftmsdata::FIELD_AVERAGE_CADENCE)) {
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Average Cadence: ") + QString::number(data.averageCadence));
         }
 
-        if (Flags.totDistance) {
-            Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                                  (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint32_t)((uint8_t)newValue.at(index)))) /
-                       1000.0;
-            index += 3;
+        if (data.has(ftmsdata::FIELD_DISTANCE)) {
+            Distance = data.distance / 1000.0;
         } else {
             Distance += ((Speed.value() / 3600000.0) *
                          ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
         }
 
-        emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
+        qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        if (Flags.resistanceLvl) {
-            Resistance =
-                ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+        if (data.has(ftmsdata::FIELD_RESISTANCE)) {
+            Resistance = data.resistance;
             emit resistanceRead(Resistance.value());
-            index += 2;
-            emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
         } else {
             double ac = 0.01243107769;
             double bc = 1.145964912;
@@ -281,33 +257,20 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
             }
         }
 
-        if (Flags.instantPower) {
+        if (data.has(ftmsdata::FIELD_POWER)) {
             if (settings.value(QZSettings::power_sensor_name, QZSettings::default_power_sensor_name)
                     .toString()
                     .startsWith(QStringLiteral("Disabled")))
-                m_watt = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                   (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-            emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
+                m_watt = data.power;
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
         }
 
-        if (Flags.avgPower) {
-            double avgPower;
-            avgPower =
-                ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-            emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
+        if (data.has(ftmsdata::FIELD_AVERAGE_POWER)) {
+            qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Average Watt: ") + QString::number(data.averagePower));
         }
 
-        if (Flags.expEnergy && newValue.length() > index + 1) {
-            KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-
-            // energy per hour
-            index += 2;
-
-            // energy per minute
-            index += 1;
+        if (data.has(ftmsdata::FIELD_ENERGY)) {
+            KCal = data.energy;
         } else {
             if (watts())
                 KCal +=
@@ -319,7 +282,7 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
                                                                       // kg * 3.5) / 200 ) / 60
         }
 
-        emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
+        qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
 
     #ifdef Q_OS_ANDROID
         if (settings.value(QZSettings::ant_heart, QZSettings::default_ant_heart).toBool())
@@ -327,214 +290,12 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
         else
     #endif
         {
-            if (Flags.heartRate && !disable_hr_frommachinery && newValue.length() > index) {
-                Heart = ((double)((newValue.at(index))));
-                // index += 1; // NOTE: clang-analyzer-deadcode.DeadStores
-                emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-            } else {
-                Flags.heartRate = false;
+            heart = data.has(ftmsdata::FIELD_HEART) && !disable_hr_frommachinery;
+            if (heart) {
+                Heart = data.heart;
+                qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
             }
-            heart = Flags.heartRate;
-        }
-
-        if (Flags.metabolic) {
-            // todo
         }
-
-        if (Flags.elapsedTime) {
-            // todo
-        }
-
-        if (Flags.remainingTime) {
-            // todo
-        }
-    } else if(characteristic.uuid() == QBluetoothUuid((quint16)0x2ACE)) {
-        union flags {
-                struct {
-                    uint32_t moreData : 1;
-                    uint32_t avgSpeed : 1;
-                    uint32_t totDistance : 1;
-                    uint32_t stepCount: 1;
-                    uint32_t strideCount : 1;
-                    uint32_t elevationGain : 1;
-                    uint32_t rampAngle : 1;
-                    uint32_t resistanceLvl : 1;
-                    uint32_t instantPower : 1;
-                    uint32_t avgPower : 1;
-                    uint32_t expEnergy : 1;
-                    uint32_t heartRate : 1;
-                    uint32_t metabolicEq : 1;
-                    uint32_t elapsedTime : 1;
-                    uint32_t remainingTime : 1;
-                    uint32_t movementDirection : 1;
-                    uint32_t spare : 8;
-                };
-
-                uint32_t word_flags;
-            };
-
-            flags Flags;
-            int index = 0;
-            Flags.word_flags = (newValue.at(2) << 16) | (newValue.at(1) << 8) | newValue.at(0);
-            index += 3;
-
-            if (!Flags.moreData) {
-                if (!settings.value(QZSettings::speed_power_based, QZSettings::default_speed_power_based).toBool()) {
-                    Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                      (uint16_t)((uint8_t)newValue.at(index)))) /
-                            100.0;
-                } else {
-                    Speed = metric::calculateSpeedFromPower(watts(), Inclination.value(), Speed.value(),fabs(QDateTime::currentDateTime().msecsTo(Speed.lastChanged()) / 1000.0),  this->speedLimit());
-                }
-                emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
-                index += 2;
-            }
-
-            if (Flags.avgSpeed) {
-                double avgSpeed;
-                avgSpeed =
-                    ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
-                index += 2;
-                emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
-            }
-
-            if (Flags.totDistance) {
-                Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                                      (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                     (uint32_t)((uint8_t)newValue.at(index)))) /
-                           1000.0;
-                index += 3;
-            } else {
-                Distance += ((Speed.value() / 3600000.0) *
-                             ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
-            }
-
-            emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
-
-            if (Flags.stepCount) {
-                if (settings.value(QZSettings::cadence_sensor_name, QZSettings::default_cadence_sensor_name)
-                        .toString()
-                        .startsWith(QStringLiteral("Disabled"))) {
-                    Cadence = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index))));
-                }
-                emit debug(QStringLiteral("Current Cadence: ") + QString::number(Cadence.value()));
-
-                index += 2;
-                index += 2;
-            }
-
-            if (Flags.strideCount) {
-                index += 2;
-            }
-
-            if (Flags.elevationGain) {
-                index += 2;
-                index += 2;
-            }
-
-            if (Flags.rampAngle) {
-                index += 2;
-                index += 2;
-            }
-
-            if (Flags.resistanceLvl) {
-                Resistance =
-                    ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-                emit resistanceRead(Resistance.value());
-                index += 2;
-                emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
-            } else {
-                double ac = 0.01243107769;
-                double bc = 1.145964912;
-                double cc = -23.50977444;
-
-                double ar = 0.1469553975;
-                double br = -5.841344538;
-                double cr = 97.62165482;
-
-                if (Cadence.value() && m_watt.value()) {
-                    m_pelotonResistance =
-                        (((sqrt(pow(br, 2.0) - 4.0 * ar *
-                                                   (cr - (m_watt.value() * 132.0 /
-                                                          (ac * pow(Cadence.value(), 2.0) + bc * Cadence.value() + cc)))) -
-                           br) /
-                          (2.0 * ar)) *
-                         settings.value(QZSettings::peloton_gain, QZSettings::default_peloton_gain).toDouble()) +
-                        settings.value(QZSettings::peloton_offset, QZSettings::default_peloton_offset).toDouble();
-                    Resistance = m_pelotonResistance;
-                    emit resistanceRead(Resistance.value());
-                }
-            }
-
-            if (Flags.instantPower) {
-                if (settings.value(QZSettings::power_sensor_name, QZSettings::default_power_sensor_name)
-                        .toString()
-                        .startsWith(QStringLiteral("Disabled")))
-                    m_watt = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                       (uint16_t)((uint8_t)newValue.at(index))));
-                emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
-                index += 2;
-            }
-
-            if (Flags.avgPower) {
-                double avgPower;
-                avgPower =
-                    ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-                emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
-                index += 2;
-            }
-
-            if (Flags.expEnergy && newValue.length() > index + 1) {
-                KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-                index += 2;
-
-                // energy per hour
-                index += 2;
-
-                // energy per minute
-                index += 1;
-            } else {
-                if (watts())
-                    KCal +=
-                        ((((0.048 * ((double)watts()) + 1.19) * settings.value(QZSettings::weight, QZSettings::default_weight).toFloat() *
-                           3.5) /
-                          200.0) /
-                         (60000.0 / ((double)lastRefreshCharacteristicChanged.msecsTo(
-                                        QDateTime::currentDateTime())))); //(( (0.048* Output in watts +1.19) * body weight in
-                                                                          // kg * 3.5) / 200 ) / 60
-            }
-
-            emit debug(QStringLiteral("Current KCal: ") + QString::number(KCal.value()));
-
-#ifdef Q_OS_ANDROID
-            if (settings.value(QZSettings::ant_heart, QZSettings::default_ant_heart).toBool())
-                Heart = (uint8_t)KeepAwakeHelper::heart();
-            else
-#endif
-            {
-                if (Flags.heartRate && !disable_hr_frommachinery && newValue.length() > index) {
-                    Heart = ((double)((newValue.at(index))));
-                    // index += 1; // NOTE: clang-analyzer-deadcode.DeadStores
-                    emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-                } else {
-                    Flags.heartRate = false;
-                }
-                heart = Flags.heartRate;
-            }
-
-            if (Flags.metabolicEq) {
-                // todo
-            }
-
-            if (Flags.elapsedTime) {
-                // todo
-            }
-
-            if (Flags.remainingTime) {
-                // todo
-            }
     } else {
         return;
     }
@@ -571,10 +332,10 @@ void ftmsbike::characteristicChanged(const QLowEnergyCharacteristic &characteris
 #endif
 #endif
 
-    emit debug(QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
-    emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Current CrankRevs: ") + QString::number(CrankRevs));
+    qzEmitDebug(qzDeviceMetrics, QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
 
-    if (m_control->error() != QLowEnergyController::NoError) {
+    if (m_control && m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
     }
 }
@@ -598,6 +359,19 @@ void ftmsbike::stateChanged(QLowEnergyService::ServiceState state) {
 
     qDebug() << QStringLiteral("all services discovered!");
 
+    if (!gattCache.validate(gattCommunicationChannelService)) {
+        // the cached layout does not match the peripheral anymore: discover the services it skipped
+        auto services_list = gattcache::remaining(m_control->services(), gattCommunicationChannelService);
+        for (const QBluetoothUuid &s : qAsConst(services_list)) {
+            gattCommunicationChannelService.append(m_control->createServiceObject(s));
+            connect(gattCommunicationChannelService.constLast(), &QLowEnergyService::stateChanged, this,
+                    &ftmsbike::stateChanged);
+            gattCommunicationChannelService.constLast()->discoverDetails();
+        }
+        if (!services_list.isEmpty())
+            return;
+    }
+
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
         if (s->state() == QLowEnergyService::ServiceDiscovered) {
             // establish hook into notifications
@@ -659,6 +433,7 @@ void ftmsbike::stateChanged(QLowEnergyService::ServiceState state) {
                     qDebug() << QStringLiteral("FTMS service and Control Point found");
                     gattWriteCharControlPointId = c;
                     gattFTMSService = s;
+                    gattCache.use(s->serviceUuid());
                 }
             }
         }
@@ -715,6 +490,7 @@ void ftmsbike::ftmsCharacteristicChanged(const QLowEnergyCharacteristic &charact
         }
 
         gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, b);
+        latencytrace::mark(latencytrace::COMMAND_WRITTEN);
     }
 }
 
@@ -750,7 +526,7 @@ void ftmsbike::serviceScanDone(void) {
 #endif
 
     initRequest = false;
-    auto services_list = m_control->services();
+    auto services_list = gattCache.services(m_control->services());
     for (const QBluetoothUuid &s : qAsConst(services_list)) {
         gattCommunicationChannelService.append(m_control->createServiceObject(s));
         connect(gattCommunicationChannelService.constLast(), &QLowEnergyService::stateChanged, this,
@@ -783,6 +559,7 @@ void ftmsbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
             max_resistance = 16;
         }
 
+        gattCache.setDevice(bluetoothDevice);
         m_control = QLowEnergyController::createCentral(bluetoothDevice, this);
         connect(m_control, &QLowEnergyController::serviceDiscovered, this, &ftmsbike::serviceDiscovered);
         connect(m_control, &QLowEnergyController::discoveryFinished, this, &ftmsbike::serviceScanDone);
@@ -811,6 +588,7 @@ void ftmsbike::deviceDiscovered(const QBluetoothDeviceInfo &device) {
         });
 
         // Connect
+        gattCache.connecting();
         m_control->connectToDevice();
         return;
     }
@@ -840,6 +618,7 @@ void ftmsbike::controllerStateChanged(QLowEnergyController::ControllerState stat
     if (state == QLowEnergyController::UnconnectedState && m_control) {
         qDebug() << QStringLiteral("trying to connect back again...");
         initDone = false;
+        gattCache.connecting();
         m_control->connectToDevice();
     }
 }
@@ -27,6 +27,8 @@
 #include <QString>
 
 #include "bike.h"
+#include "commandslot.h"
+#include "gattcache.h"
 #include "virtualbike.h"
 
 #ifdef Q_OS_IOS
@@ -92,6 +94,10 @@ class ftmsbike : public bike {
     QList<QLowEnergyService *> gattCommunicationChannelService;
     QLowEnergyCharacteristic gattWriteCharControlPointId;
     QLowEnergyService *gattFTMSService;
+    gattcache gattCache;
+    // no deadband on power: the same target is written again on purpose when zwift stops sending it
+    commandslot powerSlot{"power", 500};
+    commandslot resistanceSlot{"resistance", 500, 1};
 
     uint8_t sec1Update = 0;
     QByteArray lastPacket;
@@ -117,6 +123,11 @@ class ftmsbike : public bike {
 
   public slots:
     void deviceDiscovered(const QBluetoothDeviceInfo &device);
+    /**
+     * @brief parseNotification Decodes a notification of the characteristic uuid. characteristicChanged forwards
+     * here, the btsnoop replay tool (src/test/btsnoop-replay) calls it directly with recorded packets.
+     */
+    void parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue);
 
   private slots:
 
@@ -0,0 +1,170 @@
+#include "ftmsdata.h"
+
+namespace {
+
+enum encoding : quint8 { U8, U16, S16, U24 };
+
+struct fieldspec {
+    ftmsdata::field field;
+    encoding type;
+    double scale;
+    double ftmsdata::*member;
+};
+
+// the fields a flag bit announces, in the order they follow each other in the packet.
+// Bit 0 ("more data") is inverted: its fields are present when the bit is clear.
+struct flagspec {
+    quint8 bit;
+    quint8 count;
+    fieldspec fields[3];
+};
+
+#define FIELD(f, type, scale, member) {ftmsdata::f, type, scale, &ftmsdata::member}
+
+const flagspec indoorBikeData[] = {
+    {0, 1, {FIELD(FIELD_SPEED, U16, 0.01, speed)}},
+    {1, 1, {FIELD(FIELD_AVERAGE_SPEED, U16, 0.01, averageSpeed)}},
+    {2, 1, {FIELD(FIELD_CADENCE, U16, 0.5, cadence)}},
+    {3, 1, {FIELD(FIELD_AVERAGE_CADENCE, U16, 0.5, averageCadence)}},
+    {4, 1, {FIELD(FIELD_DISTANCE, U24, 1, distance)}},
+    {5, 1, {FIELD(FIELD_RESISTANCE, S16, 1, resistance)}},
+    {6, 1, {FIELD(FIELD_POWER, S16, 1, power)}},
+    {7, 1, {FIELD(FIELD_AVERAGE_POWER, S16, 1, averagePower)}},
+    {8,
+     3,
+     {FIELD(FIELD_ENERGY, U16, 1, energy), FIELD(FIELD_ENERGY_PER_HOUR, U16, 1, energyPerHour),
+      FIELD(FIELD_ENERGY_PER_MINUTE, U8, 1, energyPerMinute)}},
+    {9, 1, {FIELD(FIELD_HEART, U8, 1, heart)}},
+    {10, 1, {FIELD(FIELD_METABOLIC_EQUIVALENT, U8, 0.1, metabolicEquivalent)}},
+    {11, 1, {FIELD(FIELD_ELAPSED_TIME, U16, 1, elapsedTime)}},
+    {12, 1, {FIELD(FIELD_REMAINING_TIME, U16, 1, remainingTime)}},
+};
+
+const flagspec treadmillData[] = {
+    {0, 1, {FIELD(FIELD_SPEED, U16, 0.01, speed)}},
+    {1, 1, {FIELD(FIELD_AVERAGE_SPEED, U16, 0.01, averageSpeed)}},
+    {2, 1, {FIELD(FIELD_DISTANCE, U24, 1, distance)}},
+    {3, 2, {FIELD(FIELD_INCLINATION, S16, 0.1, inclination), FIELD(FIELD_RAMP_ANGLE, S16, 0.1, rampAngle)}},
+    {4,
+     2,
+     {FIELD(FIELD_ELEVATION_GAIN, U16, 0.1, positiveElevationGain),
+      FIELD(FIELD_ELEVATION_GAIN, U16, 0.1, negativeElevationGain)}},
+    {5, 1, {FIELD(FIELD_PACE, U8, 0.1, pace)}},
+    {6, 1, {FIELD(FIELD_AVERAGE_PACE, U8, 0.1, averagePace)}},
+    {7,
+     3,
+     {FIELD(FIELD_ENERGY, U16, 1, energy), FIELD(FIELD_ENERGY_PER_HOUR, U16, 1, energyPerHour),
+      FIELD(FIELD_ENERGY_PER_MINUTE, U8, 1, energyPerMinute)}},
+    {8, 1, {FIELD(FIELD_HEART, U8, 1, heart)}},
+    {9, 1, {FIELD(FIELD_METABOLIC_EQUIVALENT, U8, 0.1, metabolicEquivalent)}},
+    {10, 1, {FIELD(FIELD_ELAPSED_TIME, U16, 1, elapsedTime)}},
+    {11, 1, {FIELD(FIELD_REMAINING_TIME, U16, 1, remainingTime)}},
+    {12, 2, {FIELD(FIELD_FORCE_ON_BELT, S16, 1, forceOnBelt), FIELD(FIELD_POWER_OUTPUT, S16, 1, powerOutput)}},
+};
+
+const flagspec rowerData[] = {
+    {0, 2, {FIELD(FIELD_CADENCE, U8, 0.5, cadence), FIELD(FIELD_STROKE_COUNT, U16, 1, strokeCount)}},
+    {1, 1, {FIELD(FIELD_AVERAGE_CADENCE, U8, 0.5, averageCadence)}},
+    {2, 1, {FIELD(FIELD_DISTANCE, U24, 1, distance)}},
+    {3, 1, {FIELD(FIELD_PACE, U16, 1, pace)}},
+    {4, 1, {FIELD(FIELD_AVERAGE_PACE, U16, 1, averagePace)}},
+    {5, 1, {FIELD(FIELD_POWER, S16, 1, power)}},
+    {6, 1, {FIELD(FIELD_AVERAGE_POWER, S16, 1, averagePower)}},
+    {7, 1, {FIELD(FIELD_RESISTANCE, S16, 1, resistance)}},
+    {8,
+     3,
+     {FIELD(FIELD_ENERGY, U16, 1, energy), FIELD(FIELD_ENERGY_PER_HOUR, U16, 1, energyPerHour),
+      FIELD(FIELD_ENERGY_PER_MINUTE, U8, 1, energyPerMinute)}},
+    {9, 1, {FIELD(FIELD_HEART, U8, 1, heart)}},
+    {10, 1, {FIELD(FIELD_METABOLIC_EQUIVALENT, U8, 0.1, metabolicEquivalent)}},
+    {11, 1, {FIELD(FIELD_ELAPSED_TIME, U16, 1, elapsedTime)}},
+    {12, 1, {FIELD(FIELD_REMAINING_TIME, U16, 1, remainingTime)}},
+};
+
+const flagspec crossTrainerData[] = {
+    {0, 1, {FIELD(FIELD_SPEED, U16, 0.01, speed)}},
+    {1, 1, {FIELD(FIELD_AVERAGE_SPEED, U16, 0.01, averageSpeed)}},
+    {2, 1, {FIELD(FIELD_DISTANCE, U24, 1, distance)}},
+    {3, 2, {FIELD(FIELD_CADENCE, U16, 1, cadence), FIELD(FIELD_AVERAGE_CADENCE, U16, 1, averageCadence)}},
+    {4, 1, {FIELD(FIELD_STRIDE_COUNT, U16, 0.1, strideCount)}},
+    {5,
+     2,
+     {FIELD(FIELD_ELEVATION_GAIN, U16, 1, positiveElevationGain),
+      FIELD(FIELD_ELEVATION_GAIN, U16, 1, negativeElevationGain)}},
+    {6, 2, {FIELD(FIELD_INCLINATION, S16, 0.1, inclination), FIELD(FIELD_RAMP_ANGLE, S16, 0.1, rampAngle)}},
+    {7, 1, {FIELD(FIELD_RESISTANCE, S16, 1, resistance)}},
+    {8, 1, {FIELD(FIELD_POWER, S16, 1, power)}},
+    {9, 1, {FIELD(FIELD_AVERAGE_POWER, S16, 1, averagePower)}},
+    {10,
+     3,
+     {FIELD(FIELD_ENERGY, U16, 1, energy), FIELD(FIELD_ENERGY_PER_HOUR, U16, 1, energyPerHour),
+      FIELD(FIELD_ENERGY_PER_MINUTE, U8, 1, energyPerMinute)}},
+    {11, 1, {FIELD(FIELD_HEART, U8, 1, heart)}},
+    {12, 1, {FIELD(FIELD_METABOLIC_EQUIVALENT, U8, 0.1, metabolicEquivalent)}},
+    {13, 1, {FIELD(FIELD_ELAPSED_TIME, U16, 1, elapsedTime)}},
+    {14, 1, {FIELD(FIELD_REMAINING_TIME, U16, 1, remainingTime)}},
+};
+
+#undef FIELD
+
+const int encodingSize[] = {1, 2, 2, 3};
+
+template <size_t N> bool walk(const flagspec (&table)[N], const uint8_t *data, int length, int index, ftmsdata &out) {
+    for (const flagspec &f : table) {
+        const bool set = out.flags & (1u << f.bit);
+        if (f.bit == 0 ? set : !set)
+            continue;
+        for (int i = 0; i < f.count; i++) {
+            const fieldspec &s = f.fields[i];
+            if (index + encodingSize[s.type] > length)
+                return false;
+            const uint8_t *p = data + index;
+            double v = 0;
+            switch (s.type) {
+            case U8:
+                v = p[0];
+                break;
+            case U16:
+                v = (quint16)(p[0] | (p[1] << 8));
+                break;
+            case S16:
+                v = (qint16)(p[0] | (p[1] << 8));
+                break;
+            case U24:
+                v = (quint32)(p[0] | (p[1] << 8) | (p[2] << 16));
+                break;
+            }
+            out.*(s.member) = v * s.scale;
+            out.present |= s.field;
+            index += encodingSize[s.type];
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool ftmsdata::decode(characteristic type, const uint8_t *data, int length) {
+    present = 0;
+    flags = 0;
+    backward = false;
+
+    const int flagsSize = type == CROSS_TRAINER_DATA ? 3 : 2;
+    if (length < flagsSize)
+        return false;
+    for (int i = 0; i < flagsSize; i++)
+        flags |= (quint32)data[i] << (8 * i);
+
+    switch (type) {
+    case INDOOR_BIKE_DATA:
+        return walk(indoorBikeData, data, length, flagsSize, *this);
+    case TREADMILL_DATA:
+        return walk(treadmillData, data, length, flagsSize, *this);
+    case ROWER_DATA:
+        return walk(rowerData, data, length, flagsSize, *this);
+    case CROSS_TRAINER_DATA:
+        backward = flags & (1u << 15);
+        return walk(crossTrainerData, data, length, flagsSize, *this);
+    }
+    return false;
+}
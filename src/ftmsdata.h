@@ -0,0 +1,93 @@
+#ifndef FTMSDATA_H
+#define FTMSDATA_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @brief The ftmsdata class decodes the FTMS data characteristics (Indoor Bike, Treadmill, Rower and Cross
+ * Trainer Data). The flag word is walked once over the raw bytes, following one table per characteristic, and
+ * every field the flags announce is stored in the matching member, in the units below, with its FIELD_ bit set
+ * in present. Members whose bit is not set are stale: check has() first.
+ * Values are decoded as the specification says; the quirks of a given machine are up to its driver.
+ */
+class ftmsdata {
+  public:
+    enum characteristic : quint16 {
+        TREADMILL_DATA = 0x2ACD,
+        CROSS_TRAINER_DATA = 0x2ACE,
+        ROWER_DATA = 0x2AD1,
+        INDOOR_BIKE_DATA = 0x2AD2,
+    };
+
+    enum field : quint32 {
+        FIELD_SPEED = 1 << 0,
+        FIELD_AVERAGE_SPEED = 1 << 1,
+        FIELD_CADENCE = 1 << 2,
+        FIELD_AVERAGE_CADENCE = 1 << 3,
+        FIELD_STROKE_COUNT = 1 << 4,
+        FIELD_STRIDE_COUNT = 1 << 5,
+        FIELD_DISTANCE = 1 << 6,
+        FIELD_INCLINATION = 1 << 7,
+        FIELD_RAMP_ANGLE = 1 << 8,
+        FIELD_ELEVATION_GAIN = 1 << 9,
+        FIELD_PACE = 1 << 10,
+        FIELD_AVERAGE_PACE = 1 << 11,
+        FIELD_RESISTANCE = 1 << 12,
+        FIELD_POWER = 1 << 13,
+        FIELD_AVERAGE_POWER = 1 << 14,
+        FIELD_ENERGY = 1 << 15,
+        FIELD_ENERGY_PER_HOUR = 1 << 16,
+        FIELD_ENERGY_PER_MINUTE = 1 << 17,
+        FIELD_HEART = 1 << 18,
+        FIELD_METABOLIC_EQUIVALENT = 1 << 19,
+        FIELD_ELAPSED_TIME = 1 << 20,
+        FIELD_REMAINING_TIME = 1 << 21,
+        FIELD_FORCE_ON_BELT = 1 << 22,
+        FIELD_POWER_OUTPUT = 1 << 23,
+    };
+
+    /**
+     * @brief decode Decodes one notification of the given characteristic.
+     * @return false if the packet is shorter than its flags say (the fields before the end are still decoded)
+     * or the characteristic is unknown.
+     */
+    bool decode(characteristic type, const uint8_t *data, int length);
+    bool decode(characteristic type, const QByteArray &value) {
+        return decode(type, reinterpret_cast<const uint8_t *>(value.constData()), value.size());
+    }
+
+    bool has(field f) const { return present & f; }
+
+    quint32 flags = 0;   // the flag word as received
+    quint32 present = 0; // FIELD_ bits of the members decoded from the last packet
+
+    double speed = 0;          // km/h
+    double averageSpeed = 0;   // km/h
+    double cadence = 0;        // rpm for bikes, strokes/min for rowers, steps/min for cross trainers
+    double averageCadence = 0; // same unit as cadence
+    double strokeCount = 0;
+    double strideCount = 0;
+    double distance = 0;              // m
+    double inclination = 0;           // %
+    double rampAngle = 0;             // degrees
+    double positiveElevationGain = 0; // m
+    double negativeElevationGain = 0; // m
+    double pace = 0;                  // km/min for treadmills, s/500m for rowers
+    double averagePace = 0;
+    double resistance = 0; // raw level, the resolution depends on the machine
+    double power = 0;      // W
+    double averagePower = 0;
+    double energy = 0;        // kcal
+    double energyPerHour = 0; // kcal
+    double energyPerMinute = 0;
+    double heart = 0; // bpm
+    double metabolicEquivalent = 0;
+    double elapsedTime = 0;   // s
+    double remainingTime = 0; // s
+    double forceOnBelt = 0;   // N
+    double powerOutput = 0;   // W
+    bool backward = false;    // cross trainer movement direction
+};
+
+#endif // FTMSDATA_H
@@ -1,5 +1,7 @@
 #include "ftmsrower.h"
+#include "qzsettingscache.h"
 #include "ftmsbike.h"
+#include "ftmsdata.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -136,60 +138,34 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
 
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     bool disable_hr_frommachinery = settings.value(QZSettings::heart_ignore_builtin, QZSettings::default_heart_ignore_builtin).toBool();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
     qDebug() << QStringLiteral(" << ") << characteristic.uuid() << " " << newValue.toHex(' ');
 
-    if (characteristic.uuid() != QBluetoothUuid((quint16)0x2AD1)) {
+    if (characteristic.uuid() != QBluetoothUuid((quint16)ftmsdata::ROWER_DATA)) {
         return;
     }
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-
-            uint16_t moreData : 1;
-            uint16_t avgStroke : 1;
-            uint16_t totDistance : 1;
-            uint16_t instantPace : 1;
-            uint16_t avgPace : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    double cadence_divider = 2.0;
-    if (WHIPR)
-        cadence_divider = 1.0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
-
-        Cadence = ((uint8_t)newValue.at(index)) / cadence_divider;
-        StrokesCount =
-            (((uint16_t)((uint8_t)newValue.at(index + 2)) << 8) | (uint16_t)((uint8_t)newValue.at(index + 1)));
-
-        index += 3;
+    ftmsdata data;
+    if (!data.decode(ftmsdata::ROWER_DATA, newValue))
+        emit debug(QStringLiteral("FTMS packet shorter than its flags"));
+
+    // the stroke rate has a resolution of 0.5, except on the WHIPR that sends it in strokes/min
+    const double cadence_multiplier = WHIPR ? 2.0 : 1.0;
+
+    if (data.has(ftmsdata::FIELD_CADENCE)) {
+
+        Cadence = data.cadence * cadence_multiplier;
+        StrokesCount = data.strokeCount;
 
         /*
          * the concept 2 sends the pace in 2 frames, so this condition will create a bugus speed
-        if (!Flags.instantPace) {
+        if (!data.has(ftmsdata::FIELD_PACE)) {
             // eredited by echelon rower, probably we need to change this
             Speed = (0.37497622 * ((double)Cadence.value())) / 2.0;
             emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
@@ -197,20 +173,13 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
         emit debug(QStringLiteral("Strokes Count: ") + QString::number(StrokesCount.value()));
     }
 
-    if (Flags.avgStroke) {
-
-        double avgStroke;
-        avgStroke = ((double)(uint16_t)((uint8_t)newValue.at(index))) / cadence_divider;
-        index += 1;
-        emit debug(QStringLiteral("Current Average Stroke: ") + QString::number(avgStroke));
+    if (data.has(ftmsdata::FIELD_AVERAGE_CADENCE)) {
+        emit debug(QStringLiteral("Current Average Stroke: ") +
+                   QString::number(data.averageCadence * cadence_multiplier));
     }
 
-    if (Flags.totDistance) {
-        Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;
-        index += 3;
+    if (data.has(ftmsdata::FIELD_DISTANCE)) {
+        Distance = data.distance / 1000.0;
     } else {
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
@@ -218,64 +187,37 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
 
     emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-    if (Flags.instantPace) {
-
-        double instantPace;
-        instantPace =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Pace: ") + QString::number(instantPace));
+    if (data.has(ftmsdata::FIELD_PACE)) {
+        emit debug(QStringLiteral("Current Pace: ") + QString::number(data.pace));
 
-        Speed = (60.0 / instantPace) *
+        Speed = (60.0 / data.pace) *
                 30.0; // translating pace (min/500m) to km/h in order to match the pace function in the rower.cpp
         emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
     }
 
-    if (Flags.avgPace) {
-
-        double avgPace;
-        avgPace =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Pace: ") + QString::number(avgPace));
+    if (data.has(ftmsdata::FIELD_AVERAGE_PACE)) {
+        emit debug(QStringLiteral("Current Average Pace: ") + QString::number(data.averagePace));
     }
 
-    if (Flags.instantPower) {
-        double watt =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        if (!filterWattNull || watt != 0) {
-            m_watt = watt;
+    if (data.has(ftmsdata::FIELD_POWER)) {
+        if (!filterWattNull || data.power != 0) {
+            m_watt = data.power;
         }
         emit debug(QStringLiteral("Current Watt: ") + QString::number(m_watt.value()));
     }
 
-    if (Flags.avgPower) {
-
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(avgPower));
+    if (data.has(ftmsdata::FIELD_AVERAGE_POWER)) {
+        emit debug(QStringLiteral("Current Average Watt: ") + QString::number(data.averagePower));
     }
 
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+    if (data.has(ftmsdata::FIELD_RESISTANCE)) {
+        Resistance = data.resistance;
         emit resistanceRead(Resistance.value());
-        index += 2;
         emit debug(QStringLiteral("Current Resistance: ") + QString::number(Resistance.value()));
     }
 
-    if (Flags.expEnergy && index + 1 < newValue.length()) {
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (data.has(ftmsdata::FIELD_ENERGY)) {
+        KCal = data.energy;
     } else {
         if (watts())
             KCal +=
@@ -295,31 +237,12 @@ void ftmsrower::characteristicChanged(const QLowEnergyCharacteristic &characteri
     else
 #endif
     {
-        if (Flags.heartRate && !disable_hr_frommachinery) {
-            if (index < newValue.length()) {
-                Heart = ((double)((newValue.at(index))));
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
-                emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
-            } else
-                emit debug(QStringLiteral("Error on parsing heart"));
+        if (data.has(ftmsdata::FIELD_HEART) && !disable_hr_frommachinery) {
+            Heart = data.heart;
+            emit debug(QStringLiteral("Current Heart: ") + QString::number(Heart.value()));
         }
     }
 
-    if (Flags.metabolic) {
-
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-
-        // todo
-    }
-
     if (Cadence.value() > 0) {
 
         CrankRevs++;
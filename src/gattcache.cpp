@@ -0,0 +1,204 @@
+#include "gattcache.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QRegExp>
+#include <QSettings>
+
+static const QString group = QStringLiteral("gatt_cache/");
+
+// The layouts live in a file of their own (gattcache.ini next to the settings): they are rewritten on connections,
+// which must not trigger a QZSettingsCache reload, and they have nothing to do in a settings export.
+class gattstore : public QSettings {
+  public:
+    gattstore()
+        : QSettings(QSettings::IniFormat, QSettings::UserScope, QCoreApplication::organizationName(),
+                    QStringLiteral("gattcache")) {}
+};
+
+// the versions that kept the layouts in the main settings: drop them there, once
+static void dropLegacyEntries() {
+    static bool done = false;
+    if (done)
+        return;
+    done = true;
+    QSettings settings;
+    if (settings.childGroups().contains(QStringLiteral("gatt_cache")))
+        settings.remove(QStringLiteral("gatt_cache"));
+}
+
+void gattcache::setDevice(const QBluetoothDeviceInfo &device) {
+#if defined(Q_OS_IOS)
+    key = device.deviceUuid().toString();
+#else
+    key = device.address().toString();
+#endif
+    key.remove(QRegExp(QStringLiteral("[^0-9A-Za-z]")));
+    load();
+}
+
+void gattcache::load() {
+    m_services.clear();
+    m_live.clear();
+    m_notifications.clear();
+    m_fastConnections = 0;
+    if (key.isEmpty())
+        return;
+
+    dropLegacyEntries();
+    gattstore settings;
+    const QStringList services = settings.value(group + key + QStringLiteral("/services")).toStringList();
+    for (const QString &s : services)
+        m_services.append(QBluetoothUuid(s));
+    const QStringList live = settings.value(group + key + QStringLiteral("/live")).toStringList();
+    for (const QString &s : live)
+        m_live.append(QBluetoothUuid(s));
+    m_fastConnections = settings.value(group + key + QStringLiteral("/fast_connections")).toInt();
+    const QStringList notifications = settings.value(group + key + QStringLiteral("/notifications")).toStringList();
+    for (const QString &n : notifications) {
+        const QStringList pair = n.split(QLatin1Char(' '));
+        if (pair.size() == 2)
+            m_notifications.append({QBluetoothUuid(pair.at(0)), QBluetoothUuid(pair.at(1))});
+    }
+}
+
+void gattcache::save() {
+    if (key.isEmpty())
+        return;
+
+    QStringList services;
+    for (const QBluetoothUuid &s : qAsConst(m_services))
+        services.append(s.toString());
+    QStringList live;
+    for (const QBluetoothUuid &s : qAsConst(m_live))
+        live.append(s.toString());
+    QStringList notifications;
+    for (const auto &n : qAsConst(m_notifications))
+        notifications.append(n.first.toString() + QLatin1Char(' ') + n.second.toString());
+
+    gattstore settings;
+    settings.setValue(group + key + QStringLiteral("/services"), services);
+    settings.setValue(group + key + QStringLiteral("/live"), live);
+    settings.setValue(group + key + QStringLiteral("/fast_connections"), m_fastConnections);
+    settings.setValue(group + key + QStringLiteral("/notifications"), notifications);
+}
+
+void gattcache::invalidate() {
+    qDebug() << QStringLiteral("gattcache: dropping the layout of") << key;
+    m_services.clear();
+    m_live.clear();
+    m_notifications.clear();
+    m_fastConnections = 0;
+    m_fast = false;
+    if (!key.isEmpty()) {
+        gattstore settings;
+        settings.remove(group + key);
+    }
+}
+
+void gattcache::connecting() {
+    if (m_fast && !m_metric) {
+        // the cached layout did not bring a single metric: something else was needed
+        invalidate();
+    }
+    m_fast = false;
+    m_metric = false;
+    connectTimer.start();
+}
+
+QList<QBluetoothUuid> gattcache::services(const QList<QBluetoothUuid> &live) {
+    m_fast = !m_notifications.isEmpty() && m_fastConnections < FULL_DISCOVERY_EVERY;
+    for (const QBluetoothUuid &s : qAsConst(m_services)) {
+        if (!live.contains(s)) {
+            m_fast = false;
+            break;
+        }
+    }
+    for (const QBluetoothUuid &s : live) {
+        if (!m_fast)
+            break;
+        if (!m_live.contains(s)) {
+            // a service appeared since the layout was learned (firmware update, other mode): the driver may need it
+            qDebug() << QStringLiteral("gattcache:") << s << QStringLiteral("was not advertised before");
+            m_fast = false;
+        }
+    }
+    qDebug() << QStringLiteral("gattcache:")
+             << (m_fast ? QStringLiteral("cached layout,") : QStringLiteral("full discovery,"))
+             << (m_fast ? m_services.size() : live.size()) << QStringLiteral("of") << live.size()
+             << QStringLiteral("services,") << m_fastConnections << QStringLiteral("cached connections");
+
+    if (m_fast) {
+        m_fastConnections++;
+    } else {
+        // relearn the layout from this connection
+        m_services.clear();
+        m_notifications.clear();
+        m_live = live;
+        m_fastConnections = 0;
+    }
+    save();
+    return m_fast ? m_services : live;
+}
+
+bool gattcache::validate(const QList<QLowEnergyService *> &discovered) {
+    if (!m_fast)
+        return true;
+    for (const auto &n : qAsConst(m_notifications)) {
+        bool found = false;
+        for (QLowEnergyService *s : discovered) {
+            if (s->serviceUuid() == n.first && s->characteristic(n.second).isValid()) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            qDebug() << QStringLiteral("gattcache:") << n.second << QStringLiteral("not found in") << n.first;
+            invalidate();
+            return false;
+        }
+    }
+    return true;
+}
+
+QList<QBluetoothUuid> gattcache::remaining(const QList<QBluetoothUuid> &live,
+                                           const QList<QLowEnergyService *> &discovered) {
+    QList<QBluetoothUuid> r;
+    for (const QBluetoothUuid &u : live) {
+        bool created = false;
+        for (QLowEnergyService *s : discovered) {
+            if (s->serviceUuid() == u && s->state() != QLowEnergyService::InvalidService) {
+                created = true;
+                break;
+            }
+        }
+        if (!created)
+            r.append(u);
+    }
+    return r;
+}
+
+void gattcache::use(const QBluetoothUuid &service) {
+    if (!m_services.contains(service)) {
+        m_services.append(service);
+        if (!m_notifications.isEmpty())
+            save();
+    }
+}
+
+void gattcache::notified(const QBluetoothUuid &service, const QBluetoothUuid &characteristic) {
+    if (!m_metric) {
+        m_metric = true;
+        qDebug() << QStringLiteral("gattcache: first metric") << connectTimer.elapsed()
+                 << QStringLiteral("ms after connecting,")
+                 << (m_fast ? QStringLiteral("cached layout") : QStringLiteral("full discovery"));
+    }
+
+    const QPair<QBluetoothUuid, QBluetoothUuid> n(service, characteristic);
+    if (m_notifications.contains(n))
+        return;
+    m_notifications.append(n);
+    if (!m_services.contains(service))
+        m_services.append(service);
+    save();
+}
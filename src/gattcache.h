@@ -0,0 +1,82 @@
+#ifndef GATTCACHE_H
+#define GATTCACHE_H
+
+#include <QBluetoothDeviceInfo>
+#include <QBluetoothUuid>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+#include <QtBluetooth/qlowenergyservice.h>
+
+/**
+ * @brief The gattcache class remembers, per device address, the services a driver actually used on the last
+ * connection (the ones that delivered notifications and the ones it writes to) and the characteristics that
+ * notified. On the next connection the driver discovers the details of those services only, instead of every
+ * service of the peripheral, which is what takes seconds on some trainers.
+ * The layout is validated against the live peripheral: the cached services must be advertised, the peripheral must
+ * not advertise a service that was not there at the last full discovery, and the cached characteristics must be
+ * found in the services, otherwise the driver falls back to a full discovery and the entry is rebuilt.
+ * Services are learned only from notifications and use(), so one the driver needs silently would be missed:
+ * every FULL_DISCOVERY_EVERY connections the layout is rebuilt from a full discovery anyway.
+ * A cached connection that delivers no metric is dropped on the next connection attempt.
+ * The time from connectToDevice() to the first notification is logged, with the path that was taken.
+ */
+class gattcache {
+  public:
+    static const int FULL_DISCOVERY_EVERY = 10;
+
+    void setDevice(const QBluetoothDeviceInfo &device);
+
+    /**
+     * @brief connecting To call right before connectToDevice(), starts the time to first metric.
+     */
+    void connecting();
+
+    /**
+     * @brief services The services to discover: the cached ones if the peripheral advertises all of them and
+     * nothing new (fast path), otherwise every live service, and the entry is rebuilt from this connection.
+     */
+    QList<QBluetoothUuid> services(const QList<QBluetoothUuid> &live);
+    bool fast() const { return m_fast; }
+
+    /**
+     * @brief validate On the fast path, checks that every cached characteristic exists in the discovered
+     * services. On failure the entry is dropped and the caller discovers the remaining services.
+     */
+    bool validate(const QList<QLowEnergyService *> &discovered);
+
+    /**
+     * @brief remaining The live services that have no service object in discovered yet.
+     */
+    static QList<QBluetoothUuid> remaining(const QList<QBluetoothUuid> &live,
+                                           const QList<QLowEnergyService *> &discovered);
+
+    /**
+     * @brief use Marks a service the driver needs even if it never notifies, e.g. the one it writes to.
+     */
+    void use(const QBluetoothUuid &service);
+
+    /**
+     * @brief notified To call on every notification: logs the first one and records new characteristics.
+     */
+    void notified(const QBluetoothUuid &service, const QBluetoothUuid &characteristic);
+
+    void invalidate();
+
+  private:
+    void load();
+    void save();
+
+    QString key;
+    QList<QBluetoothUuid> m_services;
+    QList<QBluetoothUuid> m_live; // every service advertised at the last full discovery
+    int m_fastConnections = 0;    // since the last full discovery
+    QList<QPair<QBluetoothUuid, QBluetoothUuid>> m_notifications;
+    QElapsedTimer connectTimer;
+    bool m_fast = false;
+    bool m_metric = false;
+};
+
+#endif // GATTCACHE_H
@@ -118,7 +118,7 @@ QList<gpx_altitude_point_for_treadmill> gpx::open(const QString &gpx) {
     return inclinationList;
 }
 
-void gpx::save(const QString &filename, QList<SessionLine> session, bluetoothdevice::BLUETOOTH_TYPE type) {
+void gpx::save(const QString &filename, const sessionstore &session, bluetoothdevice::BLUETOOTH_TYPE type) {
     if (session.isEmpty()) {
         return;
     }
@@ -154,11 +154,11 @@ void gpx::save(const QString &filename, QList<SessionLine> session, bluetoothdev
 
     stream.writeStartElement(QStringLiteral("metadata"));
     stream.writeTextElement(QStringLiteral("time"),
-                            session.at(0).time.toString(QStringLiteral("yyyy-MM-ddTHH:mm:ssZ")));
+                            session.dateTime(0).toString(QStringLiteral("yyyy-MM-ddTHH:mm:ssZ")));
     stream.writeEndElement();
 
     stream.writeStartElement(QStringLiteral("trk"));
-    stream.writeTextElement(QStringLiteral("name"), session.at(0).time.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
+    stream.writeTextElement(QStringLiteral("name"), session.dateTime(0).toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
 
     if (type == bluetoothdevice::TREADMILL || type == bluetoothdevice::ELLIPTICAL) {
         stream.writeTextElement(QStringLiteral("type"), QStringLiteral("0"));
@@ -167,27 +167,31 @@ void gpx::save(const QString &filename, QList<SessionLine> session, bluetoothdev
     }
 
     stream.writeStartElement(QStringLiteral("trkseg"));
-    for (const SessionLine &s : qAsConst(session)) {
-        if (s.speed > 0) {
+    for (int i = 0; i < session.length(); i++) {
+        const double speed = session.speed()[i];
+        if (speed > 0) {
+            const uint16_t watt = session.watt()[i];
+            const uint8_t heart = session.heart()[i];
+            const uint8_t cadence = session.cadence()[i];
             stream.writeStartElement(QStringLiteral("trkpt"));
             stream.writeAttribute(QStringLiteral("lat"), QStringLiteral("0"));
             stream.writeAttribute(QStringLiteral("lon"), QStringLiteral("0"));
             stream.writeTextElement(QStringLiteral("ele"),
                                     QStringLiteral("0")); // replace with the cumulative inclination
-            stream.writeTextElement(QStringLiteral("time"), s.time.toString(QStringLiteral("yyyy-MM-ddTHH:mm:ssZ")));
-            stream.writeTextElement(QStringLiteral("speed"), QString::number(s.speed / 3.6)); // meter per second
+            stream.writeTextElement(QStringLiteral("time"), session.dateTime(i).toString(QStringLiteral("yyyy-MM-ddTHH:mm:ssZ")));
+            stream.writeTextElement(QStringLiteral("speed"), QString::number(speed / 3.6)); // meter per second
             stream.writeStartElement(QStringLiteral("extensions"));
-            stream.writeTextElement(QStringLiteral("power"), QString::number(s.watt));
-            stream.writeTextElement(QStringLiteral("gpxdata:hr"), QString::number(s.heart));
-            stream.writeTextElement(QStringLiteral("gpxdata:cadence"), QString::number(s.cadence));
+            stream.writeTextElement(QStringLiteral("power"), QString::number(watt));
+            stream.writeTextElement(QStringLiteral("gpxdata:hr"), QString::number(heart));
+            stream.writeTextElement(QStringLiteral("gpxdata:cadence"), QString::number(cadence));
             stream.writeStartElement(QStringLiteral("gpxtpx:TrackPointExtension"));
-            stream.writeTextElement(QStringLiteral("gpxtpx:speed"), QString::number(s.speed / 3.6)); // meter per second
-            stream.writeTextElement(QStringLiteral("gpxtpx:hr"), QString::number(s.heart));
-            stream.writeTextElement(QStringLiteral("gpxtpx:cad"), QString::number(s.cadence));
-            stream.writeTextElement(QStringLiteral("gpxtpx:distance"), QString::number(s.distance));
+            stream.writeTextElement(QStringLiteral("gpxtpx:speed"), QString::number(speed / 3.6)); // meter per second
+            stream.writeTextElement(QStringLiteral("gpxtpx:hr"), QString::number(heart));
+            stream.writeTextElement(QStringLiteral("gpxtpx:cad"), QString::number(cadence));
+            stream.writeTextElement(QStringLiteral("gpxtpx:distance"), QString::number(session.distance()[i]));
             stream.writeEndElement(); // gpxtpx:TrackPointExtension
             stream.writeStartElement(QStringLiteral("gpxpx:PowerExtension"));
-            stream.writeTextElement(QStringLiteral("gpxpx:PowerInWatts"), QString::number(s.watt));
+            stream.writeTextElement(QStringLiteral("gpxpx:PowerInWatts"), QString::number(watt));
             stream.writeEndElement(); // gpxtpx:PowerExtension
             stream.writeEndElement(); // extensions
             stream.writeEndElement(); // trkpt
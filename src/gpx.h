@@ -2,7 +2,7 @@
 #define GPX_H
 
 #include "bluetoothdevice.h"
-#include "sessionline.h"
+#include "sessionstore.h"
 #include <QFile>
 #include <QGeoCoordinate>
 #include <QObject>
@@ -30,7 +30,7 @@ class gpx : public QObject {
   public:
     explicit gpx(QObject *parent = nullptr);
     QList<gpx_altitude_point_for_treadmill> open(const QString &gpx);
-    static void save(const QString &filename, QList<SessionLine> session, bluetoothdevice::BLUETOOTH_TYPE type);
+    static void save(const QString &filename, const sessionstore &session, bluetoothdevice::BLUETOOTH_TYPE type);
     QString getVideoURL() {return videoUrl;}
 
   private:
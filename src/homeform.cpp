@@ -1,4 +1,5 @@
 #include "homeform.h"
+#include "qzsettingscache.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "material.h"
@@ -188,6 +189,14 @@ homeform::homeform(QQmlApplicationEngine *engine, bluetooth *bl) {
                              false, QStringLiteral("avgWatt"), 48, labelFontSize);
     wattKg = new DataObject(QStringLiteral("Watt/Kg"), QStringLiteral("icons/icons/watt.png"), QStringLiteral("0"),
                             false, QStringLiteral("watt_kg"), 48, labelFontSize);
+    power3s = new DataObject(QStringLiteral("Power 3s"), QStringLiteral("icons/icons/watt.png"), QStringLiteral("0"),
+                             false, QStringLiteral("power_3s"), 48, labelFontSize);
+    power10s = new DataObject(QStringLiteral("Power 10s"), QStringLiteral("icons/icons/watt.png"), QStringLiteral("0"),
+                              false, QStringLiteral("power_10s"), 48, labelFontSize);
+    power30s = new DataObject(QStringLiteral("Power 30s"), QStringLiteral("icons/icons/watt.png"), QStringLiteral("0"),
+                              false, QStringLiteral("power_30s"), 48, labelFontSize);
+    normalizedPower = new DataObject(QStringLiteral("NP"), QStringLiteral("icons/icons/watt.png"), QStringLiteral("0"),
+                                     false, QStringLiteral("normalized_power"), 48, labelFontSize);
     ftp = new DataObject(QStringLiteral("FTP Zone"), QStringLiteral("icons/icons/watt.png"), QStringLiteral("0"), false,
                          QStringLiteral("ftp"), 48, labelFontSize);
     heart = new DataObject(QStringLiteral("Heart (bpm)"), QStringLiteral("icons/icons/heart_red.png"),
@@ -304,6 +313,17 @@ homeform::homeform(QQmlApplicationEngine *engine, bluetooth *bl) {
     connect(timer, &QTimer::timeout, this, &homeform::update);
     timer->start(1s);
 
+    QString recovered = sessionjournal::recover(getWritableAppDir() + sessionJournalFileName, getWritableAppDir());
+    if (!recovered.isEmpty()) {
+        qDebug() << QStringLiteral("previous session recovered to") << recovered;
+    }
+    journal = new sessionjournal(getWritableAppDir() + sessionJournalFileName);
+
+    fitThread = new QThread(this);
+    fitThread->setObjectName(QStringLiteral("fitEncoder"));
+    fitThread->start(QThread::LowPriority);
+
+    // the journal is synced every few samples while riding, this only catches the last ones before a pause
     backupTimer = new QTimer(this);
     connect(backupTimer, &QTimer::timeout, this, &homeform::backup);
     backupTimer->start(1min);
@@ -543,27 +563,7 @@ QString homeform::getWritableAppDir() {
     return path;
 }
 
-void homeform::backup() {
-
-    static uint8_t index = 0;
-    qDebug() << QStringLiteral("saving fit file backup...");
-
-    QString path = getWritableAppDir();
-    bluetoothdevice *dev = bluetoothManager->device();
-    if (dev) {
-
-        QString filename = path + QString::number(index) + backupFitFileName;
-        QFile::remove(filename);
-        qfit::save(filename, Session, dev->deviceType(),
-                   qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE,
-                   stravaPelotonWorkoutType);
-
-        index++;
-        if (index > 1) {
-            index = 0;
-        }
-    }
-}
+void homeform::backup() { journal->sync(); }
 
 QString homeform::stopColor() { return QStringLiteral("#00000000"); }
 
@@ -592,7 +592,22 @@ void homeform::refresh_bluetooth_devices_clicked() {
 homeform::~homeform() {
 
     gpx_save_clicked();
-    fit_save_clicked();
+    if (fitEncoder) {
+        // the event loop is going away: finish on the worker thread but wait for it
+        qfitencoder *encoder = fitEncoder;
+        fitEncoder = nullptr;
+        disconnect(encoder, &qfitencoder::finished, this, &homeform::fitSaved);
+        FIT_SPORT sport = stravaPelotonWorkoutType;
+        bool ok = false;
+        QMetaObject::invokeMethod(
+            encoder, [encoder, sport, &ok]() { ok = encoder->finish(sport); }, Qt::BlockingQueuedConnection);
+        if (ok) {
+            journal->discard();
+        }
+    }
+    fitThread->quit();
+    fitThread->wait();
+    delete journal;
 }
 
 void homeform::aboutToQuit() {
@@ -731,6 +746,8 @@ void homeform::ftmsAccessoryConnected(smartspin2k *d) {
 
 void homeform::sortTiles() {
 
+    // called when leaving the settings pages: make sure the cached snapshot sees what QML just wrote
+    QZSettingsCache::instance()->reload();
     QSettings settings;
     bool pelotoncadence =
         settings.value(QZSettings::bike_cadence_sensor, QZSettings::default_bike_cadence_sensor).toBool();
@@ -863,6 +880,30 @@ void homeform::sortTiles() {
                 dataList.append(wattKg);
             }
 
+            if (settings.value(QZSettings::tile_power_3s_enabled, QZSettings::default_tile_power_3s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_3s_order, QZSettings::default_tile_power_3s_order).toInt() == i) {
+                power3s->setGridId(i);
+                dataList.append(power3s);
+            }
+
+            if (settings.value(QZSettings::tile_power_10s_enabled, QZSettings::default_tile_power_10s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_10s_order, QZSettings::default_tile_power_10s_order).toInt() == i) {
+                power10s->setGridId(i);
+                dataList.append(power10s);
+            }
+
+            if (settings.value(QZSettings::tile_power_30s_enabled, QZSettings::default_tile_power_30s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_30s_order, QZSettings::default_tile_power_30s_order).toInt() == i) {
+                power30s->setGridId(i);
+                dataList.append(power30s);
+            }
+
+            if (settings.value(QZSettings::tile_normalized_power_enabled, QZSettings::default_tile_normalized_power_enabled).toBool() &&
+                settings.value(QZSettings::tile_normalized_power_order, QZSettings::default_tile_normalized_power_order).toInt() == i) {
+                normalizedPower->setGridId(i);
+                dataList.append(normalizedPower);
+            }
+
             if (settings.value(QZSettings::tile_remainingtimetrainprogramrow_enabled, false).toBool() &&
                 settings.value(QZSettings::tile_remainingtimetrainprogramrow_order, 27).toInt() == i) {
 
@@ -1090,6 +1131,30 @@ void homeform::sortTiles() {
                 wattKg->setGridId(i);
                 dataList.append(wattKg);
             }
+
+            if (settings.value(QZSettings::tile_power_3s_enabled, QZSettings::default_tile_power_3s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_3s_order, QZSettings::default_tile_power_3s_order).toInt() == i) {
+                power3s->setGridId(i);
+                dataList.append(power3s);
+            }
+
+            if (settings.value(QZSettings::tile_power_10s_enabled, QZSettings::default_tile_power_10s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_10s_order, QZSettings::default_tile_power_10s_order).toInt() == i) {
+                power10s->setGridId(i);
+                dataList.append(power10s);
+            }
+
+            if (settings.value(QZSettings::tile_power_30s_enabled, QZSettings::default_tile_power_30s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_30s_order, QZSettings::default_tile_power_30s_order).toInt() == i) {
+                power30s->setGridId(i);
+                dataList.append(power30s);
+            }
+
+            if (settings.value(QZSettings::tile_normalized_power_enabled, QZSettings::default_tile_normalized_power_enabled).toBool() &&
+                settings.value(QZSettings::tile_normalized_power_order, QZSettings::default_tile_normalized_power_order).toInt() == i) {
+                normalizedPower->setGridId(i);
+                dataList.append(normalizedPower);
+            }
             if (settings.value(QZSettings::tile_gears_enabled, false).toBool() &&
                 settings.value(QZSettings::tile_gears_order, 25).toInt() == i) {
                 gears->setGridId(i);
@@ -1325,6 +1390,30 @@ void homeform::sortTiles() {
                 dataList.append(wattKg);
             }
 
+            if (settings.value(QZSettings::tile_power_3s_enabled, QZSettings::default_tile_power_3s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_3s_order, QZSettings::default_tile_power_3s_order).toInt() == i) {
+                power3s->setGridId(i);
+                dataList.append(power3s);
+            }
+
+            if (settings.value(QZSettings::tile_power_10s_enabled, QZSettings::default_tile_power_10s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_10s_order, QZSettings::default_tile_power_10s_order).toInt() == i) {
+                power10s->setGridId(i);
+                dataList.append(power10s);
+            }
+
+            if (settings.value(QZSettings::tile_power_30s_enabled, QZSettings::default_tile_power_30s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_30s_order, QZSettings::default_tile_power_30s_order).toInt() == i) {
+                power30s->setGridId(i);
+                dataList.append(power30s);
+            }
+
+            if (settings.value(QZSettings::tile_normalized_power_enabled, QZSettings::default_tile_normalized_power_enabled).toBool() &&
+                settings.value(QZSettings::tile_normalized_power_order, QZSettings::default_tile_normalized_power_order).toInt() == i) {
+                normalizedPower->setGridId(i);
+                dataList.append(normalizedPower);
+            }
+
             if (settings.value(QZSettings::tile_remainingtimetrainprogramrow_enabled, false).toBool() &&
                 settings.value(QZSettings::tile_remainingtimetrainprogramrow_order, 27).toInt() == i) {
                 remaningTimeTrainingProgramCurrentRow->setGridId(i);
@@ -1501,6 +1590,30 @@ void homeform::sortTiles() {
                 dataList.append(wattKg);
             }
 
+            if (settings.value(QZSettings::tile_power_3s_enabled, QZSettings::default_tile_power_3s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_3s_order, QZSettings::default_tile_power_3s_order).toInt() == i) {
+                power3s->setGridId(i);
+                dataList.append(power3s);
+            }
+
+            if (settings.value(QZSettings::tile_power_10s_enabled, QZSettings::default_tile_power_10s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_10s_order, QZSettings::default_tile_power_10s_order).toInt() == i) {
+                power10s->setGridId(i);
+                dataList.append(power10s);
+            }
+
+            if (settings.value(QZSettings::tile_power_30s_enabled, QZSettings::default_tile_power_30s_enabled).toBool() &&
+                settings.value(QZSettings::tile_power_30s_order, QZSettings::default_tile_power_30s_order).toInt() == i) {
+                power30s->setGridId(i);
+                dataList.append(power30s);
+            }
+
+            if (settings.value(QZSettings::tile_normalized_power_enabled, QZSettings::default_tile_normalized_power_enabled).toBool() &&
+                settings.value(QZSettings::tile_normalized_power_order, QZSettings::default_tile_normalized_power_order).toInt() == i) {
+                normalizedPower->setGridId(i);
+                dataList.append(normalizedPower);
+            }
+
             if (settings.value(QZSettings::tile_remainingtimetrainprogramrow_enabled, false).toBool() &&
                 settings.value(QZSettings::tile_remainingtimetrainprogramrow_order, 27).toInt() == i) {
                 remaningTimeTrainingProgramCurrentRow->setGridId(i);
@@ -1601,6 +1714,7 @@ void homeform::sortTilesTimeout() { sortTiles(); }
 
 void homeform::deviceConnected(QBluetoothDeviceInfo b) {
 
+    QZSettingsCache::instance()->reload();
     qDebug() << "deviceConnected" << bluetoothManager << engine;
     if (bluetoothManager)
         qDebug() << bluetoothManager->device();
@@ -1983,12 +2097,23 @@ void homeform::Start_inner(bool send_event_to_device) {
         }
 
         if (stopped) {
+            // a new workout: pick up the settings written through plain QSettings since the last reload
+            QZSettingsCache::instance()->reload();
             trainProgram->restart();
             if (bluetoothManager->device()) {
 
                 bluetoothManager->device()->clearStats();
             }
             Session.clear();
+            wattPoints.clear();
+            heartPoints.clear();
+            cadencePoints.clear();
+            resistancePoints.clear();
+            pelotonResistancePoints.clear();
+            journal->discard();
+            fitEncoderAbort();
+            PowerCurve.clear();
+            emit powerCurveChanged();
             chartImagesFilenames.clear();
 
             if (!pelotonHandler || (pelotonHandler && !pelotonHandler->isWorkoutInProgress())) {
@@ -2148,7 +2273,7 @@ QString homeform::signal() {
 
 void homeform::update() {
 
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     double currentHRZone = 1;
     double ftpZone = 1;
 
@@ -2315,6 +2440,12 @@ void homeform::update() {
         wattKg->setSecondLine(
             QStringLiteral("AVG: ") + QString::number(bluetoothManager->device()->wattKg().average(), 'f', 1) +
             QStringLiteral("MAX: ") + QString::number(bluetoothManager->device()->wattKg().max(), 'f', 1));
+        power3s->setValue(QString::number(bluetoothManager->device()->wattsMetric().windowAverage(3), 'f', 0));
+        power10s->setValue(QString::number(bluetoothManager->device()->wattsMetric().windowAverage(10), 'f', 0));
+        power30s->setValue(QString::number(bluetoothManager->device()->wattsMetric().windowAverage(30), 'f', 0));
+        normalizedPower->setValue(QString::number(bluetoothManager->device()->wattsMetric().normalizedPower(), 'f', 0));
+        normalizedPower->setSecondLine(
+            QStringLiteral("VI: ") + QString::number(bluetoothManager->device()->wattsMetric().variabilityIndex(), 'f', 2));
         datetime->setValue(QTime::currentTime().toString(QStringLiteral("hh:mm:ss")));
         if (power5s)
             watts = bluetoothManager->device()->wattsMetric().average5s();
@@ -3457,7 +3588,23 @@ void homeform::update() {
                 lapTrigger, totalStrokes, avgStrokesRate, maxStrokesRate, avgStrokesLength,
                 bluetoothManager->device()->currentCordinate(), strideLength, groundContact, verticalOscillation);
 
+            if (!journal->isStarted()) {
+                bluetoothdevice *dev = bluetoothManager->device();
+                journal->start(dev->deviceType(),
+                               qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE,
+                               stravaPelotonWorkoutType);
+            }
+            journal->append(s);
+            if (!fitEncoder) {
+                fitEncoderStart();
+            }
+            qfitencoder *encoder = fitEncoder;
+            QMetaObject::invokeMethod(
+                encoder, [encoder, s]() { encoder->addSample(s); }, Qt::QueuedConnection);
             Session.append(s);
+            if (PowerCurve.append(watts)) {
+                emit powerCurveChanged();
+            }
 
             if (lapTrigger) {
                 lapTrigger = false;
@@ -3564,30 +3711,94 @@ void homeform::gpx_save_clicked() {
     }
 }
 
+void homeform::fitEncoderStart() {
+
+    bluetoothdevice *dev = bluetoothManager->device();
+    QString filename = getWritableAppDir() +
+                       QDateTime::currentDateTime().toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
+                       QStringLiteral(".fit");
+    fitEncoder = new qfitencoder(filename, dev->deviceType(),
+                                 qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE,
+                                 stravaPelotonWorkoutType);
+    fitEncoder->moveToThread(fitThread);
+    connect(fitEncoder, &qfitencoder::finished, this, &homeform::fitSaved);
+    connect(fitEncoder, &qfitencoder::finished, fitEncoder, &QObject::deleteLater);
+}
+
+void homeform::fitEncoderAbort() {
+
+    if (!fitEncoder) {
+        return;
+    }
+    qfitencoder *encoder = fitEncoder;
+    fitEncoder = nullptr;
+    QMetaObject::invokeMethod(
+        encoder,
+        [encoder]() {
+            encoder->abort();
+            encoder->deleteLater();
+        },
+        Qt::QueuedConnection);
+}
+
 void homeform::fit_save_clicked() {
 
-    QString path = getWritableAppDir();
     bluetoothdevice *dev = bluetoothManager->device();
-    if (dev) {
-        QString filename = path +
-                           QDateTime::currentDateTime().toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
-                           QStringLiteral(".fit");
-        qfit::save(filename, Session, dev->deviceType(),
-                   qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE,
-                   stravaPelotonWorkoutType);
-        lastFitFileSaved = filename;
+    if (!dev) {
+        return;
+    }
 
-        QSettings settings;
-        if (!settings.value(QZSettings::strava_accesstoken, QZSettings::default_strava_accesstoken)
-                 .toString()
-                 .isEmpty()) {
-
-            QFile f(filename);
-            f.open(QFile::OpenModeFlag::ReadOnly);
-            QByteArray fitfile = f.readAll();
-            strava_upload_file(fitfile, filename);
-            f.close();
-        }
+    if (fitEncoder && stopped) {
+        // the records have been encoded while riding, only the last lap and the summary are left
+        qfitencoder *encoder = fitEncoder;
+        fitEncoder = nullptr;
+        FIT_SPORT sport = stravaPelotonWorkoutType;
+        QMetaObject::invokeMethod(
+            encoder, [encoder, sport]() { encoder->finish(sport); }, Qt::QueuedConnection);
+        return;
+    }
+
+    if (Session.isEmpty()) {
+        return;
+    }
+
+    // saving while riding: encode a copy of the session (it only shares the chunks) on a worker thread
+    QString filename = getWritableAppDir() +
+                       QDateTime::currentDateTime().toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
+                       QStringLiteral(".fit");
+    sessionstore snapshot = Session;
+    bluetoothdevice::BLUETOOTH_TYPE type = dev->deviceType();
+    uint32_t processFlag = qobject_cast<m3ibike *>(dev) ? QFIT_PROCESS_DISTANCENOISE : QFIT_PROCESS_NONE;
+    FIT_SPORT sport = stravaPelotonWorkoutType;
+    QThread *t = QThread::create([filename, snapshot, type, processFlag, sport]() {
+        qfit::save(filename, snapshot, type, processFlag, sport);
+    });
+    connect(t, &QThread::finished, this, [this, filename]() { fitSaved(filename, QFileInfo(filename).size() > 0); });
+    connect(t, &QThread::finished, t, &QObject::deleteLater);
+    t->start(QThread::LowPriority);
+}
+
+void homeform::fitSaved(const QString &filename, bool ok) {
+
+    if (!ok) {
+        qDebug() << QStringLiteral("fit file not saved") << filename;
+        return;
+    }
+    lastFitFileSaved = filename;
+    if (stopped) {
+        journal->discard();
+    }
+
+    QSettings settings;
+    if (!settings.value(QZSettings::strava_accesstoken, QZSettings::default_strava_accesstoken)
+             .toString()
+             .isEmpty()) {
+
+        QFile f(filename);
+        f.open(QFile::OpenModeFlag::ReadOnly);
+        QByteArray fitfile = f.readAll();
+        strava_upload_file(fitfile, filename);
+        f.close();
     }
 }
 
@@ -4224,7 +4435,7 @@ void homeform::sendMail() {
     message.addRecipient(new EmailAddress(settings.value(QZSettings::user_email, QLatin1String("")).toString(),
                                           settings.value(QZSettings::user_email, QLatin1String("")).toString()));
     if (!Session.isEmpty()) {
-        QString title = Session.constFirst().time.toString();
+        QString title = Session.dateTime(0).toString();
         if (!stravaPelotonActivityName.isEmpty()) {
             title +=
                 QStringLiteral(" ") + stravaPelotonActivityName + QStringLiteral(" - ") + stravaPelotonInstructorName;
@@ -4286,8 +4497,16 @@ void homeform::sendMail() {
         QStringLiteral("Moving Time: ") + bluetoothManager->device()->movingTime().toString() + QStringLiteral("\n");
     textMessage += QStringLiteral("Weight Loss (") + weightLossUnit + "): " + QString::number(WeightLoss, 'f', 2) +
                    QStringLiteral("\n");
-    textMessage += QStringLiteral("Estimated VO2Max: ") + QString::number(metric::calculateVO2Max(&Session), 'f', 1) +
+    textMessage += QStringLiteral("Estimated VO2Max: ") + QString::number(metric::calculateVO2Max(PowerCurve), 'f', 1) +
                    QStringLiteral("\n");
+    for (uint32_t d : powercurve::durations()) {
+        double best = PowerCurve.best(d);
+        if (best <= 0)
+            break;
+        textMessage += QStringLiteral("Best ") +
+                       (d < 60 ? QString::number(d) + QStringLiteral("s") : QString::number(d / 60) + QStringLiteral("m")) +
+                       QStringLiteral(" Watt: ") + QString::number(best, 'f', 0) + QStringLiteral("\n");
+    }
     if (bluetoothManager->device()->deviceType() == bluetoothdevice::BIKE) {
         textMessage += QStringLiteral("Average Cadence: ") +
                        QString::number(((bike *)bluetoothManager->device())->currentCadence().average(), 'f', 0) +
@@ -4537,6 +4756,7 @@ void homeform::loadSettings(const QUrl &filename) {
             }
         }
     }
+    QZSettingsCache::instance()->reload();
 }
 
 void homeform::deleteSettings(const QUrl &filename) { QFile(filename.toLocalFile()).remove(); }
@@ -6,8 +6,11 @@
 #include "fit_profile.hpp"
 #include "gpx.h"
 #include "peloton.h"
+#include "qfitencoder.h"
+#include "powercurve.h"
 #include "screencapture.h"
-#include "sessionline.h"
+#include "sessionjournal.h"
+#include "sessionstore.h"
 #include "smtpclient/src/SmtpMime"
 #include "trainprogram.h"
 #include <QChart>
@@ -20,6 +23,7 @@
 #include <QQuickItem>
 #include <QQuickItemGrabResult>
 #include <QTextToSpeech>
+#include <QThread>
 
 class DataObject : public QObject {
 
@@ -135,6 +139,8 @@ class homeform : public QObject {
     Q_PROPERTY(QList<double> workout_peloton_resistance_points READ workout_peloton_resistance_points)
     Q_PROPERTY(QList<double> workout_resistance_points READ workout_resistance_points)
     Q_PROPERTY(double wattMaxChart READ wattMaxChart)
+    Q_PROPERTY(QList<double> power_curve_durations READ power_curve_durations CONSTANT)
+    Q_PROPERTY(QList<double> power_curve_points READ power_curve_points NOTIFY powerCurveChanged)
     Q_PROPERTY(bool autoResistance READ autoResistance NOTIFY autoResistanceChanged WRITE setAutoResistance)
 
     // workout preview
@@ -309,7 +315,7 @@ class homeform : public QObject {
     QString stopColor();
     QString workoutStartDate() {
         if (!Session.isEmpty()) {
-            return Session.constFirst().time.toString();
+            return Session.dateTime(0).toString();
         } else {
             return QLatin1String("");
         }
@@ -398,45 +404,36 @@ class homeform : public QObject {
     Q_INVOKABLE void moveTile(QString name, int newIndex, int oldIndex);
     DataObject *tileFromName(QString name);
 
-    QList<double> workout_watt_points() {
+    QList<double> power_curve_durations() {
         QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.watt);
+        for (uint32_t d : powercurve::durations()) {
+            l.append(d);
         }
         return l;
     }
+    QList<double> power_curve_points() { return PowerCurve.bests(); }
+
+    // QML needs a QList: the lists are kept and only extended with the samples recorded since the last read,
+    // returning them only shares them
+    QList<double> workout_watt_points() {
+        Session.watt().appendTo(wattPoints);
+        return wattPoints;
+    }
     QList<double> workout_heart_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.heart);
-        }
-        return l;
+        Session.heart().appendTo(heartPoints);
+        return heartPoints;
     }
     QList<double> workout_cadence_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.cadence);
-        }
-        return l;
+        Session.cadence().appendTo(cadencePoints);
+        return cadencePoints;
     }
     QList<double> workout_resistance_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.resistance);
-        }
-        return l;
+        Session.resistance().appendTo(resistancePoints);
+        return resistancePoints;
     }
     QList<double> workout_peloton_resistance_points() {
-        QList<double> l;
-        l.reserve(Session.size() + 1);
-        for (const SessionLine &s : qAsConst(Session)) {
-            l.append(s.peloton_resistance);
-        }
-        return l;
+        Session.pelotonResistance().appendTo(pelotonResistancePoints);
+        return pelotonResistancePoints;
     }
 
     QList<double> preview_workout_watt() {
@@ -476,15 +473,19 @@ class homeform : public QObject {
 
   private:
     QList<QObject *> dataList;
-    QList<SessionLine> Session;
+    sessionstore Session;
+    QList<double> wattPoints;
+    QList<double> heartPoints;
+    QList<double> cadencePoints;
+    QList<double> resistancePoints;
+    QList<double> pelotonResistancePoints;
+    powercurve PowerCurve;
     bluetooth *bluetoothManager;
     QQmlApplicationEngine *engine;
     trainprogram *trainProgram = nullptr;
     trainprogram *previewTrainProgram = nullptr;
-    QString backupFitFileName =
-        QStringLiteral("QZ-backup-") +
-        QDateTime::currentDateTime().toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
-        QStringLiteral(".fit");
+    const QString sessionJournalFileName = QStringLiteral("QZ-session.journal");
+    sessionjournal *journal = nullptr;
 
     int m_topBarHeight = 120;
     QString m_info = QStringLiteral("Connecting...");
@@ -569,9 +570,15 @@ class homeform : public QObject {
     DataObject *instantaneousStrideLengthCM;
     DataObject *groundContactMS;
     DataObject *verticalOscillationMM;
+    DataObject *power3s;
+    DataObject *power10s;
+    DataObject *power30s;
+    DataObject *normalizedPower;
 
     QTimer *timer;
     QTimer *backupTimer;
+    QThread *fitThread;
+    qfitencoder *fitEncoder = nullptr;
 
     QString strava_code;
     QOAuth2AuthorizationCodeFlow *strava_connect();
@@ -589,6 +596,8 @@ class homeform : public QObject {
     void update();
     double heartRateMax();
     void backup();
+    void fitEncoderStart();
+    void fitEncoderAbort();
     bool getDevice();
     bool getLap();
     void Start_inner(bool send_event_to_device);
@@ -654,6 +663,7 @@ class homeform : public QObject {
     void smtpError(SmtpClient::SmtpError e);
     void setActivityDescription(QString newdesc);
     void chartSaved(QString fileName);
+    void fitSaved(const QString &filename, bool ok);
     void sortTilesTimeout();
     void gearUp();
     void gearDown();
@@ -697,6 +707,7 @@ class homeform : public QObject {
     void workoutNameChanged(QString name);
     void workoutStartDateChanged(QString name);
     void instructorNameChanged(QString name);
+    void powerCurveChanged();
 
     void previewWorkoutPointsChanged(int value);
     void previewWorkoutDescriptionChanged(QString value);
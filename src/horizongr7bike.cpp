@@ -1,4 +1,5 @@
 #include "horizongr7bike.h"
+#include "qzsettingscache.h"
 #include "ftmsbike.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
@@ -33,40 +34,21 @@ horizongr7bike::horizongr7bike(bool noWriteResistance, bool noHeartService, uint
 
 void horizongr7bike::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
                                          bool wait_for_response) {
-    QEventLoop loop;
-    QTimer timeout;
-
     if (gattFTMSService) {
-        if (wait_for_response) {
-            connect(gattFTMSService, &QLowEnergyService::characteristicChanged, &loop, &QEventLoop::quit);
-            timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-        } else {
-            connect(gattFTMSService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
-            timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-        }
-
-        gattFTMSService->writeCharacteristic(gattWriteCharControlPointId, QByteArray((const char *)data, data_len));
+        writeQueue()->write(gattFTMSService, gattWriteCharControlPointId, QByteArray((const char *)data, data_len),
+                            wait_for_response);
     } else if (customService && customWriteChar.isValid()) {
-        if (wait_for_response) {
-            connect(customService, &QLowEnergyService::characteristicChanged, &loop, &QEventLoop::quit);
-            timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-        } else {
-            connect(customService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
-            timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-        }
-
-        customService->writeCharacteristic(customWriteChar, QByteArray((const char *)data, data_len));
+        writeQueue()->write(customService, customWriteChar, QByteArray((const char *)data, data_len),
+                            wait_for_response);
     } else {
         qDebug() << "writeCharacteristic error!";
         return;
     }
 
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        qzEmitDebug(qzDeviceRaw, QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+                                     QStringLiteral(" // ") + info);
     }
-
-    loop.exec();
 }
 
 void horizongr7bike::forceResistance(resistance_t requestResistance) {
@@ -142,7 +124,7 @@ void horizongr7bike::serviceDiscovered(const QBluetoothUuid &gatt) {
 void horizongr7bike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
     bool disable_hr_frommachinery = settings.value(QZSettings::heart_ignore_builtin, QZSettings::default_heart_ignore_builtin).toBool();
@@ -1,6 +1,8 @@
 #include "horizontreadmill.h"
 
 #include "ftmsbike.h"
+#include "ftmsdata.h"
+#include "latencytrace.h"
 #include "ios/lockscreen.h"
 #include "virtualtreadmill.h"
 #include <QBluetoothLocalDevice>
@@ -61,6 +63,7 @@ void horizontreadmill::writeCharacteristic(QLowEnergyService *service, QLowEnerg
     }
 
     service->writeCharacteristic(characteristic, QByteArray((const char *)data, data_len));
+    latencytrace::mark(latencytrace::COMMAND_WRITTEN);
 
     if (!disable_log)
         qDebug() << " >> " << QByteArray((const char *)data, data_len).toHex(' ') << " // " << info;
@@ -765,8 +768,22 @@ void horizontreadmill::update() {
             // updateDisplay(elapsed);
         }
 
+        // every speed and incline write is a slow sequence: the requests received in between collapse to the
+        // newest one, written at most once per slot interval
         if (requestSpeed != -1) {
             qDebug() << "requestSpeed=" << requestSpeed;
+            speedSlot.post(requestSpeed);
+            requestSpeed = -1;
+        }
+        if (requestInclination != -100) {
+            qDebug() << "requestInclination=" << requestInclination;
+            inclinationSlot.post(requestInclination);
+            requestInclination = -100;
+        }
+
+        double target;
+        if (speedSlot.take(currentSpeed().value(), &target)) {
+            requestSpeed = target;
             if (requestSpeed != currentSpeed().value() &&
                 fabs(requestSpeed - currentSpeed().value()) > minStepSpeed() && requestSpeed >= 0 &&
                 requestSpeed <= 22 && checkIfForceSpeedNeeding(requestSpeed, currentSpeed().value())) {
@@ -775,8 +792,8 @@ void horizontreadmill::update() {
             }
             requestSpeed = -1;
         }
-        if (requestInclination != -100) {
-            qDebug() << "requestInclination=" << requestInclination;
+        if (inclinationSlot.take(currentInclination().value(), &target)) {
+            requestInclination = target;
             if (requestInclination < 0)
                 requestInclination = 0;
             else {
@@ -1064,12 +1081,18 @@ void horizontreadmill::serviceDiscovered(const QBluetoothUuid &gatt) {
     emit debug(QStringLiteral("serviceDiscovered ") + gatt.toString());
 }
 
-void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                             const QByteArray &newValue) {
+void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
+    latencytrace::mark(latencytrace::NOTIFICATION_RECEIVED);
+    if (QLowEnergyService *s = qobject_cast<QLowEnergyService *>(sender()))
+        gattCache.notified(s->serviceUuid(), characteristic.uuid());
+    parseNotification(characteristic.uuid(), newValue);
+    latencytrace::mark(latencytrace::METRIC_UPDATED);
+}
+
+void horizontreadmill::parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue) {
     double heart = 0; // NOTE : Should be initialized with a value to shut clang-analyzer's
                       // UndefinedBinaryOperatorResult
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
-    Q_UNUSED(characteristic);
+    // qDebug() << "characteristicChanged" << uuid << newValue << newValue.length();
     bool distanceEval = false;
     QSettings settings;
     // bool horizon_paragon_x = settings.value(QZSettings::horizon_paragon_x,
@@ -1077,10 +1100,10 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
-    emit debug(QStringLiteral(" << ") + characteristic.uuid().toString() + " " + QString::number(newValue.length()) +
+    emit debug(QStringLiteral(" << ") + uuid.toString() + " " + QString::number(newValue.length()) +
                " " + newValue.toHex(' '));
 
-    if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4)) {
+    if (uuid == QBluetoothUuid((quint16)0xFFF4)) {
         if (newValue.at(0) == 0x55 && newValue.length() > 7) {
             lastPacketComplete.clear();
             customRecv = (((uint16_t)((uint8_t)newValue.at(7)) << 8) | (uint16_t)((uint8_t)newValue.at(6))) + 10;
@@ -1097,7 +1120,7 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         }
     }
 
-    if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4) && lastPacketComplete.length() > 70 &&
+    if (uuid == QBluetoothUuid((quint16)0xFFF4) && lastPacketComplete.length() > 70 &&
         lastPacketComplete.at(0) == 0x55 && lastPacketComplete.at(5) == 0x17) {
         Speed = (((double)(((uint16_t)((uint8_t)lastPacketComplete.at(25)) << 8) |
                            (uint16_t)((uint8_t)lastPacketComplete.at(24)))) /
@@ -1125,7 +1148,7 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                          ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
         emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
         distanceEval = true;
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4) && newValue.length() > 70 &&
+    } else if (uuid == QBluetoothUuid((quint16)0xFFF4) && newValue.length() > 70 &&
                newValue.at(0) == 0x55 && newValue.at(5) == 0x12) {
         Speed =
             (((double)(((uint16_t)((uint8_t)newValue.at(62)) << 8) | (uint16_t)((uint8_t)newValue.at(61)))) / 1000.0) *
@@ -1152,7 +1175,7 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                          ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
         emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
         distanceEval = true;
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4) && newValue.length() == 29 &&
+    } else if (uuid == QBluetoothUuid((quint16)0xFFF4) && newValue.length() == 29 &&
                newValue.at(0) == 0x55) {
         Speed = ((double)(((uint16_t)((uint8_t)newValue.at(15)) << 8) | (uint16_t)((uint8_t)newValue.at(14)))) / 10.0;
         emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
@@ -1176,7 +1199,7 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
                          ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
         emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
         distanceEval = true;
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0xFFF4) && (uint8_t)newValue.at(0) == 0x55 &&
+    } else if (uuid == QBluetoothUuid((quint16)0xFFF4) && (uint8_t)newValue.at(0) == 0x55 &&
                (uint8_t)newValue.at(1) == 0xAA && (uint8_t)newValue.at(2) == 0x00 && (uint8_t)newValue.at(3) == 0x00 &&
                (uint8_t)newValue.at(4) == 0x03 && (uint8_t)newValue.at(5) == 0x03 && (uint8_t)newValue.at(6) == 0x01 &&
                (uint8_t)newValue.at(7) == 0x00 && (uint8_t)newValue.at(8) == 0xf0 && (uint8_t)newValue.at(9) == 0xe1 &&
@@ -1185,62 +1208,25 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         Speed = 0;
         horizonPaused = true;
         qDebug() << "stop from the treadmill";
-    } else if (characteristic.uuid() == QBluetoothUuid((quint16)0x2ACD)) {
+    } else if (uuid == QBluetoothUuid((quint16)ftmsdata::TREADMILL_DATA)) {
         lastPacket = newValue;
 
         // default flags for this treadmill is 84 04
 
-        union flags {
-            struct {
-
-                uint16_t moreData : 1;
-                uint16_t avgSpeed : 1;
-                uint16_t totalDistance : 1;
-                uint16_t inclination : 1;
-                uint16_t elevation : 1;
-                uint16_t instantPace : 1;
-                uint16_t averagePace : 1;
-                uint16_t expEnergy : 1;
-                uint16_t heartRate : 1;
-                uint16_t metabolic : 1;
-                uint16_t elapsedTime : 1;
-                uint16_t remainingTime : 1;
-                uint16_t forceBelt : 1;
-                uint16_t spare : 3;
-            };
-
-            uint16_t word_flags;
-        };
-
-        flags Flags;
-        int index = 0;
-        Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-        index += 2;
-
-        if (!Flags.moreData) {
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
-            index += 2;
+        ftmsdata data;
+        if (!data.decode(ftmsdata::TREADMILL_DATA, newValue))
+            emit debug(QStringLiteral("FTMS packet shorter than its flags"));
+
+        if (data.has(ftmsdata::FIELD_SPEED)) {
+            Speed = data.speed;
             emit debug(QStringLiteral("Current Speed: ") + QString::number(Speed.value()));
         }
 
-        if (Flags.avgSpeed) {
-            double avgSpeed;
-            avgSpeed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                 (uint16_t)((uint8_t)newValue.at(index)))) /
-                       100.0;
-            index += 2;
-            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(avgSpeed));
+        if (data.has(ftmsdata::FIELD_AVERAGE_SPEED)) {
+            emit debug(QStringLiteral("Current Average Speed: ") + QString::number(data.averageSpeed));
         }
 
-        if (Flags.totalDistance) {
-            // ignoring the distance, because it's a total life odometer
-            // Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-            // (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint32_t)((uint8_t)newValue.at(index)))) / 1000.0;
-            index += 3;
-        }
-        // else
+        // ignoring the distance, because it's a total life odometer
         {
             if (firstDistanceCalculated)
                 Distance += ((Speed.value() / 3600000.0) *
@@ -1250,36 +1236,14 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
 
         emit debug(QStringLiteral("Current Distance: ") + QString::number(Distance.value()));
 
-        if (Flags.inclination) {
-            Inclination = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                    (uint16_t)((uint8_t)newValue.at(index)))) /
-                          10.0;
-            index += 4; // the ramo value is useless
+        if (data.has(ftmsdata::FIELD_INCLINATION)) {
+            // the ramp angle is useless
+            Inclination = data.inclination;
             emit debug(QStringLiteral("Current Inclination: ") + QString::number(Inclination.value()));
         }
 
-        if (Flags.elevation) {
-            index += 4; // TODO
-        }
-
-        if (Flags.instantPace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.averagePace) {
-            index += 1; // TODO
-        }
-
-        if (Flags.expEnergy) {
-            KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint16_t)((uint8_t)newValue.at(index))));
-            index += 2;
-
-            // energy per hour
-            index += 2;
-
-            // energy per minute
-            index += 1;
+        if (data.has(ftmsdata::FIELD_ENERGY)) {
+            KCal = data.energy;
         } else {
             if (firstDistanceCalculated &&
                 watts(settings.value(QZSettings::weight, QZSettings::default_weight).toFloat()))
@@ -1304,33 +1268,13 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         else
 #endif
         {
-            if (Flags.heartRate) {
-                if (index < newValue.length()) {
-
-                    heart = ((double)((newValue.at(index))));
-                    emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
-                } else {
-                    emit debug(QStringLiteral("Error on parsing heart!"));
-                }
-                // index += 1; //NOTE: clang-analyzer-deadcode.DeadStores
+            if (data.has(ftmsdata::FIELD_HEART)) {
+                heart = data.heart;
+                emit debug(QStringLiteral("Current Heart: ") + QString::number(heart));
+            } else if (data.flags & 0x0100) {
+                emit debug(QStringLiteral("Error on parsing heart!"));
             }
         }
-
-        if (Flags.metabolic) {
-            // todo
-        }
-
-        if (Flags.elapsedTime) {
-            // todo
-        }
-
-        if (Flags.remainingTime) {
-            // todo
-        }
-
-        if (Flags.forceBelt) {
-            // todo
-        }
     }
 
     if (heartRateBeltName.startsWith(QStringLiteral("Disabled"))) {
@@ -1363,7 +1307,7 @@ void horizontreadmill::characteristicChanged(const QLowEnergyCharacteristic &cha
         lastRefreshCharacteristicChanged = QDateTime::currentDateTime();
     }
 
-    if (m_control->error() != QLowEnergyController::NoError) {
+    if (m_control && m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
     }
 }
@@ -1385,6 +1329,19 @@ void horizontreadmill::stateChanged(QLowEnergyService::ServiceState state) {
 
     qDebug() << QStringLiteral("all services discovered!");
 
+    if (!gattCache.validate(gattCommunicationChannelService)) {
+        // the cached layout does not match the peripheral anymore: discover the services it skipped
+        auto services_list = gattcache::remaining(m_control->services(), gattCommunicationChannelService);
+        for (const QBluetoothUuid &s : qAsConst(services_list)) {
+            gattCommunicationChannelService.append(m_control->createServiceObject(s));
+            connect(gattCommunicationChannelService.constLast(), &QLowEnergyService::stateChanged, this,
+                    &horizontreadmill::stateChanged);
+            gattCommunicationChannelService.constLast()->discoverDetails();
+        }
+        if (!services_list.isEmpty())
+            return;
+    }
+
     notificationSubscribed = 0;
 
     for (QLowEnergyService *s : qAsConst(gattCommunicationChannelService)) {
@@ -1409,6 +1366,7 @@ void horizontreadmill::stateChanged(QLowEnergyService::ServiceState state) {
                     qDebug() << QStringLiteral("FTMS service and Control Point found");
                     gattWriteCharControlPointId = c;
                     gattFTMSService = s;
+                    gattCache.use(s->serviceUuid());
                 } else if (c.uuid() == _gattTreadmillDataId && gattFTMSService == nullptr) {
                     // some treadmills doesn't have the control point so i need anyway to get the FTMS Service at least
                     gattFTMSService = s;
@@ -1418,6 +1376,7 @@ void horizontreadmill::stateChanged(QLowEnergyService::ServiceState state) {
                     qDebug() << QStringLiteral("Custom service and Control Point found");
                     gattWriteCharCustomService = c;
                     gattCustomService = s;
+                    gattCache.use(s->serviceUuid());
                 }
             }
         }
@@ -1525,7 +1484,7 @@ void horizontreadmill::serviceScanDone(void) {
 
     initRequest = false;
     firstStateChanged = 0;
-    auto services_list = m_control->services();
+    auto services_list = gattCache.services(m_control->services());
     for (const QBluetoothUuid &s : qAsConst(services_list)) {
         gattCommunicationChannelService.append(m_control->createServiceObject(s));
         connect(gattCommunicationChannelService.constLast(), &QLowEnergyService::stateChanged, this,
@@ -1559,6 +1518,7 @@ void horizontreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
     {
         bluetoothDevice = device;
 
+        gattCache.setDevice(bluetoothDevice);
         m_control = QLowEnergyController::createCentral(bluetoothDevice, this);
         connect(m_control, &QLowEnergyController::serviceDiscovered, this, &horizontreadmill::serviceDiscovered);
         connect(m_control, &QLowEnergyController::discoveryFinished, this, &horizontreadmill::serviceScanDone);
@@ -1587,6 +1547,7 @@ void horizontreadmill::deviceDiscovered(const QBluetoothDeviceInfo &device) {
         });
 
         // Connect
+        gattCache.connecting();
         m_control->connectToDevice();
         return;
     }
@@ -1610,6 +1571,7 @@ void horizontreadmill::controllerStateChanged(QLowEnergyController::ControllerSt
         qDebug() << QStringLiteral("trying to connect back again...");
 
         initDone = false;
+        gattCache.connecting();
         m_control->connectToDevice();
     }
 }
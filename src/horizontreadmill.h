@@ -28,6 +28,8 @@
 #include <QObject>
 #include <QString>
 
+#include "commandslot.h"
+#include "gattcache.h"
 #include "treadmill.h"
 #include "virtualbike.h"
 #include "virtualtreadmill.h"
@@ -68,6 +70,7 @@ class horizontreadmill : public treadmill {
     QLowEnergyService *gattFTMSService = nullptr;
     QLowEnergyCharacteristic gattWriteCharCustomService;
     QLowEnergyService *gattCustomService = nullptr;
+    gattcache gattCache;
     volatile int notificationSubscribed = 0;
 
     uint8_t sec1Update = 0;
@@ -82,6 +85,9 @@ class horizontreadmill : public treadmill {
     int64_t lastStop = 0;
     bool horizonPaused = false;
 
+    commandslot speedSlot{"speed", 500, 0.1};
+    commandslot inclinationSlot{"inclination", 1000, 0.5};
+
     bool initDone = false;
     bool initRequest = false;
 
@@ -167,6 +173,11 @@ class horizontreadmill : public treadmill {
 
   public slots:
     void deviceDiscovered(const QBluetoothDeviceInfo &device);
+    /**
+     * @brief parseNotification Decodes a notification of the characteristic uuid. characteristicChanged forwards
+     * here, the btsnoop replay tool (src/test/btsnoop-replay) calls it directly with recorded packets.
+     */
+    void parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue);
 
   private slots:
 
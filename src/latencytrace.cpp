@@ -0,0 +1,157 @@
+#include "latencytrace.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+bool latencytrace::on = false;
+QElapsedTimer latencytrace::clock;
+qint64 latencytrace::pending[STAGE_COUNT] = {};
+qint64 latencytrace::origin[STAGE_COUNT] = {};
+latencytrace::histogram latencytrace::stages[STAGE_COUNT];
+latencytrace::histogram latencytrace::metricsTotal;
+latencytrace::histogram latencytrace::commandsTotal;
+
+static const char *const stageNames[latencytrace::STAGE_COUNT] = {
+    "notification_received", "metric_updated", "snapshot_taken", "frame_sent",
+    "control_received",      "control_applied", "command_written",
+};
+
+// which drivers mark the trainer side stages: with any other one those stages stay empty
+static const char coverage[] =
+    "notification_received, metric_updated: ftmsbike and horizontreadmill only; "
+    "command_written: ftmsbike, horizontreadmill and the drivers writing through the shared write queue";
+
+static bool chainStart(latencytrace::stage s) {
+    return s == latencytrace::NOTIFICATION_RECEIVED || s == latencytrace::CONTROL_RECEIVED;
+}
+
+static bool chainEnd(latencytrace::stage s) {
+    return s == latencytrace::FRAME_SENT || s == latencytrace::COMMAND_WRITTEN;
+}
+
+void latencytrace::histogram::add(qint64 ns) {
+    const quint64 us = ns > 0 ? (quint64)ns / 1000 : 0;
+    int b = 0;
+    while (b < BUCKETS - 1 && (1ull << b) <= us)
+        b++;
+    buckets[b]++;
+    count++;
+    sumUs += us;
+    maxUs = qMax(maxUs, us);
+}
+
+// upper bound of the bucket holding the percentile, capped by the maximum
+quint64 latencytrace::histogram::percentile(double p) const {
+    if (!count)
+        return 0;
+    const quint64 rank = qMax<quint64>(1, (quint64)(p * count + 0.5));
+    quint64 seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= rank)
+            return qMin(maxUs, b < BUCKETS - 1 ? (1ull << b) : maxUs);
+    }
+    return maxUs;
+}
+
+void latencytrace::setEnabled(bool enabled) {
+    if (enabled && !clock.isValid())
+        clock.start();
+    on = enabled;
+}
+
+void latencytrace::reset() {
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        pending[s] = origin[s] = 0;
+        stages[s] = histogram();
+    }
+    metricsTotal = histogram();
+    commandsTotal = histogram();
+}
+
+void latencytrace::record(stage s) {
+    // 0 means "no mark": the clock starts at 1 ns
+    const qint64 now = clock.nsecsElapsed() + 1;
+    if (chainStart(s)) {
+        if (!pending[s]) {
+            pending[s] = now;
+            origin[s] = now;
+        }
+        return;
+    }
+    const int previous = s - 1;
+    if (!pending[previous])
+        return;
+    stages[s].add(now - pending[previous]);
+    const qint64 start = origin[previous];
+    pending[previous] = 0;
+    if (chainEnd(s)) {
+        (s == FRAME_SENT ? metricsTotal : commandsTotal).add(now - start);
+    } else if (!pending[s]) {
+        pending[s] = now;
+        origin[s] = start;
+    }
+}
+
+QByteArray latencytrace::json() {
+    QJsonArray list;
+    auto add = [&list](const QString &name, const QString &from, const histogram &h) {
+        QJsonArray buckets;
+        for (int b = 0; b < BUCKETS; b++)
+            buckets.append((double)h.buckets[b]);
+        QJsonObject o;
+        o[QStringLiteral("stage")] = name;
+        o[QStringLiteral("from")] = from;
+        o[QStringLiteral("count")] = (double)h.count;
+        o[QStringLiteral("mean_us")] = h.count ? (double)h.sumUs / h.count : 0.0;
+        o[QStringLiteral("p50_us")] = (double)h.percentile(0.5);
+        o[QStringLiteral("p90_us")] = (double)h.percentile(0.9);
+        o[QStringLiteral("p99_us")] = (double)h.percentile(0.99);
+        o[QStringLiteral("max_us")] = (double)h.maxUs;
+        o[QStringLiteral("buckets")] = buckets;
+        list.append(o);
+    };
+    for (int s = 0; s < STAGE_COUNT; s++)
+        if (!chainStart((stage)s))
+            add(QLatin1String(stageNames[s]), QLatin1String(stageNames[s - 1]), stages[s]);
+    add(QStringLiteral("metrics_total"), QLatin1String(stageNames[NOTIFICATION_RECEIVED]), metricsTotal);
+    add(QStringLiteral("commands_total"), QLatin1String(stageNames[CONTROL_RECEIVED]), commandsTotal);
+
+    QJsonObject root;
+    root[QStringLiteral("enabled")] = on;
+    root[QStringLiteral("coverage")] = QLatin1String(coverage);
+    root[QStringLiteral("stages")] = list;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QString latencytrace::text() {
+    QString out = QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+                      .arg(QStringLiteral("stage"), -40)
+                      .arg(QStringLiteral("count"), 8)
+                      .arg(QStringLiteral("mean us"), 10)
+                      .arg(QStringLiteral("p50 us"), 10)
+                      .arg(QStringLiteral("p90 us"), 10)
+                      .arg(QStringLiteral("p99 us"), 10)
+                      .arg(QStringLiteral("max us"), 10);
+    auto add = [&out](const QString &name, const histogram &h) {
+        out += QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(name, -40)
+                   .arg(h.count, 8)
+                   .arg(h.count ? (double)h.sumUs / h.count : 0.0, 10, 'f', 0)
+                   .arg(h.percentile(0.5), 10)
+                   .arg(h.percentile(0.9), 10)
+                   .arg(h.percentile(0.99), 10)
+                   .arg(h.maxUs, 10);
+    };
+    for (int s = 0; s < STAGE_COUNT; s++)
+        if (!chainStart((stage)s))
+            add(QStringLiteral("%1 -> %2").arg(QLatin1String(stageNames[s - 1]), QLatin1String(stageNames[s])),
+                stages[s]);
+    add(QStringLiteral("metrics total"), metricsTotal);
+    add(QStringLiteral("commands total"), commandsTotal);
+    out += QLatin1String(coverage) + QLatin1Char('\n');
+    if (!on)
+        out += QStringLiteral("latency tracing is off (latency_trace setting)\n");
+    return out;
+}
@@ -0,0 +1,74 @@
+#ifndef LATENCYTRACE_H
+#define LATENCYTRACE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief The latencytrace class measures how long the metrics and the commands take to go through the app, stage
+ * by stage, on a monotonic clock:
+ *
+ *   metrics   NOTIFICATION_RECEIVED -> METRIC_UPDATED -> SNAPSHOT_TAKEN -> FRAME_SENT
+ *   commands  CONTROL_RECEIVED -> CONTROL_APPLIED -> COMMAND_WRITTEN
+ *
+ * mark() at a stage records the time since the oldest mark of the previous stage not picked up yet, i.e. how long
+ * the oldest data waited, in a log2 histogram per stage; the last stage of a chain also records the time since
+ * the start of the chain. Marks without a pending previous stage (a keep-alive frame, an init write) are not
+ * counted. The stages are global, not per device: with one trainer and one app, which is the case to debug, they
+ * follow the data.
+ *
+ * Off by default (latency_trace setting): mark() is then a test of a static flag. Main thread only.
+ * The histograms are served by the web server on /latency (JSON) and /latency.txt, with the list of the drivers
+ * that mark the trainer side stages: only ftmsbike and horizontreadmill mark the notifications so far.
+ */
+class latencytrace {
+  public:
+    enum stage : quint8 {
+        NOTIFICATION_RECEIVED, // characteristicChanged of a driver
+        METRIC_UPDATED,        // the driver parsed the notification
+        SNAPSHOT_TAKEN,        // a virtual device or dircon provider took its snapshot
+        FRAME_SENT,            // the virtual device or dircon notification was written
+        CONTROL_RECEIVED,      // 0x2AD9 control point write from the app
+        CONTROL_APPLIED,       // changePower / changeResistance / changeInclination / changeSpeed called
+        COMMAND_WRITTEN,       // the driver wrote the command to the trainer
+        STAGE_COUNT
+    };
+
+    static const int BUCKETS = 24; // bucket i counts the latencies in [2^(i-1), 2^i) us, the last one the rest
+
+    static void mark(stage s) {
+        if (on)
+            record(s);
+    }
+
+    static bool isEnabled() { return on; }
+    static void setEnabled(bool enabled);
+    static void reset();
+
+    static QByteArray json();
+    static QString text();
+
+  private:
+    struct histogram {
+        quint64 count = 0;
+        quint64 sumUs = 0;
+        quint64 maxUs = 0;
+        quint64 buckets[BUCKETS] = {};
+        void add(qint64 ns);
+        quint64 percentile(double p) const;
+    };
+
+    static void record(stage s);
+
+    static bool on;
+    static QElapsedTimer clock;
+    static qint64 pending[STAGE_COUNT]; // oldest mark not picked up by the next stage, 0 if none
+    static qint64 origin[STAGE_COUNT];  // start of the chain of that mark
+    static histogram stages[STAGE_COUNT];
+    static histogram metricsTotal;
+    static histogram commandsTotal;
+};
+
+#endif // LATENCYTRACE_H
@@ -0,0 +1,222 @@
+#include "logwriter.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <cstdio>
+
+logwriter *logwriter::instance() {
+    static logwriter *writer = new logwriter();
+    return writer;
+}
+
+logwriter::logwriter() : m_queue(QUEUE_SIZE) {
+    for (size_t i = 0; i < m_queue.size(); i++)
+        m_queue[i].sequence.store(i, std::memory_order_relaxed);
+    setObjectName(QStringLiteral("logwriter"));
+}
+
+void logwriter::open(const QString &filename, bool echo) {
+    // the message handler calls this from whichever thread logs first, only one of them may start the writer.
+    // m_opened is set before anything below can log, so a nested message goes to the queue instead of here
+    QMutexLocker locker(&m_mutex);
+    if (m_opened.load(std::memory_order_relaxed))
+        return;
+    m_opened.store(true, std::memory_order_release);
+    m_filename = filename;
+    m_echo = echo;
+    m_file.setFileName(filename);
+    m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+    m_stop = false;
+    start(QThread::LowPriority);
+}
+
+bool logwriter::push(QtMsgType type, const char *file, const char *function, const QString &msg) {
+    if (m_closed.load(std::memory_order_acquire)) {
+        // late messages, after close(): nobody drains the queue anymore, append them directly
+        entry e;
+        e.msecs = QDateTime::currentMSecsSinceEpoch();
+        e.type = type;
+        e.file = file;
+        e.function = function;
+        e.msg = msg;
+        QByteArray line = format(e, QDateTime::fromMSecsSinceEpoch(e.msecs).toString()).toUtf8();
+        QMutexLocker locker(&m_mutex);
+        QFile f(m_filename);
+        if (f.open(QIODevice::WriteOnly | QIODevice::Append))
+            f.write(line);
+        if (m_echo)
+            fwrite(line.constData(), 1, line.size(), stderr);
+        return true;
+    }
+
+    const size_t mask = m_queue.size() - 1;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    cell *c;
+    for (;;) {
+        c = &m_queue[pos & mask];
+        const size_t seq = c->sequence.load(std::memory_order_acquire);
+        const intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            // full: the writer is behind, don't make the caller wait for it
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    c->data.msecs = QDateTime::currentMSecsSinceEpoch();
+    c->data.type = type;
+    c->data.file = file;
+    c->data.function = function;
+    c->data.msg = msg;
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool logwriter::pop(entry &e) {
+    const size_t mask = m_queue.size() - 1;
+    cell &c = m_queue[m_dequeuePos & mask];
+    const size_t seq = c.sequence.load(std::memory_order_acquire);
+    if ((intptr_t)seq - (intptr_t)(m_dequeuePos + 1) < 0)
+        return false;
+    e = c.data;
+    c.data.msg.clear();
+    c.sequence.store(m_dequeuePos + mask + 1, std::memory_order_release);
+    m_dequeuePos++;
+    return true;
+}
+
+QString logwriter::format(const entry &e, const QString &date) {
+    const char *file = e.file ? e.file : "";
+    const char *function = e.function ? e.function : "";
+    QString txt = date + QStringLiteral(" ") + QString::number(e.msecs) + QStringLiteral(" ");
+    switch (e.type) {
+    case QtInfoMsg:
+        txt += QStringLiteral("Info: %1 %2 %3\n").arg(file, function, e.msg); // NOTE: clazy-qstring-arg
+        break;
+    case QtDebugMsg:
+        txt += QStringLiteral("Debug: %1 %2 %3\n").arg(file, function, e.msg); // NOTE: clazy-qstring-arg
+        break;
+    case QtWarningMsg:
+        txt += QStringLiteral("Warning: %1 %2 %3\n").arg(file, function, e.msg); // NOTE: clazy-qstring-arg
+        break;
+    case QtCriticalMsg:
+        txt += QStringLiteral("Critical: %1 %2 %3\n").arg(file, function, e.msg); // NOTE: clazy-qstring-arg
+        break;
+    case QtFatalMsg:
+        txt += QStringLiteral("Fatal: %1 %2 %3\n").arg(file, function, e.msg); // NOTE: clazy-qstring-arg
+        break;
+    }
+    return txt;
+}
+
+void logwriter::drain() {
+    static const int BATCH_SIZE = 256 * 1024;
+    QByteArray batch;
+    entry e;
+    qint64 lastSecond = -1;
+    QString date;
+
+    while (pop(e)) {
+        // QDateTime::toString() has a one second resolution, format it once per second
+        if (e.msecs / 1000 != lastSecond) {
+            lastSecond = e.msecs / 1000;
+            date = QDateTime::fromMSecsSinceEpoch(e.msecs).toString();
+        }
+        batch.append(format(e, date).toUtf8());
+
+        if (batch.size() > BATCH_SIZE)
+            break;
+    }
+
+    const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_droppedReported) {
+        batch.append(QStringLiteral("%1 %2 logwriter: %3 log lines dropped, the log queue was full\n")
+                         .arg(QDateTime::currentDateTime().toString())
+                         .arg(QDateTime::currentMSecsSinceEpoch())
+                         .arg(dropped - m_droppedReported)
+                         .toUtf8());
+        m_droppedReported = dropped;
+    }
+
+    if (batch.isEmpty())
+        return;
+
+    m_file.write(batch);
+    m_file.flush();
+    if (m_echo) {
+        fwrite(batch.constData(), 1, batch.size(), stderr);
+    }
+    if (m_file.size() > ROTATE_SIZE)
+        rotate();
+}
+
+QString logwriter::rotatedName(int index) const {
+    if (index == 0)
+        return m_filename;
+    if (m_filename.endsWith(QStringLiteral(".log")))
+        return m_filename.left(m_filename.length() - 4) + QStringLiteral(".") + QString::number(index) +
+               QStringLiteral(".log");
+    return m_filename + QStringLiteral(".") + QString::number(index);
+}
+
+void logwriter::rotate() {
+    m_file.close();
+    QFile::remove(rotatedName(ROTATE_FILES - 1));
+    for (int i = ROTATE_FILES - 2; i >= 0; i--)
+        QFile::rename(rotatedName(i), rotatedName(i + 1));
+    m_file.setFileName(m_filename);
+    m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void logwriter::run() {
+    for (;;) {
+        bool flushing;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!m_flushRequested && !m_stop)
+                m_wake.wait(&m_mutex, WRITE_INTERVAL_MS);
+            flushing = m_flushRequested;
+            m_flushRequested = false;
+        }
+
+        // a drain stops after BATCH_SIZE bytes, keep going until the queue is empty
+        size_t before;
+        do {
+            before = m_dequeuePos;
+            drain();
+        } while (m_dequeuePos != before);
+
+        if (flushing) {
+            QMutexLocker locker(&m_mutex);
+            m_drained.wakeAll();
+        }
+        if (m_stop)
+            break;
+    }
+    m_file.close();
+}
+
+void logwriter::flush() {
+    if (!isRunning() || QThread::currentThread() == this)
+        return;
+    QMutexLocker locker(&m_mutex);
+    m_flushRequested = true;
+    m_wake.wakeAll();
+    m_drained.wait(&m_mutex, 2000);
+}
+
+void logwriter::close() {
+    if (!isRunning())
+        return;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stop = true;
+        m_wake.wakeAll();
+    }
+    wait();
+    m_closed.store(true, std::memory_order_release);
+}
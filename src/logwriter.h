@@ -0,0 +1,98 @@
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief The logwriter class moves the debug log file I/O off the threads that log.
+ * The message handler only stamps the message and pushes it into a bounded, lock-free multi-producer ring;
+ * a dedicated thread formats what is queued, writes it in one batch every WRITE_INTERVAL_MS, and rotates the
+ * file when it grows past ROTATE_SIZE. When the ring is full the message is dropped and counted, the count is
+ * written to the log as soon as there is room again.
+ */
+class logwriter : public QThread {
+    Q_OBJECT
+
+  public:
+    static const int QUEUE_SIZE = 8192; // must be a power of 2
+    static const int WRITE_INTERVAL_MS = 100;
+    static const qint64 ROTATE_SIZE = 50 * 1024 * 1024;
+    static const int ROTATE_FILES = 3; // debug-x.log, debug-x.1.log, debug-x.2.log
+
+    static logwriter *instance();
+
+    /**
+     * @brief open Starts the writer thread on the given file. Thread safe, only the first call has an effect.
+     * @param echo also write every line to stderr
+     */
+    void open(const QString &filename, bool echo);
+
+    /**
+     * @brief push Called from the message handler, on any thread. Never blocks.
+     * @return false if the message was dropped
+     */
+    bool push(QtMsgType type, const char *file, const char *function, const QString &msg);
+
+    /**
+     * @brief flush Waits until everything pushed so far is on disk (used before a fatal abort and on exit).
+     */
+    void flush();
+    void close();
+
+    /**
+     * @brief isOpen false until open() is called; after close() messages are still accepted but written
+     * synchronously.
+     */
+    bool isOpen() const { return m_opened.load(std::memory_order_acquire); }
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  protected:
+    void run() override;
+
+  private:
+    struct entry {
+        qint64 msecs = 0;
+        QtMsgType type = QtDebugMsg;
+        const char *file = nullptr; // __FILE__ and Q_FUNC_INFO literals, they outlive the queue
+        const char *function = nullptr;
+        QString msg;
+    };
+    struct cell {
+        std::atomic<size_t> sequence;
+        entry data;
+    };
+
+    logwriter();
+    static QString format(const entry &e, const QString &date);
+    bool pop(entry &e);
+    void drain();
+    void rotate();
+    QString rotatedName(int index) const;
+
+    std::vector<cell> m_queue;
+    std::atomic<size_t> m_enqueuePos{0};
+    size_t m_dequeuePos = 0; // writer thread only
+    std::atomic<quint64> m_dropped{0};
+    quint64 m_droppedReported = 0;
+
+    QString m_filename;
+    QFile m_file;
+    bool m_echo = false;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_closed{false};
+    std::atomic<bool> m_opened{false};
+
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_drained;
+    bool m_flushRequested = false;
+};
+
+#endif // LOGWRITER_H
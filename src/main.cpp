@@ -12,8 +12,12 @@
 #include "bluetooth.h"
 #include "domyostreadmill.h"
 #include "homeform.h"
+#include "latencytrace.h"
+#include "logwriter.h"
 #include "mainwindow.h"
 #include "qfit.h"
+#include "qzdebug.h"
+#include "qzsettingscache.h"
 #include "virtualtreadmill.h"
 #include <QDir>
 #include <QGuiApplication>
@@ -220,8 +224,10 @@ QCoreApplication *createApplication(int &argc, char *argv[]) {
 
 void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
 
-    QSettings settings;
-    static bool logdebug = settings.value(QZSettings::log_debug, QZSettings::default_log_debug).toBool();
+    static bool logdebug = []() {
+        QSettings settings;
+        return settings.value(QZSettings::log_debug, QZSettings::default_log_debug).toBool();
+    }();
 #if defined(Q_OS_LINUX) // Linux OS does not read settings file for now
     if ((logs == false && !forceQml) || (logdebug == false && forceQml))
 #else
@@ -229,40 +235,19 @@ void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QS
 #endif
         return;
 
-    // QByteArray localMsg = msg.toLocal8Bit(); // NOTE: clazy-unused-non-trivial-variable
-    const char *file = context.file ? context.file : "";
-    const char *function = context.function ? context.function : "";
-    QString txt = QDateTime::currentDateTime().toString() + QStringLiteral(" ") +
-                  QString::number(QDateTime::currentMSecsSinceEpoch()) + QStringLiteral(" ");
-    switch (type) {
-    case QtInfoMsg:
-        txt += QStringLiteral("Info: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
-        break;
-    case QtDebugMsg:
-        txt += QStringLiteral("Debug: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
-        break;
-    case QtWarningMsg:
-        txt += QStringLiteral("Warning: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
-        break;
-    case QtCriticalMsg:
-        txt += QStringLiteral("Critical: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
-        break;
-    case QtFatalMsg:
-        txt += QStringLiteral("Fatal: %1 %2 %3\n").arg(file, function, msg); // NOTE: clazy-qstring-arg
-        abort();
-    }
-
     if (logs == true || logdebug == true) {
 
-        QString path = homeform::getWritableAppDir();
-
-        // Linux log files are generated on binary location
-
-        QFile outFile(path + logfilename);
-        outFile.open(QIODevice::WriteOnly | QIODevice::Append);
-        QTextStream ts(&outFile);
-        ts << txt;
-        fprintf(stderr, "%s", txt.toLocal8Bit().constData());
+        // the file is written (and echoed to stderr) by the logwriter thread, this only queues the message
+        logwriter *writer = logwriter::instance();
+        if (!writer->isOpen()) {
+            // Linux log files are generated on binary location
+            writer->open(homeform::getWritableAppDir() + logfilename, true);
+        }
+        writer->push(type, context.file, context.function, msg);
+        if (type == QtFatalMsg) {
+            writer->flush();
+            abort();
+        }
     }
     (*QT_DEFAULT_MESSAGE_HANDLER)(type, context, msg);
 }
@@ -340,7 +325,22 @@ int main(int argc, char *argv[]) {
     }
 #endif
 
+    // load the settings snapshot used on the hot paths once the organization name is known
+    QZSettingsCache::instance();
+
+    // the qz.* categories follow the same switch as myMessageOutput, so disabled lines are not even formatted
+    {
+        const bool logdebug = settings.value(QZSettings::log_debug, QZSettings::default_log_debug).toBool();
+#if defined(Q_OS_LINUX)
+        qzdebug::setEnabled(forceQml ? logdebug : logs);
+#else
+        qzdebug::setEnabled(logdebug);
+#endif
+    }
+    latencytrace::setEnabled(settings.value(QZSettings::latency_trace, QZSettings::default_latency_trace).toBool());
+
     qInstallMessageHandler(myMessageOutput);
+    qAddPostRoutine([]() { logwriter::instance()->close(); });
     qDebug() << QStringLiteral("version ") << app->applicationVersion();
     foreach (QString s, settings.allKeys()) {
         if (!s.contains(QStringLiteral("password"))) {
@@ -357,7 +357,7 @@ int main(int argc, char *argv[]) {
 #endif
 
 #if 0 // test gpx or fit export
-    QList<SessionLine> l;
+    sessionstore l;
     for(int i =0; i< 500; i++)
     {
         QDateTime d = QDateTime::currentDateTime();
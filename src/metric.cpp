@@ -2,6 +2,9 @@
 #include "qdebugfixup.h"
 #include <QSettings>
 #include "qzsettings.h"
+#include "qzsettingscache.h"
+#include <QElapsedTimer>
+#include <algorithm>
 
 #ifdef TEST
 static uint32_t random_value_uint32 = 0;
@@ -10,43 +13,52 @@ static uint8_t random_value_uint8 = 0;
 
 metric::metric() {}
 
+static qint64 monotonicMSecs() {
+    static const QElapsedTimer timer = []() {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return timer.elapsed();
+}
+
 void metric::setType(_metric_type t) { m_type = t; }
 
 void metric::setValue(double v, bool applyGainAndOffset) {
-    QSettings settings;
     if (applyGainAndOffset) {
+        const QZSettingsCache &settings = *QZSettingsCache::instance();
         if (m_type == METRIC_WATT) {
             if (v > 0) {
-                if (settings.value(QZSettings::watt_gain, QZSettings::default_watt_gain).toDouble() <= 2.00) {
-                    if (settings.value(QZSettings::watt_gain, QZSettings::default_watt_gain).toDouble() != 1.0) {
+                double watt_gain = settings.toDouble(QZSettings::watt_gain, QZSettings::default_watt_gain);
+                double watt_offset = settings.toDouble(QZSettings::watt_offset, QZSettings::default_watt_offset);
+                if (watt_gain <= 2.00) {
+                    if (watt_gain != 1.0) {
                         qDebug() << QStringLiteral("watt value was ") << v
-                                 << QStringLiteral("but it will be transformed to")
-                                 << v * settings.value(QZSettings::watt_gain, QZSettings::default_watt_gain).toDouble();
+                                 << QStringLiteral("but it will be transformed to") << v * watt_gain;
                     }
-                    v *= settings.value(QZSettings::watt_gain, QZSettings::default_watt_gain).toDouble();
+                    v *= watt_gain;
                 }
-                if (settings.value(QZSettings::watt_offset, QZSettings::default_watt_offset).toDouble() < 0) {
-                    if (settings.value(QZSettings::watt_offset, QZSettings::default_watt_offset).toDouble() != 0.0) {
+                if (watt_offset < 0) {
+                    if (watt_offset != 0.0) {
                         qDebug() << QStringLiteral("watt value was ") << v
-                                 << QStringLiteral("but it will be transformed to")
-                                 << v + settings.value(QZSettings::watt_offset, QZSettings::default_watt_offset).toDouble();
+                                 << QStringLiteral("but it will be transformed to") << v + watt_offset;
                     }
-                    v += settings.value(QZSettings::watt_offset, QZSettings::default_watt_offset).toDouble();
+                    v += watt_offset;
                 }
             }
         } else if (m_type == METRIC_SPEED) {
             if (v > 0) {
-                v *= settings.value(QZSettings::speed_gain, QZSettings::default_speed_gain).toDouble();
-                v += settings.value(QZSettings::speed_offset, QZSettings::default_speed_offset).toDouble();
+                v *= settings.toDouble(QZSettings::speed_gain, QZSettings::default_speed_gain);
+                v += settings.toDouble(QZSettings::speed_offset, QZSettings::default_speed_offset);
             }
         }
     }
 
-    QDateTime now = QDateTime::currentDateTime();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
     if (v != m_value) {
-        if (m_last5.count() > 1) {
+        if (m_last5Count > 1) {
             double diff = v - m_value;
-            double diffFromLastValue = qAbs(now.msecsTo(m_lastChanged));
+            double diffFromLastValue = qAbs(now - m_lastChanged);
             if (diffFromLastValue > 0)
                 m_rateAtSec = diff * (1000.0 / diffFromLastValue);
             else
@@ -61,15 +73,25 @@ void metric::setValue(double v, bool applyGainAndOffset) {
         return;
     }
 
+    if (m_windows) {
+        updateWindows(value());
+    }
+
+    m_countAllValue++;
     if (value() != 0) {
         m_countValue++;
         m_lapCountValue++;
         m_totValue += value();
         m_lapTotValue += value();
-        m_last5.append(value());
-
-        if (m_last5.count() > 5)
-            m_last5.removeAt(0);
+        if (m_last5Count == LAST5_SIZE) {
+            m_last5Sum -= m_last5[m_last5Index];
+        } else {
+            m_last5Count++;
+        }
+        double last = value();
+        m_last5[m_last5Index] = last;
+        m_last5Sum += last;
+        m_last5Index = (m_last5Index + 1) % LAST5_SIZE;
 
         if (value() < m_min) {
             m_min = value();
@@ -96,8 +118,14 @@ void metric::clear(bool accumulator) {
     m_max = 0;
     m_totValue = 0;
     m_countValue = 0;
+    m_countAllValue = 0;
     m_min = 999999999;
-    m_last5.clear();
+    m_last5Count = 0;
+    m_last5Index = 0;
+    m_last5Sum = 0;
+    if (m_windows) {
+        clearWindows();
+    }
     clearLap(accumulator);
 #ifdef TEST
     random_value_uint8 = 0;
@@ -105,7 +133,7 @@ void metric::clear(bool accumulator) {
 #endif
 }
 
-double metric::value() {
+double metric::value() const {
 #ifdef TEST
     if (m_type != METRIC_ELAPSED) {
         return (double)(rand() % 256);
@@ -117,9 +145,9 @@ double metric::value() {
     return m_value - m_offset;
 }
 
-double metric::lapValue() { return m_value - m_lapOffset; }
+double metric::lapValue() const { return m_value - m_lapOffset; }
 
-double metric::average() {
+double metric::average() const {
     if (m_countValue == 0) {
         return 0;
     } else {
@@ -127,7 +155,7 @@ double metric::average() {
     }
 }
 
-double metric::lapAverage() {
+double metric::lapAverage() const {
     if (m_lapCountValue == 0) {
         return 0;
     } else {
@@ -135,39 +163,31 @@ double metric::lapAverage() {
     }
 }
 
-double metric::average5s() {
-    if (m_last5.count() == 0)
+double metric::average5s() const {
+    if (m_last5Count == 0)
         return 0;
-    else {
-        double sum = 0;
-        uint8_t c = 0;
-        QMutableListIterator<double> i(m_last5);
-        while (i.hasNext()) {
-            double b = i.next();
-            sum += b;
-            c++;
-        }
-
-        if (c > 0)
-            return (sum / c);
-        else
-            return 0;
-    }
+    return (m_last5Sum / m_last5Count);
 }
 
 void metric::operator=(double v) { setValue(v); }
 
 void metric::operator+=(double v) { setValue(m_value + v); }
 
-double metric::min() { return m_min; }
+double metric::min() const { return m_min; }
 
-double metric::max() { return m_max; }
+double metric::max() const { return m_max; }
 
-double metric::lapMin() { return m_lapMin; }
+double metric::lapMin() const { return m_lapMin; }
 
-double metric::lapMax() { return m_lapMax; }
+double metric::lapMax() const { return m_lapMax; }
 
-void metric::setPaused(bool p) { paused = p; }
+void metric::setPaused(bool p) {
+    paused = p;
+    // the paused time must not flush the windows on resume
+    if (!p && m_windows) {
+        m_windows->currentSecond = -1;
+    }
+}
 
 void metric::clearLap(bool accumulator) {
     if (accumulator) {
@@ -181,6 +201,137 @@ void metric::clearLap(bool accumulator) {
 
 void metric::setLap(bool accumulator) { clearLap(accumulator); }
 
+int metric::windowIndex(uint16_t seconds) const {
+    if (!m_windows) {
+        return -1;
+    }
+    for (int i = 0; i < (int)m_windows->windows.size(); i++) {
+        if (m_windows->windows.at(i).seconds == seconds) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void metric::addWindow(uint16_t seconds) {
+    if (seconds == 0 || windowIndex(seconds) >= 0) {
+        return;
+    }
+    if (!m_windows) {
+        m_windows = new metricwindows();
+    }
+    metricwindows::window w;
+    w.seconds = seconds;
+    w.sums.assign(seconds, 0);
+    w.counts.assign(seconds, 0);
+    m_windows->windows.push_back(w);
+}
+
+double metric::windowAverage(uint16_t seconds) const {
+    int i = windowIndex(seconds);
+    if (i < 0) {
+        return 0;
+    }
+    const metricwindows::window &win = m_windows->windows.at(i);
+    // the buckets updateWindows() would expire if a sample came now
+    const qint64 elapsedSeconds =
+        (paused || m_windows->currentSecond < 0) ? 0 : monotonicMSecs() / 1000 - m_windows->currentSecond;
+    if (elapsedSeconds <= 0) {
+        return win.average();
+    }
+    if (elapsedSeconds >= win.seconds) {
+        return 0;
+    }
+    double sum = win.sum;
+    uint32_t count = win.count;
+    for (qint64 s = 1; s <= elapsedSeconds; s++) {
+        const int b = (win.head + s) % win.seconds;
+        sum -= win.sums.at(b);
+        count -= win.counts.at(b);
+    }
+    return count ? sum / count : 0;
+}
+
+void metric::enableNormalizedPower() {
+    addWindow(30);
+    m_windows->normalizedPowerWindow = windowIndex(30);
+}
+
+double metric::normalizedPower() const {
+    if (!m_windows || m_windows->normalizedPowerCount == 0) {
+        return 0;
+    }
+    return pow(m_windows->normalizedPowerSum / m_windows->normalizedPowerCount, 0.25);
+}
+
+double metric::variabilityIndex() const {
+    // average() skips the zeros, but the seconds spent coasting lower the average power
+    double avg = m_countAllValue > 0 ? m_totValue / m_countAllValue : 0;
+    if (avg <= 0) {
+        return 0;
+    }
+    return normalizedPower() / avg;
+}
+
+void metric::updateWindows(double v) {
+    metricwindows *w = m_windows.data();
+    qint64 second = monotonicMSecs() / 1000;
+    if (w->currentSecond < 0) {
+        w->currentSecond = second;
+    }
+    qint64 elapsedSeconds = second - w->currentSecond;
+
+    if (elapsedSeconds > 0) {
+        if (w->normalizedPowerWindow >= 0) {
+            const metricwindows::window &np = w->windows.at(w->normalizedPowerWindow);
+            // the rolling average holds until the buckets expire, after that the window is empty
+            qint64 held = qMin<qint64>(elapsedSeconds, np.seconds);
+            // the first 30 seconds only fill the window
+            qint64 warmup = qMin<qint64>(elapsedSeconds, np.seconds - w->normalizedPowerWarmup);
+            w->normalizedPowerWarmup += warmup;
+            w->normalizedPowerSum += qMax<qint64>(0, held - warmup) * pow(np.average(), 4);
+            w->normalizedPowerCount += elapsedSeconds - warmup;
+        }
+
+        for (metricwindows::window &win : w->windows) {
+            qint64 steps = qMin<qint64>(elapsedSeconds, win.seconds);
+            for (qint64 i = 0; i < steps; i++) {
+                win.head = (win.head + 1) % win.seconds;
+                win.sum -= win.sums.at(win.head);
+                win.count -= win.counts.at(win.head);
+                win.sums[win.head] = 0;
+                win.counts[win.head] = 0;
+            }
+            if (win.count == 0) {
+                win.sum = 0;
+            }
+        }
+        w->currentSecond = second;
+    }
+
+    for (metricwindows::window &win : w->windows) {
+        win.sums[win.head] += v;
+        win.counts[win.head]++;
+        win.sum += v;
+        win.count++;
+    }
+}
+
+void metric::clearWindows() {
+    metricwindows *w = m_windows.data();
+    for (metricwindows::window &win : w->windows) {
+        std::fill(win.sums.begin(), win.sums.end(), 0);
+        std::fill(win.counts.begin(), win.counts.end(), 0);
+        win.head = 0;
+        win.sum = 0;
+        win.count = 0;
+    }
+    w->currentSecond = -1;
+    w->normalizedPowerWarmup = 0;
+    w->normalizedPowerSum = 0;
+    w->normalizedPowerCount = 0;
+}
+
 double metric::calculateMaxSpeedFromPower(double power, double inclination) {
     QSettings settings;
     double rolling_resistance = settings.value(QZSettings::rolling_resistance, QZSettings::default_rolling_resistance).toFloat();
@@ -255,71 +406,18 @@ double metric::calculateWeightLoss(double kcal) {
     return kcal / 7716.1854; // comes from 1 lbs = 3500 kcal. Converted to kg
 }
 
-struct IntervalBest {
-    double avg = 0;
-    int64_t start = 0;
-    int64_t stop = 0;
-};
-
-struct CompareBests {
-    // Sort by decreasing power and increasing start time.
-    bool operator()(const IntervalBest &a, const IntervalBest &b) const {
-        if (a.avg > b.avg)
-            return true;
-        if (b.avg > a.avg)
-            return false;
-        return a.start < b.start;
-    }
-};
-
 // VO2 (L/min) = 0.0108 x power (W) + 0.007 x body mass (kg)
 // power = 5 min peak power for a specific ride
-double metric::calculateVO2Max(QList<SessionLine> *session) {
-    QList<IntervalBest> bests;
-    QList<IntervalBest> _results;
-
-    uint windowSize = 5 * 60; // 5 mins
-    double total = 0.0;
-    QList<const SessionLine *> window;
-
-    if (session->count() == 0)
-        return -1;
+double metric::calculateVO2Max(const powercurve &curve) {
+    double peak = curve.best(5 * 60);
 
     // ride is shorter than the window size!
-    if (windowSize > session->last().elapsedTime)
+    if (peak <= 0)
         return -1;
 
-    int i = 0;
-    // We're looking for intervals with durations in [windowSizeSecs, windowSizeSecs + secsDelta).
-    foreach (SessionLine point, *session) {
-
-        total += point.watt;
-        window.append(&session->at(i));
-        double duration = window.last()->elapsedTime - window.first()->elapsedTime;
-
-        if (duration >= windowSize) {
-            double start = window.first()->elapsedTime;
-            double stop = window.last()->elapsedTime;
-            double avg = total / duration;
-            IntervalBest b;
-            b.start = start;
-            b.stop = stop;
-            b.avg = avg;
-            bests.append(b);
-
-            total -= window.first()->watt;
-            window.removeFirst();
-        }
-        i++;
-    }
-
-    std::sort(bests.begin(), bests.end(), CompareBests());
-
-    double peak = bests.first().avg;
     QSettings settings;
-    return ((0.0108 * peak + 0.007 * settings.value(QZSettings::weight, QZSettings::default_weight).toFloat()) /
-            settings.value(QZSettings::weight, QZSettings::default_weight).toFloat()) *
-           1000.0;
+    double weight = settings.value(QZSettings::weight, QZSettings::default_weight).toFloat();
+    return ((0.0108 * peak + 0.007 * weight) / weight) * 1000.0;
 }
 
 double metric::calculateKCalfromHR(double HR_AVG, double elapsed) {
@@ -1,10 +1,48 @@
 #ifndef METRIC_H
 #define METRIC_H
 
+#include "powercurve.h"
 #include "qdebugfixup.h"
 #include "sessionline.h"
 #include <QDateTime>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QVector>
 #include <math.h>
+#include <vector>
+
+/**
+ * @brief The metricwindows class holds the time based rolling windows registered on a metric
+ * with metric::addWindow(). Each window keeps one bucket per second, so a sample is added in O(1).
+ * It is implicitly shared: copying a metric only takes a reference, and the copy that is written first detaches.
+ */
+class metricwindows : public QSharedData {
+  public:
+    struct window {
+        uint16_t seconds = 0;
+        uint16_t head = 0;
+        std::vector<double> sums; // std::vector: no implicit sharing, a write never has to detach
+        std::vector<uint32_t> counts;
+        double sum = 0;
+        uint32_t count = 0;
+        double average() const { return count ? sum / count : 0; }
+    };
+
+    std::vector<window> windows;
+
+    /**
+     * @brief currentSecond The monotonic second the head buckets refer to, -1 until the first sample.
+     */
+    qint64 currentSecond = -1;
+
+    /**
+     * @brief Normalized Power: the 30s rolling average sampled once per second, raised to the 4th power and averaged.
+     */
+    int normalizedPowerWindow = -1;
+    uint16_t normalizedPowerWarmup = 0;
+    double normalizedPowerSum = 0;
+    quint64 normalizedPowerCount = 0;
+};
 
 class metric {
 
@@ -20,21 +58,49 @@ class metric {
     metric();
     void setType(_metric_type t);
     void setValue(double value, bool applyGainAndOffset = true);
-    double value();
-    QDateTime lastChanged() {return m_lastChanged;}
-    double average();
-    double average5s();
+    double value() const;
+    QDateTime lastChanged() const { return QDateTime::fromMSecsSinceEpoch(m_lastChanged); }
+    qint64 lastChangedMSecs() const { return m_lastChanged; }
+    double average() const;
+    double average5s() const;
 
     // rate of the current metric in a second, useful to know how many Kcal i will burn in a
     // minute if i keep the current pace
-    double rate1s() { return m_rateAtSec; }
-
-    double min();
-    double max();
-    double lapValue();
-    double lapAverage();
-    double lapMin();
-    double lapMax();
+    double rate1s() const { return m_rateAtSec; }
+
+    double min() const;
+    double max() const;
+    double lapValue() const;
+    double lapAverage() const;
+    double lapMin() const;
+    double lapMax() const;
+
+    /**
+     * @brief addWindow Registers a rolling window over the last `seconds` seconds (monotonic clock).
+     * Every following sample is added to it in O(1), see windowAverage().
+     */
+    void addWindow(uint16_t seconds);
+
+    /**
+     * @brief windowAverage Average of the samples of the last `seconds` seconds, 0 if the window isn't registered.
+     * The seconds without samples are aged out on read, so the window empties when the samples stop.
+     */
+    double windowAverage(uint16_t seconds) const;
+
+    /**
+     * @brief enableNormalizedPower Registers the 30s window and starts accumulating the Normalized Power.
+     */
+    void enableNormalizedPower();
+
+    /**
+     * @brief normalizedPower The Normalized Power of the session. Units: same as the metric (watts)
+     */
+    double normalizedPower() const;
+
+    /**
+     * @brief variabilityIndex Normalized Power divided by the average power, the zero samples (coasting) included.
+     */
+    double variabilityIndex() const;
     void clearLap(bool accumulator);
     void clear(bool accumulator);
     void operator=(double);
@@ -46,17 +112,26 @@ class metric {
     static double calculatePowerFromSpeed(double speed, double inclination);
     static double calculateSpeedFromPower(double power, double inclination, double speed, double deltaTimeSeconds, double speedLimit);
     static double calculateWeightLoss(double kcal);
-    static double calculateVO2Max(QList<SessionLine> *session);
+    static double calculateVO2Max(const powercurve &curve);
     static double calculateKCalfromHR(double HR_AVG, double elapsed);
 
   private:
     double m_value = 0;
     double m_totValue = 0;
     double m_countValue = 0;
+    // the samples counted by m_countValue plus the zeros
+    double m_countAllValue = 0;
     double m_min = 999999999;
     double m_max = 0;
     double m_offset = 0;
-    QList<double> m_last5;
+
+    // last 5 samples in a fixed ring buffer with a running sum, so copying a metric doesn't allocate
+    // and average5s() is O(1)
+    static constexpr uint8_t LAST5_SIZE = 5;
+    double m_last5[LAST5_SIZE] = {0, 0, 0, 0, 0};
+    double m_last5Sum = 0;
+    uint8_t m_last5Count = 0;
+    uint8_t m_last5Index = 0;
 
     double m_lapOffset = 0;
     double m_lapTotValue = 0;
@@ -64,12 +139,19 @@ class metric {
     double m_lapMin = 999999999;
     double m_lapMax = 0;
 
-    QDateTime m_lastChanged = QDateTime::currentDateTime();
+    qint64 m_lastChanged = QDateTime::currentMSecsSinceEpoch();
     double m_rateAtSec = 0;
 
     _metric_type m_type = METRIC_OTHER;
 
     bool paused = false;
+
+    // null unless a window has been registered, so the metrics without windows copy no more than their members
+    QSharedDataPointer<metricwindows> m_windows;
+
+    int windowIndex(uint16_t seconds) const;
+    void updateWindows(double v);
+    void clearWindows();
 };
 
 #endif // METRIC_H
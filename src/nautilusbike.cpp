@@ -1,4 +1,5 @@
 #include "nautilusbike.h"
+#include "qzsettingscache.h"
 
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -133,7 +134,7 @@ void nautilusbike::characteristicChanged(const QLowEnergyCharacteristic &charact
 
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     double weight = settings.value(QZSettings::weight, QZSettings::default_weight).toFloat();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
@@ -0,0 +1,37 @@
+#include "notificationscheduler.h"
+#include "qzsettings.h"
+#include "qzsettingscache.h"
+
+NotificationScheduler::NotificationScheduler(QObject *parent) : QObject(parent) {
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &NotificationScheduler::sample);
+}
+
+void NotificationScheduler::start(bluetoothdevice *device) {
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
+    const int rate = qBound(1,
+                            settings.toInt(QZSettings::virtual_device_notification_rate,
+                                           QZSettings::default_virtual_device_notification_rate),
+                            20);
+    const int period = 1000 / rate;
+    keepAliveMs = qMax(period, settings.toInt(QZSettings::virtual_device_keepalive_ms,
+                                              QZSettings::default_virtual_device_keepalive_ms));
+
+    this->device = device;
+    last.reset();
+    qDebug() << QStringLiteral("notification scheduler: up to") << rate << QStringLiteral("Hz, keep-alive")
+             << keepAliveMs << QStringLiteral("ms");
+    timer.start(period);
+}
+
+void NotificationScheduler::stop() { timer.stop(); }
+
+void NotificationScheduler::sample() {
+    CharacteristicSnapshot snapshot(device);
+    if (last && *last == snapshot && sinceNotify.elapsed() < keepAliveMs)
+        return;
+
+    last = snapshot;
+    sinceNotify.start();
+    emit notify(*last);
+}
@@ -0,0 +1,44 @@
+#ifndef NOTIFICATIONSCHEDULER_H
+#define NOTIFICATIONSCHEDULER_H
+
+#include "characteristicsnapshot.h"
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+#include <optional>
+
+/**
+ * @brief The NotificationScheduler class decides when a virtual device sends its notifications.
+ * The devices don't signal their updates, so the metrics are sampled at the maximum rate
+ * (virtual_device_notification_rate) and notify() is emitted only when one of the advertised values changed, or
+ * when nothing changed for the keep-alive interval (virtual_device_keepalive_ms). The updates received between two
+ * samples are sent in one frame, built from the snapshot passed with notify().
+ */
+class NotificationScheduler : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit NotificationScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief start Starts sampling the device with the current settings. Calling it again restarts the schedule.
+     */
+    void start(bluetoothdevice *device);
+    void stop();
+
+  signals:
+    void notify(const CharacteristicSnapshot &snapshot);
+
+  private slots:
+    void sample();
+
+  private:
+    bluetoothdevice *device = nullptr;
+    QTimer timer;
+    QElapsedTimer sinceNotify;
+    int keepAliveMs = 1000;
+    std::optional<CharacteristicSnapshot> last;
+};
+
+#endif // NOTIFICATIONSCHEDULER_H
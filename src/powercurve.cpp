@@ -0,0 +1,46 @@
+#include "powercurve.h"
+
+const QVector<uint32_t> &powercurve::durations() {
+    static const QVector<uint32_t> d = {1, 5, 10, 15, 30, 60, 120, 300, 600, 1200, 1800, 3600};
+    return d;
+}
+
+powercurve::powercurve() { clear(); }
+
+void powercurve::clear() {
+    m_prefix.fill(0, durations().last() + 1);
+    m_bests.fill(0, durations().size());
+    m_total = 0;
+    m_samples = 0;
+}
+
+bool powercurve::append(double watt) {
+    const QVector<uint32_t> &d = durations();
+    const int size = m_prefix.size();
+    bool improved = false;
+
+    m_total += watt;
+    m_samples++;
+    m_prefix[m_samples % size] = m_total;
+
+    for (int i = 0; i < d.size(); i++) {
+        // durations are ascending, so the longer ones can't be reached either
+        if (d[i] > m_samples)
+            break;
+        const double avg = (m_total - m_prefix[(m_samples - d[i]) % size]) / d[i];
+        if (avg > m_bests[i]) {
+            m_bests[i] = avg;
+            improved = true;
+        }
+    }
+    return improved;
+}
+
+double powercurve::best(uint32_t seconds) const {
+    const int i = durations().indexOf(seconds);
+    if (i < 0)
+        return 0;
+    return m_bests[i];
+}
+
+QList<double> powercurve::bests() const { return m_bests.toList(); }
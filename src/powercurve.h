@@ -0,0 +1,48 @@
+#ifndef POWERCURVE_H
+#define POWERCURVE_H
+
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief The powercurve class keeps the mean-maximal power (best average watts) of a session for a fixed set
+ * of durations, from 1 second to 60 minutes. Samples are appended once per second; only the last hour of
+ * prefix sums is kept, so each sample costs O(number of durations) regardless of the session length.
+ */
+class powercurve {
+  public:
+    powercurve();
+
+    /**
+     * @brief durations The tracked durations in seconds, ascending.
+     */
+    static const QVector<uint32_t> &durations();
+
+    /**
+     * @brief append Adds the average power of the last second.
+     * @return true if at least one best effort improved
+     */
+    bool append(double watt);
+    void clear();
+
+    /**
+     * @brief best The best average power over the given duration, 0 if the duration is not tracked
+     * or the session is still shorter than it.
+     */
+    double best(uint32_t seconds) const;
+
+    /**
+     * @brief bests The best average power for each of durations(), 0 for the ones not reached yet.
+     */
+    QList<double> bests() const;
+
+    uint32_t samples() const { return m_samples; }
+
+  private:
+    QVector<double> m_prefix; // ring of running totals, m_prefix[n % size] = sum of the first n samples
+    QVector<double> m_bests;
+    double m_total = 0;
+    uint32_t m_samples = 0;
+};
+
+#endif // POWERCURVE_H
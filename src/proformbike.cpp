@@ -1,4 +1,5 @@
 #include "proformbike.h"
+#include "qzsettingscache.h"
 #include "ios/lockscreen.h"
 #include "keepawakehelper.h"
 #include "virtualbike.h"
@@ -632,9 +633,13 @@ void proformbike::serviceDiscovered(const QBluetoothUuid &gatt) {
 }
 
 void proformbike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
-    // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
-    Q_UNUSED(characteristic);
-    QSettings settings;
+    parseNotification(characteristic.uuid(), newValue);
+}
+
+void proformbike::parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue) {
+    // qDebug() << "characteristicChanged" << uuid << newValue << newValue.length();
+    Q_UNUSED(uuid);
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
     bool proform_studio = settings.value(QZSettings::proform_studio, QZSettings::default_proform_studio).toBool();
@@ -944,7 +949,7 @@ void proformbike::characteristicChanged(const QLowEnergyCharacteristic &characte
     emit debug(QStringLiteral("Last CrankEventTime: ") + QString::number(LastCrankEventTime));
     emit debug(QStringLiteral("Current Watt: ") + QString::number(watts()));
 
-    if (m_control->error() != QLowEnergyController::NoError) {
+    if (m_control && m_control->error() != QLowEnergyController::NoError) {
         qDebug() << QStringLiteral("QLowEnergyController ERROR!!") << m_control->errorString();
     }
 }
@@ -93,6 +93,11 @@ class proformbike : public bike {
 
   public slots:
     void deviceDiscovered(const QBluetoothDeviceInfo &device);
+    /**
+     * @brief parseNotification Decodes a notification of the characteristic uuid. characteristicChanged forwards
+     * here, the parser benchmark (src/test/test-bike) calls it directly.
+     */
+    void parseNotification(const QBluetoothUuid &uuid, const QByteArray &newValue);
 
   private slots:
 
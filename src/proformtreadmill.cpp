@@ -7,7 +7,6 @@
 #include <QFile>
 #include <QMetaEnum>
 #include <QSettings>
-#include <QThread>
 #include <chrono>
 #include <math.h>
 
@@ -26,25 +25,22 @@ proformtreadmill::proformtreadmill(bool noWriteResistance, bool noHeartService)
 
 void proformtreadmill::writeCharacteristic(uint8_t *data, uint8_t data_len, const QString &info, bool disable_log,
                                            bool wait_for_response) {
-    QEventLoop loop;
-    QTimer timeout;
-    if (wait_for_response) {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicChanged, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    } else {
-        connect(gattCommunicationChannelService, &QLowEnergyService::characteristicWritten, &loop, &QEventLoop::quit);
-        timeout.singleShot(300ms, &loop, &QEventLoop::quit);
-    }
-
-    gattCommunicationChannelService->writeCharacteristic(gattWriteCharacteristic,
-                                                         QByteArray((const char *)data, data_len));
-
     if (!disable_log) {
-        emit debug(QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
-                   QStringLiteral(" // ") + info);
+        qzEmitDebug(qzDeviceRaw, QStringLiteral(" >> ") + QByteArray((const char *)data, data_len).toHex(' ') +
+                                     QStringLiteral(" // ") + info);
     }
 
-    loop.exec();
+    writeQueue()->write(gattCommunicationChannelService, gattWriteCharacteristic,
+                        QByteArray((const char *)data, data_len), wait_for_response);
+}
+
+// moves the due target of a slot into the request field the model blocks of update() work on
+static bool takeTarget(commandslot &slot, double current, volatile double *request) {
+    double target;
+    if (!slot.take(current, &target))
+        return false;
+    *request = target;
+    return true;
 }
 
 void proformtreadmill::forceIncline(double incline) {
@@ -131,6 +127,21 @@ void proformtreadmill::update() {
         QSettings settings;
         update_metrics(true, watts(settings.value(QZSettings::weight, QZSettings::default_weight).toFloat()));
 
+        // the targets received since the last poll replace the pending ones: each model writes the newest
+        // one in its poll sequence, at most once per slot interval
+        if (requestInclination != -100) {
+            inclinationSlot.post(requestInclination);
+            requestInclination = -100;
+        }
+        if (requestSpeed != -1) {
+            speedSlot.post(requestSpeed);
+            requestSpeed = -1;
+        }
+
+        // the previous poll is still on its way: skip this one instead of piling up writes
+        if (writeQueue()->pending())
+            return;
+
         bool nordictrack10 = settings.value(QZSettings::nordictrack_10_treadmill, QZSettings::default_nordictrack_10_treadmill).toBool();
         bool nordictrack_s30_treadmill = settings.value(QZSettings::nordictrack_s30_treadmill, QZSettings::default_nordictrack_s30_treadmill).toBool();
         bool nordictrack_t65s_treadmill = settings.value(QZSettings::nordictrack_t65s_treadmill, QZSettings::default_nordictrack_t65s_treadmill).toBool();
@@ -199,7 +210,7 @@ void proformtreadmill::update() {
                 break;
             case 2:
                 writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("noOp"), true);
-                if (requestInclination != -100) {
+                if (takeTarget(inclinationSlot, currentInclination().value(), &requestInclination)) {
                     if (requestInclination < 0)
                         requestInclination = 0;
                     if (requestInclination != currentInclination().value() && requestInclination >= -3 &&
@@ -209,7 +220,7 @@ void proformtreadmill::update() {
                     }
                     requestInclination = -100;
                 }
-                if (requestSpeed != -1) {
+                if (takeTarget(speedSlot, currentSpeed().value(), &requestSpeed)) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
                         emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
@@ -279,7 +290,7 @@ void proformtreadmill::update() {
             case 3:
                 writeCharacteristic(noOpData4, sizeof(noOpData4), QStringLiteral("noOp"), true);
 
-                if (requestInclination != -100) {
+                if (takeTarget(inclinationSlot, currentInclination().value(), &requestInclination)) {
                     if (requestInclination < 0)
                         requestInclination = 0;
                     if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
@@ -289,7 +300,7 @@ void proformtreadmill::update() {
                     }
                     requestInclination = -100;
                 }
-                if (requestSpeed != -1) {
+                if (takeTarget(speedSlot, currentSpeed().value(), &requestSpeed)) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
                         emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
@@ -344,7 +355,7 @@ void proformtreadmill::update() {
                 break;
             case 2:
                 writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("noOp"));
-                if (requestInclination != -100) {
+                if (takeTarget(inclinationSlot, currentInclination().value(), &requestInclination)) {
                     if (requestInclination < 0)
                         requestInclination = 0;
                     if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
@@ -354,7 +365,7 @@ void proformtreadmill::update() {
                     }
                     requestInclination = -100;
                 }
-                if (requestSpeed != -1) {
+                if (takeTarget(speedSlot, currentSpeed().value(), &requestSpeed)) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
                         emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
@@ -414,7 +425,7 @@ void proformtreadmill::update() {
                 break;
             case 2:
                 writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("noOp"), false, true);
-                if (requestInclination != -100) {
+                if (takeTarget(inclinationSlot, currentInclination().value(), &requestInclination)) {
                     if (requestInclination < -3)
                         requestInclination = -3;
                     if (requestInclination != currentInclination().value() && requestInclination >= -3 &&
@@ -424,7 +435,7 @@ void proformtreadmill::update() {
                     }
                     requestInclination = -100;
                 }
-                if (requestSpeed != -1) {
+                if (takeTarget(speedSlot, currentSpeed().value(), &requestSpeed)) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
                         emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
@@ -487,7 +498,7 @@ void proformtreadmill::update() {
                 break;
             case 2:
                 writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("noOp"));
-                if (requestInclination != -100) {
+                if (takeTarget(inclinationSlot, currentInclination().value(), &requestInclination)) {
                     if (requestInclination < -3)
                         requestInclination = -3;
                     if (requestInclination != currentInclination().value() && requestInclination >= -3 &&
@@ -497,7 +508,7 @@ void proformtreadmill::update() {
                     }
                     requestInclination = -100;
                 }
-                if (requestSpeed != -1) {
+                if (takeTarget(speedSlot, currentSpeed().value(), &requestSpeed)) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
                         emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
@@ -563,7 +574,7 @@ void proformtreadmill::update() {
                 break;
             case 5:
                 writeCharacteristic(noOpData6, sizeof(noOpData6), QStringLiteral("noOp"));
-                if (requestInclination != -100) {
+                if (takeTarget(inclinationSlot, currentInclination().value(), &requestInclination)) {
                     if (requestInclination < 0)
                         requestInclination = 0;
                     if (requestInclination != currentInclination().value() && requestInclination >= 0 &&
@@ -573,7 +584,7 @@ void proformtreadmill::update() {
                     }
                     requestInclination = -100;
                 }
-                if (requestSpeed != -1) {
+                if (takeTarget(speedSlot, currentSpeed().value(), &requestSpeed)) {
                     if (requestSpeed != currentSpeed().value() && requestSpeed >= 0 && requestSpeed <= 22) {
                         emit debug(QStringLiteral("writing speed ") + QString::number(requestSpeed));
                         forceSpeed(requestSpeed);
@@ -801,49 +812,49 @@ void proformtreadmill::btinit() {
                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData7, sizeof(initData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData2, sizeof(noOpData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData5, sizeof(noOpData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData6, sizeof(noOpData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     } else*/
     if (nordictrack10) {
         uint8_t initData1[] = {0xfe, 0x02, 0x08, 0x02};
@@ -879,49 +890,49 @@ void proformtreadmill::btinit() {
                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData7, sizeof(initData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData2, sizeof(noOpData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData4, sizeof(noOpData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData5, sizeof(noOpData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData6, sizeof(noOpData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     } else if (proform_treadmill_9_0) {
         uint8_t initData1[] = {0xfe, 0x02, 0x08, 0x02};
         uint8_t initData2[] = {0xff, 0x08, 0x02, 0x04, 0x02, 0x04, 0x02, 0x04, 0x81, 0x87,
@@ -968,73 +979,73 @@ void proformtreadmill::btinit() {
                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData7, sizeof(initData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData4, sizeof(noOpData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData2, sizeof(noOpData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData5, sizeof(noOpData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData6, sizeof(noOpData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData7, sizeof(noOpData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData8, sizeof(noOpData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData9, sizeof(noOpData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData10, sizeof(noOpData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData11, sizeof(noOpData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData12, sizeof(noOpData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData9, sizeof(noOpData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData10, sizeof(noOpData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     } else if (nordictrack_t65s_treadmill) {
         uint8_t initData1[] = {0xfe, 0x02, 0x08, 0x02};
         uint8_t initData2[] = {0xff, 0x08, 0x02, 0x04, 0x02, 0x04, 0x02, 0x04, 0x81, 0x87,
@@ -1069,49 +1080,49 @@ void proformtreadmill::btinit() {
                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData7, sizeof(initData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData2, sizeof(noOpData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData4, sizeof(noOpData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData5, sizeof(noOpData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData6, sizeof(noOpData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     } else if (proform_treadmill_1800i) {
         uint8_t initData1[] = {0xfe, 0x02, 0x08, 0x02};
         uint8_t initData2[] = {0xff, 0x08, 0x02, 0x04, 0x02, 0x04, 0x02, 0x04, 0x81, 0x87,
@@ -1146,49 +1157,49 @@ void proformtreadmill::btinit() {
                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData7, sizeof(initData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData4, sizeof(noOpData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData5, sizeof(noOpData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData6, sizeof(noOpData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData2, sizeof(noOpData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     } else if (proform_treadmill_se) {
         uint8_t initData1[] = {0xfe, 0x02, 0x08, 0x02};
         uint8_t initData2[] = {0xff, 0x08, 0x02, 0x04, 0x02, 0x04, 0x02, 0x04, 0x81, 0x87,
@@ -1216,39 +1227,39 @@ void proformtreadmill::btinit() {
                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData2, sizeof(noOpData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     } else if (nordictrack_s30_treadmill) {
         uint8_t initData1[] = {0xfe, 0x02, 0x08, 0x02};
         uint8_t initData2[] = {0xff, 0x08, 0x02, 0x04, 0x02, 0x04, 0x02, 0x04, 0x81, 0x87,
@@ -1283,51 +1294,51 @@ void proformtreadmill::btinit() {
                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData7, sizeof(initData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData4, sizeof(noOpData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData2, sizeof(noOpData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData3, sizeof(noOpData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData4, sizeof(noOpData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData5, sizeof(noOpData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData6, sizeof(noOpData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(noOpData1, sizeof(noOpData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     } else {
         uint8_t initData1[] = {0xfe, 0x02, 0x08, 0x02};
         uint8_t initData2[] = {0xff, 0x08, 0x02, 0x04, 0x02, 0x04, 0x02, 0x04, 0x81, 0x87,
@@ -1352,37 +1363,37 @@ void proformtreadmill::btinit() {
                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData2, sizeof(initData2), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData3, sizeof(initData3), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData4, sizeof(initData4), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData6, sizeof(initData6), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData5, sizeof(initData5), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData7, sizeof(initData7), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData1, sizeof(initData1), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData8, sizeof(initData8), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData9, sizeof(initData9), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData10, sizeof(initData10), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData11, sizeof(initData11), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
         writeCharacteristic(initData12, sizeof(initData12), QStringLiteral("init"), false, false);
-        QThread::msleep(400);
+        writeQueue()->delay(400);
     }
 
     initDone = true;
@@ -26,6 +26,7 @@
 #include <QObject>
 #include <QString>
 
+#include "commandslot.h"
 #include "treadmill.h"
 #include "virtualbike.h"
 #include "virtualtreadmill.h"
@@ -59,6 +60,9 @@ class proformtreadmill : public treadmill {
     virtualbike *virtualBike = nullptr;
     uint8_t counterPoll = 0;
 
+    commandslot speedSlot{"speed", 1000, 0.1};
+    commandslot inclinationSlot{"inclination", 1000, 0.1};
+
     QLowEnergyService *gattCommunicationChannelService = nullptr;
     QLowEnergyCharacteristic gattWriteCharacteristic;
     QLowEnergyCharacteristic gattNotify1Characteristic;
@@ -53,6 +53,9 @@ INCLUDEPATH += qmdnsengine/src/include
 # deprecated API in order to know how to port your code away from it.
 DEFINES += QT_DEPRECATED_WARNINGS IO_UNDER_QT SMTP_BUILD
 
+# qmake CONFIG+=qz_strip_debug compiles out the qz.* per packet debug lines and signals (see qzdebug.h)
+qz_strip_debug: DEFINES += QZ_NO_DEBUG_OUTPUT
+
 
 # You can also make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
@@ -69,6 +72,7 @@ SOURCES += \
     characteristicnotifier2acc.cpp \
     characteristicnotifier2acd.cpp \
     characteristicnotifier2ad9.cpp \
+    characteristicsnapshot.cpp \
     fakeelliptical.cpp \
    faketreadmill.cpp \
    kmlworkout.cpp \
@@ -76,6 +80,7 @@ SOURCES += \
     nordictrackelliptical.cpp \
     nordictrackifitadbbike.cpp \
    nordictrackifitadbtreadmill.cpp \
+    notificationscheduler.cpp \
    octanetreadmill.cpp \
    proformellipticaltrainer.cpp \
    proformrower.cpp \
@@ -99,17 +104,21 @@ SOURCES += \
     activiotreadmill.cpp \
    bhfitnesselliptical.cpp \
    bike.cpp \
+   blewritequeue.cpp \
 	     bluetooth.cpp \
 		bluetoothdevice.cpp \
     characteristicnotifier2a37.cpp \
     characteristicnotifier2a63.cpp \
+    characteristicnotifier2ad1.cpp \
     characteristicnotifier2ad2.cpp \
     characteristicwriteprocessor2ad9.cpp \
    bowflext216treadmill.cpp \
     bowflextreadmill.cpp \
    chronobike.cpp \
+    commandslot.cpp \
     concept2skierg.cpp \
    cscbike.cpp \
+    devicenamematcher.cpp \
     dirconmanager.cpp \
     dirconpacket.cpp \
     dirconprocessor.cpp \
@@ -154,7 +163,9 @@ SOURCES += \
 	fit-sdk/fit_unicode.cpp \
 	flywheelbike.cpp \
 	ftmsbike.cpp \
+	ftmsdata.cpp \
     ftmsrower.cpp \
+    gattcache.cpp \
 	     gpx.cpp \
 		heartratebelt.cpp \
    homefitnessbuddy.cpp \
@@ -167,6 +178,8 @@ SOURCES += \
    keepbike.cpp \
    kingsmithr1protreadmill.cpp \
    kingsmithr2treadmill.cpp \
+   latencytrace.cpp \
+   logwriter.cpp \
 	     main.cpp \
    mcfbike.cpp \
 		metric.cpp \
@@ -176,17 +189,23 @@ SOURCES += \
    pafersbike.cpp \
    paferstreadmill.cpp \
    peloton.cpp \
+   powercurve.cpp \
    powerzonepack.cpp \
 	proformbike.cpp \
    proformelliptical.cpp \
 	proformtreadmill.cpp \
 	qfit.cpp \
+	qfitencoder.cpp \
+    qzdebug.cpp \
     qzsettings.cpp \
+    qzsettingscache.cpp \
    renphobike.cpp \
    rower.cpp \
 	schwinnic4bike.cpp \
    screencapture.cpp \
+	sessionjournal.cpp \
 	sessionline.cpp \
+	sessionstore.cpp \
    shuaa5treadmill.cpp \
 	signalhandler.cpp \
    simplecrypt.cpp \
@@ -253,6 +272,7 @@ HEADERS += \
     characteristicnotifier2acc.h \
     characteristicnotifier2acd.h \
     characteristicnotifier2ad9.h \
+    characteristicsnapshot.h \
     definitions.h \
     fakeelliptical.h \
    faketreadmill.h \
@@ -261,6 +281,7 @@ HEADERS += \
     nordictrackelliptical.h \
     nordictrackifitadbbike.h \
    nordictrackifitadbtreadmill.h \
+    notificationscheduler.h \
    octanetreadmill.h \
    proformellipticaltrainer.h \
    proformrower.h \
@@ -296,19 +317,23 @@ HEADERS += \
     activiotreadmill.h \
    bhfitnesselliptical.h \
    bike.h \
+   blewritequeue.h \
 	bluetooth.h \
 	bluetoothdevice.h \
     characteristicnotifier.h \
     characteristicnotifier2a37.h \
     characteristicnotifier2a63.h \
+    characteristicnotifier2ad1.h \
     characteristicnotifier2ad2.h \
     characteristicwriteprocessor.h \
     characteristicwriteprocessor2ad9.h \
    bowflext216treadmill.h \
     bowflextreadmill.h \
    chronobike.h \
+    commandslot.h \
     concept2skierg.h \
    cscbike.h \
+    devicenamematcher.h \
     dirconmanager.h \
     dirconpacket.h \
     dirconprocessor.h \
@@ -326,13 +351,16 @@ HEADERS += \
    filedownloader.h \
     fitmetria_fanfit.h \
    fitplusbike.h \
+    ftmsdata.h \
     ftmsrower.h \
+    gattcache.h \
    homefitnessbuddy.h \
     horizongr7bike.h \
    iconceptbike.h \
    keepbike.h \
    kingsmithr1protreadmill.h \
    kingsmithr2treadmill.h \
+   latencytrace.h \
    m3ibike.h \
         fitshowtreadmill.h \
 	fit-sdk/FitDecode.h \
@@ -560,6 +588,7 @@ HEADERS += \
 	inspirebike.h \
 	ios/lockscreen.h \
 	keepawakehelper.h \
+	logwriter.h \
 	macos/lockscreen.h \
         ios/M3iIOS-Interface.h \
 	material.h \
@@ -571,19 +600,25 @@ HEADERS += \
    pafersbike.h \
    paferstreadmill.h \
    peloton.h \
+   powercurve.h \
    powerzonepack.h \
 	proformbike.h \
    proformelliptical.h \
 	proformtreadmill.h \
     qdebugfixup.h \
 	qfit.h \
+	qfitencoder.h \
     qmdnsengine_export.h \
+    qzdebug.h \
     qzsettings.h \
+    qzsettingscache.h \
    renphobike.h \
    rower.h \
 	schwinnic4bike.h \
    screencapture.h \
+	sessionjournal.h \
 	sessionline.h \
+	sessionstore.h \
    shuaa5treadmill.h \
 	signalhandler.h \
    simplecrypt.h \
@@ -3,7 +3,7 @@
 
 #include "bluetoothdevice.h"
 #include "fit_profile.hpp"
-#include "sessionline.h"
+#include "sessionstore.h"
 #include <QFile>
 #include <QGeoCoordinate>
 #include <QObject>
@@ -16,9 +16,9 @@ class qfit : public QObject {
     Q_OBJECT
   public:
     explicit qfit(QObject *parent = nullptr);
-    static void save(const QString &filename, QList<SessionLine> session, bluetoothdevice::BLUETOOTH_TYPE type,
+    static void save(const QString &filename, const sessionstore &session, bluetoothdevice::BLUETOOTH_TYPE type,
                      uint32_t processFlag = QFIT_PROCESS_NONE, FIT_SPORT overrideSport = FIT_SPORT_INVALID);
-    static void open(const QString &filename, QList<SessionLine>* output);
+    static void open(const QString &filename, sessionstore *output);
     
   signals:
 };
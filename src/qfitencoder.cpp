@@ -0,0 +1,396 @@
+#include "qfitencoder.h"
+
+#include <QDebug>
+#include <QFile>
+#include <math.h>
+
+qfitencoder::qfitencoder(const QString &filename, bluetoothdevice::BLUETOOTH_TYPE type, uint32_t processFlag,
+                         FIT_SPORT overrideSport, QObject *parent)
+    : QObject(parent), filename(filename), type(type), processFlag(processFlag), overrideSport(overrideSport) {}
+
+qfitencoder::~qfitencoder() {
+    if (!done)
+        abort();
+    delete encode;
+    delete bufferEncode;
+}
+
+bool qfitencoder::isReal(const row &s) const {
+    return (s.speed > 0 && (type == bluetoothdevice::TREADMILL || type == bluetoothdevice::ELLIPTICAL)) ||
+           (s.cadence > 0 && (type == bluetoothdevice::BIKE || type == bluetoothdevice::ROWING));
+}
+
+void qfitencoder::write(const fit::Mesg &mesg) {
+    if (encode)
+        encode->Write(mesg);
+    else if (bufferEncode)
+        bufferEncode->Write(mesg);
+}
+
+bool qfitencoder::open(const row &first) {
+    firstTimeSecs = first.timeSecs;
+    firstTimeStamp = fit::DateTime((time_t)firstTimeSecs).GetTimeStamp();
+    startingDistanceOffset = first.distance;
+    return begin();
+}
+
+// starts the output from the header, dropping what was written before
+bool qfitencoder::begin() {
+    delete encode;
+    encode = nullptr;
+    delete bufferEncode;
+    bufferEncode = nullptr;
+    if (file.is_open())
+        file.close();
+    recordsWithoutPosition = 0;
+
+    if (filename.isEmpty()) {
+        bufferEncode = new fit::BufferEncode();
+        bufferEncode->Open();
+    } else {
+        file.open((filename + QStringLiteral(".part")).toStdString(),
+                  std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            qDebug() << QStringLiteral("qfitencoder: error opening") << filename;
+            return false;
+        }
+        encode = new fit::Encode(fit::ProtocolVersion::V20);
+        encode->Open(file);
+    }
+    opened = true;
+
+    fit::FileIdMesg fileIdMesg; // Every FIT file requires a File ID message
+    fileIdMesg.SetType(FIT_FILE_ACTIVITY);
+    fileIdMesg.SetManufacturer(FIT_MANUFACTURER_DEVELOPMENT);
+    fileIdMesg.SetProduct(1);
+    fileIdMesg.SetSerialNumber(12345);
+    fileIdMesg.SetTimeCreated(firstTimeSecs - 631065600L);
+    write(fileIdMesg);
+
+    fit::DeveloperDataIdMesg devIdMesg;
+    for (FIT_UINT8 i = 0; i < 16; i++) {
+
+        devIdMesg.SetApplicationId(i, i);
+    }
+    devIdMesg.SetDeveloperDataIndex(0);
+    write(devIdMesg);
+
+    lapMesg = fit::LapMesg();
+    lapMesg.SetIntensity(FIT_INTENSITY_ACTIVE);
+    lapMesg.SetStartTime(firstTimeSecs - 631065600L);
+    lapMesg.SetTimestamp(firstTimeSecs - 631065600L);
+    lapMesg.SetEvent(FIT_EVENT_WORKOUT);
+    lapMesg.SetEventType(FIT_EVENT_TYPE_STOP);
+    lapMesg.SetLapTrigger(FIT_LAP_TRIGGER_TIME);
+    lapMesg.SetTotalElapsedTime(0);
+    lapMesg.SetTotalTimerTime(0);
+    if (overrideSport != FIT_SPORT_INVALID) {
+
+        lapMesg.SetSport(FIT_SPORT_GENERIC);
+    } else if (type == bluetoothdevice::TREADMILL) {
+
+        lapMesg.SetSport(FIT_SPORT_RUNNING);
+    } else if (type == bluetoothdevice::ELLIPTICAL) {
+
+        lapMesg.SetSport(FIT_SPORT_RUNNING);
+    } else {
+
+        lapMesg.SetSport(FIT_SPORT_CYCLING);
+    }
+    return true;
+}
+
+void qfitencoder::addSample(const SessionLine &s) {
+    row r;
+    r.speed = s.speed;
+    r.distance = s.distance;
+    r.watt = s.watt;
+    r.resistance = s.resistance;
+    r.heart = s.heart;
+    r.cadence = s.cadence;
+    r.timeSecs = s.time.toSecsSinceEpoch();
+    r.calories = s.calories;
+    r.elevationGain = s.elevationGain;
+    r.elapsedTime = s.elapsedTime;
+    r.lapTrigger = s.lapTrigger;
+    r.coordinateValid = s.coordinate.isValid();
+    r.totalStrokes = s.totalStrokes;
+    r.avgStrokesRate = s.avgStrokesRate;
+    r.maxStrokesRate = s.maxStrokesRate;
+    r.avgStrokesLength = s.avgStrokesLength;
+    r.latitude = s.coordinate.latitude();
+    r.longitude = s.coordinate.longitude();
+    r.altitude = s.coordinate.altitude();
+    r.instantaneousStrideLengthCM = s.instantaneousStrideLengthCM;
+    r.groundContactMS = s.groundContactMS;
+    r.verticalOscillationMM = s.verticalOscillationMM;
+    addRow(r);
+}
+
+void qfitencoder::addStoredSample(const sessionstore &session, int i) {
+    row r;
+    r.speed = session.speed().at(i);
+    r.distance = session.distance().at(i);
+    r.watt = session.watt().at(i);
+    r.resistance = session.resistance().at(i);
+    r.heart = session.heart().at(i);
+    r.cadence = session.cadence().at(i);
+    r.timeSecs = session.time().at(i) / 1000;
+    r.calories = session.calories().at(i);
+    r.elevationGain = session.elevationGain().at(i);
+    r.elapsedTime = session.elapsedTime().at(i);
+    r.lapTrigger = session.lapTrigger().at(i);
+    r.coordinateValid = session.coordinateValid(i);
+    r.totalStrokes = session.totalStrokes().at(i);
+    r.avgStrokesRate = session.avgStrokesRate().at(i);
+    r.maxStrokesRate = session.maxStrokesRate().at(i);
+    r.avgStrokesLength = session.avgStrokesLength().at(i);
+    r.latitude = session.latitude().at(i);
+    r.longitude = session.longitude().at(i);
+    r.altitude = session.altitude().at(i);
+    r.instantaneousStrideLengthCM = session.instantaneousStrideLengthCM().at(i);
+    r.groundContactMS = session.groundContactMS().at(i);
+    r.verticalOscillationMM = session.verticalOscillationMM().at(i);
+    addRow(r);
+}
+
+void qfitencoder::addRow(const row &s) {
+    if (done)
+        return;
+
+    const uint32_t index = count++;
+    last = s;
+
+    if (!opened) {
+        // nothing is written until the device actually moves, like the old batch export
+        if (!isReal(s)) {
+            leading.append(sample(s, index));
+            return;
+        }
+        leading.clear();
+        if (!open(s)) {
+            done = true;
+            return;
+        }
+    }
+    process(s, index);
+}
+
+void qfitencoder::process(const row &s, uint32_t index) {
+    if (processFlag & QFIT_PROCESS_DISTANCENOISE) {
+        // spread 0.1 over the samples sharing the same distance, once the distance moves on
+        if (!run.isEmpty() && run.constFirst().first.distance != s.distance)
+            flushRun();
+        run.append(sample(s, index));
+    } else {
+        encodeRecord(s, index, s.distance);
+    }
+}
+
+void qfitencoder::flushRun() {
+    const int n = run.size();
+    for (int k = 0; k < n; k++) {
+        const sample &p = run.at(k);
+        encodeRecord(p.first, p.second, p.first.distance + 0.1 * k / n);
+    }
+    run.clear();
+}
+
+void qfitencoder::encodeRecord(const row &sl, uint32_t index, double distance) {
+    const bool coordinateValid = sl.coordinateValid;
+    if (coordinateValid) {
+        if (!gpsSeen && recordsWithoutPosition > 0) {
+            // a track whose first fix came late: start again without the records written before it
+            qDebug() << QStringLiteral("qfitencoder: first fix after") << recordsWithoutPosition
+                     << QStringLiteral("records without a position, restarting") << filename;
+            if (!begin()) {
+                done = true;
+                return;
+            }
+        }
+        gpsSeen = true;
+        if (minAltitude > sl.altitude)
+            minAltitude = sl.altitude;
+        if (maxAltitude < sl.altitude)
+            maxAltitude = sl.altitude;
+    }
+    if (maxElevationGain < sl.elevationGain)
+        maxElevationGain = sl.elevationGain;
+
+    // if a gps track contains a point without the gps information, it has to be discarded, otherwise the database
+    // structure is corrupted and 2 tracks are saved in the FIT file causing mapping issue.
+    if (!coordinateValid && (gpsTrack || gpsSeen)) {
+        return;
+    }
+
+    fit::RecordMesg newRecord;
+    newRecord.SetHeartRate(sl.heart);
+    newRecord.SetCadence(sl.cadence);
+    newRecord.SetDistance((distance - startingDistanceOffset) * 1000.0); // meters
+    newRecord.SetSpeed(sl.speed / 3.6);                                  // meter per second
+    newRecord.SetPower(sl.watt);
+    newRecord.SetResistance(sl.resistance);
+    newRecord.SetCalories(sl.calories);
+    if (type == bluetoothdevice::TREADMILL) {
+        newRecord.SetStepLength(sl.instantaneousStrideLengthCM * 10);
+        newRecord.SetVerticalOscillation(sl.verticalOscillationMM);
+        newRecord.SetStanceTime(sl.groundContactMS);
+    }
+
+    if (coordinateValid) {
+        newRecord.SetAltitude(sl.altitude);
+        newRecord.SetPositionLat(pow(2, 31) * (sl.latitude) / 180.0);
+        newRecord.SetPositionLong(pow(2, 31) * (sl.longitude) / 180.0);
+    } else {
+        newRecord.SetAltitude(sl.elevationGain);
+        recordsWithoutPosition++;
+    }
+
+    // using just the start point as reference in order to avoid pause time
+    // strava ignore the elapsed field
+    // this workaround could leads an accuracy issue.
+    newRecord.SetTimestamp(firstTimeStamp + index);
+    write(newRecord);
+
+    if (sl.lapTrigger) {
+
+        lapMesg.SetTotalElapsedTime(sl.elapsedTime - lapMesg.GetTotalElapsedTime());
+        lapMesg.SetTotalTimerTime(sl.elapsedTime - lapMesg.GetTotalTimerTime());
+
+        write(lapMesg);
+
+        lapMesg.SetStartTime(sl.timeSecs - 631065600L);
+        lapMesg.SetTimestamp(sl.timeSecs - 631065600L);
+        lapMesg.SetEvent(FIT_EVENT_WORKOUT);
+        lapMesg.SetEventType(FIT_EVENT_LAP);
+    }
+}
+
+bool qfitencoder::finish(FIT_SPORT sport) {
+    if (done) {
+        emit finished(filename, false);
+        return false;
+    }
+    if (sport != FIT_SPORT_INVALID)
+        overrideSport = sport;
+
+    if (!opened) {
+        // the device never moved: export everything, starting from the first sample
+        if (leading.isEmpty() || !open(leading.constFirst().first)) {
+            done = true;
+            emit finished(filename, false);
+            return false;
+        }
+        const QList<sample> l = leading;
+        leading.clear();
+        for (const sample &p : l)
+            process(p.first, p.second);
+    }
+    flushRun();
+
+    lapMesg.SetTotalElapsedTime(last.elapsedTime - lapMesg.GetTotalElapsedTime());
+    lapMesg.SetTotalTimerTime(last.elapsedTime - lapMesg.GetTotalTimerTime());
+    lapMesg.SetEvent(FIT_EVENT_LAP);
+    lapMesg.SetEventType(FIT_EVENT_TYPE_STOP);
+    write(lapMesg);
+
+    const qint64 lastTimeSecs = last.timeSecs;
+    if (!gpsTrack && !gpsSeen) {
+        minAltitude = 0;
+        maxAltitude = maxElevationGain;
+    }
+
+    fit::SessionMesg sessionMesg;
+    sessionMesg.SetTimestamp(firstTimeSecs - 631065600L);
+    sessionMesg.SetStartTime(firstTimeSecs - 631065600L);
+    sessionMesg.SetTotalElapsedTime(last.elapsedTime);
+    sessionMesg.SetTotalTimerTime(lastTimeSecs - firstTimeSecs);
+    sessionMesg.SetTotalDistance((last.distance - startingDistanceOffset) * 1000.0); // meters
+    sessionMesg.SetTotalCalories(last.calories);
+    sessionMesg.SetTotalMovingTime(last.elapsedTime);
+    sessionMesg.SetMinAltitude(minAltitude);
+    sessionMesg.SetMaxAltitude(maxAltitude);
+    sessionMesg.SetEvent(FIT_EVENT_SESSION);
+    sessionMesg.SetEventType(FIT_EVENT_TYPE_STOP);
+    sessionMesg.SetFirstLapIndex(0);
+    sessionMesg.SetTrigger(FIT_SESSION_TRIGGER_ACTIVITY_END);
+    sessionMesg.SetMessageIndex(FIT_MESSAGE_INDEX_RESERVED);
+
+    if (overrideSport != FIT_SPORT_INVALID) {
+        sessionMesg.SetSport(overrideSport);
+        sessionMesg.SetSubSport(FIT_SUB_SPORT_GENERIC);
+        qDebug() << "overriding FIT sport " << overrideSport;
+    } else if (type == bluetoothdevice::TREADMILL) {
+
+        sessionMesg.SetSport(FIT_SPORT_RUNNING);
+        sessionMesg.SetSubSport(FIT_SUB_SPORT_VIRTUAL_ACTIVITY);
+    } else if (type == bluetoothdevice::ELLIPTICAL) {
+
+        sessionMesg.SetSport(FIT_SPORT_RUNNING);
+        sessionMesg.SetSubSport(FIT_SUB_SPORT_VIRTUAL_ACTIVITY);
+    } else if (type == bluetoothdevice::ROWING) {
+
+        sessionMesg.SetSport(FIT_SPORT_ROWING);
+        sessionMesg.SetSubSport(FIT_SUB_SPORT_INDOOR_ROWING);
+        if (last.totalStrokes)
+            sessionMesg.SetTotalStrokes(last.totalStrokes);
+        if (last.avgStrokesRate)
+            sessionMesg.SetAvgStrokeCount(last.avgStrokesRate);
+        if (last.maxStrokesRate)
+            sessionMesg.SetMaxCadence(last.maxStrokesRate);
+        if (last.avgStrokesLength)
+            sessionMesg.SetAvgStrokeDistance(last.avgStrokesLength);
+    } else {
+
+        sessionMesg.SetSport(FIT_SPORT_CYCLING);
+        sessionMesg.SetSubSport(FIT_SUB_SPORT_VIRTUAL_ACTIVITY);
+    }
+    write(sessionMesg);
+
+    fit::ActivityMesg activityMesg;
+    activityMesg.SetTimestamp(firstTimeSecs - 631065600L);
+    activityMesg.SetTotalTimerTime(last.elapsedTime);
+    activityMesg.SetNumSessions(1);
+    activityMesg.SetType(FIT_ACTIVITY_MANUAL);
+    activityMesg.SetLocalTimestamp(fit::DateTime((time_t)lastTimeSecs)
+                                       .GetTimeStamp()); // seconds since 00:00 Dec d31 1989 in local time zone
+    activityMesg.SetEvent(FIT_EVENT_ACTIVITY);
+    activityMesg.SetEventType(FIT_EVENT_TYPE_STOP);
+    write(activityMesg);
+
+    const bool ok = close();
+    done = true;
+    emit finished(filename, ok);
+    return ok;
+}
+
+bool qfitencoder::close() {
+    if (bufferEncode) {
+        std::string s = bufferEncode->Close();
+        buffer = QByteArray(s.data(), (int)s.size());
+        return true;
+    }
+
+    if (!encode->Close()) {
+        qDebug() << QStringLiteral("qfitencoder: error closing encode") << filename;
+        file.close();
+        return false;
+    }
+    file.close();
+
+    QFile::remove(filename);
+    if (!QFile::rename(filename + QStringLiteral(".part"), filename)) {
+        qDebug() << QStringLiteral("qfitencoder: can't rename") << filename;
+        return false;
+    }
+    qDebug() << QStringLiteral("qfitencoder: encoded") << count << QStringLiteral("samples to") << filename;
+    return true;
+}
+
+void qfitencoder::abort() {
+    if (file.is_open()) {
+        file.close();
+        QFile::remove(filename + QStringLiteral(".part"));
+    }
+    done = true;
+}
@@ -0,0 +1,126 @@
+#ifndef QFITENCODER_H
+#define QFITENCODER_H
+
+#include "bluetoothdevice.h"
+#include "fit_buffer_encode.hpp"
+#include "fit_date_time.hpp"
+#include "fit_encode.hpp"
+#include "fit_profile.hpp"
+#include "qfit.h"
+#include "sessionline.h"
+#include "sessionstore.h"
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <fstream>
+
+/**
+ * @brief The qfitencoder class writes a FIT activity one sample at a time, so the records are encoded while
+ * riding and finish() only has to write the last lap and the session summary.
+ * With a file name the output goes through fit::Encode into "<filename>.part", renamed when finished;
+ * with an empty file name it goes through fit::BufferEncode and is returned by data().
+ * It has no thread affinity of its own: homeform moves it to a worker thread and feeds it with queued calls.
+ *
+ * A GPS track must not contain records without a position, otherwise the FIT file holds 2 tracks. When the first
+ * fix comes after records without a position have been written, the output is started again from the header: the
+ * records before the fix are dropped, as if the whole track had been known from the start.
+ */
+class qfitencoder : public QObject {
+    Q_OBJECT
+  public:
+    explicit qfitencoder(const QString &filename, bluetoothdevice::BLUETOOTH_TYPE type,
+                         uint32_t processFlag = QFIT_PROCESS_NONE, FIT_SPORT overrideSport = FIT_SPORT_INVALID,
+                         QObject *parent = nullptr);
+    ~qfitencoder() override;
+
+    /**
+     * @brief setGpsTrack Drops every record without a position from the first one on. When it is not known in
+     * advance, the first fix restarts the output and the records without a position are dropped from then on.
+     */
+    void setGpsTrack(bool gps) { gpsTrack = gps; }
+
+    /**
+     * @brief addStoredSample Same as addSample() for the sample i of a session store, read from the columns
+     * without building a SessionLine.
+     */
+    void addStoredSample(const sessionstore &session, int i);
+    const QString &fileName() const { return filename; }
+    const QByteArray &data() const { return buffer; }
+
+  public slots:
+    void addSample(const SessionLine &s);
+    bool finish(FIT_SPORT overrideSport = FIT_SPORT_INVALID);
+    void abort();
+
+  signals:
+    void finished(const QString &filename, bool ok);
+
+  private:
+    // the fields of a sample the FIT file needs, without the QDateTime and QGeoCoordinate of a SessionLine
+    struct row {
+        double speed = 0;
+        double distance = 0;
+        uint16_t watt = 0;
+        resistance_t resistance = 0;
+        uint8_t heart = 0;
+        uint8_t cadence = 0;
+        qint64 timeSecs = 0;
+        double calories = 0;
+        double elevationGain = 0;
+        uint32_t elapsedTime = 0;
+        bool lapTrigger = false;
+        bool coordinateValid = false;
+        uint32_t totalStrokes = 0;
+        double avgStrokesRate = 0;
+        double maxStrokesRate = 0;
+        double avgStrokesLength = 0;
+        double latitude = 0;
+        double longitude = 0;
+        double altitude = 0;
+        double instantaneousStrideLengthCM = 0;
+        double groundContactMS = 0;
+        double verticalOscillationMM = 0;
+    };
+    typedef QPair<row, uint32_t> sample;
+
+    void addRow(const row &r);
+    bool isReal(const row &s) const;
+    bool open(const row &first);
+    bool begin();
+    void process(const row &s, uint32_t index);
+    void flushRun();
+    void encodeRecord(const row &s, uint32_t index, double distance);
+    void write(const fit::Mesg &mesg);
+    bool close();
+
+    QString filename;
+    bluetoothdevice::BLUETOOTH_TYPE type;
+    uint32_t processFlag;
+    FIT_SPORT overrideSport;
+
+    std::fstream file;
+    fit::Encode *encode = nullptr;
+    fit::BufferEncode *bufferEncode = nullptr;
+    QByteArray buffer;
+
+    bool opened = false;
+    bool done = false;
+    bool gpsTrack = false;
+    bool gpsSeen = false;
+    uint32_t count = 0;
+    uint32_t recordsWithoutPosition = 0; // written since the output was started
+    QList<sample> leading; // samples before the first one with speed or cadence
+    QList<sample> run;     // QFIT_PROCESS_DISTANCENOISE: samples sharing the same distance
+    row last;
+
+    qint64 firstTimeSecs = 0;
+    FIT_DATE_TIME firstTimeStamp = 0;
+    double startingDistanceOffset = 0;
+    double minAltitude = 99999;
+    double maxAltitude = 0;
+    double maxElevationGain = 0;
+    fit::LapMesg lapMesg;
+};
+
+#endif // QFITENCODER_H
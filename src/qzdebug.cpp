@@ -0,0 +1,35 @@
+#include "qzdebug.h"
+
+#include <atomic>
+
+Q_LOGGING_CATEGORY(qzDevice, "qz.device")
+Q_LOGGING_CATEGORY(qzDeviceRaw, "qz.device.raw")
+Q_LOGGING_CATEGORY(qzDeviceMetrics, "qz.device.metrics")
+Q_LOGGING_CATEGORY(qzDircon, "qz.dircon")
+
+namespace {
+
+std::atomic<bool> enabled{true};
+QLoggingCategory::CategoryFilter previousFilter = nullptr;
+
+void categoryFilter(QLoggingCategory *category) {
+    // keep the Qt rules (bluetooth.cpp and homeform.cpp set some), then apply the log_debug switch
+    if (previousFilter)
+        previousFilter(category);
+    if (!enabled && qstrncmp(category->categoryName(), "qz.", 3) == 0)
+        category->setEnabled(QtDebugMsg, false);
+}
+
+} // namespace
+
+void qzdebug::setEnabled(bool on) {
+    static bool installed = false;
+    enabled = on;
+    if (!installed) {
+        installed = true;
+        previousFilter = QLoggingCategory::installFilter(categoryFilter);
+    } else {
+        // installing a filter runs it again on every registered category
+        QLoggingCategory::installFilter(QLoggingCategory::installFilter(nullptr));
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef QZDEBUG_H
+#define QZDEBUG_H
+
+#include <QDebug>
+#include <QLoggingCategory>
+
+/**
+ * Logging categories for the messages written on every packet. Log them with qzCDebug(qzDevice) << ...: the message
+ * is only formatted when its category is enabled, so with logging off a debug line on a notification path costs a
+ * branch.
+ *
+ *   qz.device          device state changes and commands sent to the device
+ *   qz.device.raw      hex dumps of the packets received from and written to the device
+ *   qz.device.metrics  values decoded from every notification
+ *   qz.dircon          dircon packets
+ *
+ * They follow the log_debug setting and can be narrowed at runtime with the usual Qt rules,
+ * e.g. QT_LOGGING_RULES="qz.device.raw.debug=false". Building with CONFIG+=qz_strip_debug removes the qzCDebug() and
+ * qzEmitDebug() lines entirely.
+ */
+Q_DECLARE_LOGGING_CATEGORY(qzDevice)
+Q_DECLARE_LOGGING_CATEGORY(qzDeviceRaw)
+Q_DECLARE_LOGGING_CATEGORY(qzDeviceMetrics)
+Q_DECLARE_LOGGING_CATEGORY(qzDircon)
+
+#ifdef QZ_NO_DEBUG_OUTPUT
+#define qzDebugEnabled(category) false
+// the statement still compiles, so the arguments are type checked, but the compiler drops it
+#define qzCDebug(category)                                                                                             \
+    while (false)                                                                                                      \
+    QMessageLogger().noDebug()
+#else
+#define qzDebugEnabled(category) (category().isDebugEnabled())
+#define qzCDebug(category) qCDebug(category)
+#endif
+
+// emit debug(message) for a category, for the drivers' debug signal: message is not built when it is disabled
+#define qzEmitDebug(category, message)                                                                                 \
+    do {                                                                                                               \
+        if (qzDebugEnabled(category))                                                                                  \
+            emit debug(message);                                                                                       \
+    } while (0)
+
+namespace qzdebug {
+/**
+ * @brief setEnabled Turns all the qz.* debug categories on or off, on top of the Qt logging rules.
+ */
+void setEnabled(bool enabled);
+} // namespace qzdebug
+
+#endif // QZDEBUG_H
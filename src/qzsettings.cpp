@@ -434,7 +434,20 @@ const QString QZSettings:: nordictrack_gx_2_7 = QStringLiteral("nordictrack_gx_2
 const QString QZSettings:: rolling_resistance = QStringLiteral("rolling_resistance");
 const QString QZSettings:: wahoo_rgt_dircon = QStringLiteral("wahoo_rgt_dircon");
 
-const uint32_t allSettingsCount = 369;
+const QString QZSettings:: tile_power_3s_enabled = QStringLiteral("tile_power_3s_enabled");
+const QString QZSettings:: tile_power_3s_order = QStringLiteral("tile_power_3s_order");
+const QString QZSettings:: tile_power_10s_enabled = QStringLiteral("tile_power_10s_enabled");
+const QString QZSettings:: tile_power_10s_order = QStringLiteral("tile_power_10s_order");
+const QString QZSettings:: tile_power_30s_enabled = QStringLiteral("tile_power_30s_enabled");
+const QString QZSettings:: tile_power_30s_order = QStringLiteral("tile_power_30s_order");
+const QString QZSettings:: tile_normalized_power_enabled = QStringLiteral("tile_normalized_power_enabled");
+const QString QZSettings:: tile_normalized_power_order = QStringLiteral("tile_normalized_power_order");
+const QString QZSettings:: virtual_device_notification_rate = QStringLiteral("virtual_device_notification_rate");
+const QString QZSettings:: virtual_device_keepalive_ms = QStringLiteral("virtual_device_keepalive_ms");
+const QString QZSettings:: dircon_mdns = QStringLiteral("dircon_mdns");
+const QString QZSettings:: latency_trace = QStringLiteral("latency_trace");
+
+const uint32_t allSettingsCount = 381;
 QVariant allSettings[allSettingsCount][2] =  {
     { QZSettings::cryptoKeySettingsProfiles, QZSettings::default_cryptoKeySettingsProfiles },
     { QZSettings::bluetooth_no_reconnection, QZSettings::default_bluetooth_no_reconnection },
@@ -804,7 +817,19 @@ QVariant allSettings[allSettingsCount][2] =  {
     { QZSettings::horizon_treadmill_profile_user5, QZSettings::default_horizon_treadmill_profile_user5},
     { QZSettings::nordictrack_gx_2_7, QZSettings::default_nordictrack_gx_2_7},
     { QZSettings::rolling_resistance, QZSettings::default_rolling_resistance},
-    { QZSettings::wahoo_rgt_dircon, QZSettings::default_wahoo_rgt_dircon}
+    { QZSettings::wahoo_rgt_dircon, QZSettings::default_wahoo_rgt_dircon},
+    { QZSettings::tile_power_3s_enabled, QZSettings::default_tile_power_3s_enabled },
+    { QZSettings::tile_power_3s_order, QZSettings::default_tile_power_3s_order },
+    { QZSettings::tile_power_10s_enabled, QZSettings::default_tile_power_10s_enabled },
+    { QZSettings::tile_power_10s_order, QZSettings::default_tile_power_10s_order },
+    { QZSettings::tile_power_30s_enabled, QZSettings::default_tile_power_30s_enabled },
+    { QZSettings::tile_power_30s_order, QZSettings::default_tile_power_30s_order },
+    { QZSettings::tile_normalized_power_enabled, QZSettings::default_tile_normalized_power_enabled },
+    { QZSettings::tile_normalized_power_order, QZSettings::default_tile_normalized_power_order },
+    { QZSettings::virtual_device_notification_rate, QZSettings::default_virtual_device_notification_rate },
+    { QZSettings::virtual_device_keepalive_ms, QZSettings::default_virtual_device_keepalive_ms },
+    { QZSettings::dircon_mdns, QZSettings::default_dircon_mdns },
+    { QZSettings::latency_trace, QZSettings::default_latency_trace }
 };
 
 void QZSettings::qDebugAllSettings(bool showDefaults) {
@@ -833,3 +858,9 @@ void QZSettings::qDebugAllSettings(bool showDefaults) {
         }
     }
 }
+
+uint32_t QZSettings::settingsCount() { return allSettingsCount; }
+
+QString QZSettings::settingsKey(uint32_t index) { return allSettings[index][0].toString(); }
+
+QVariant QZSettings::settingsDefault(uint32_t index) { return allSettings[index][1]; }
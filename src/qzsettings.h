@@ -2,6 +2,7 @@
 #define QZSETTINGS_H
 
 #include <QString>
+#include <QVariant>
 
 class QZSettings {
 private:
@@ -1345,11 +1346,62 @@ public:
     static const QString wahoo_rgt_dircon;
     static constexpr bool default_wahoo_rgt_dircon = false;
 
+    static const QString tile_power_3s_enabled;
+    static constexpr bool default_tile_power_3s_enabled = false;
+
+    static const QString tile_power_3s_order;
+    static constexpr int default_tile_power_3s_order = 35;
+
+    static const QString tile_power_10s_enabled;
+    static constexpr bool default_tile_power_10s_enabled = false;
+
+    static const QString tile_power_10s_order;
+    static constexpr int default_tile_power_10s_order = 36;
+
+    static const QString tile_power_30s_enabled;
+    static constexpr bool default_tile_power_30s_enabled = false;
+
+    static const QString tile_power_30s_order;
+    static constexpr int default_tile_power_30s_order = 37;
+
+    static const QString tile_normalized_power_enabled;
+    static constexpr bool default_tile_normalized_power_enabled = false;
+
+    static const QString tile_normalized_power_order;
+    static constexpr int default_tile_normalized_power_order = 38;
+
+    static const QString virtual_device_notification_rate;
+    static constexpr int default_virtual_device_notification_rate = 4;
+
+    static const QString virtual_device_keepalive_ms;
+    static constexpr int default_virtual_device_keepalive_ms = 1000;
+
+    static const QString dircon_mdns;
+    static constexpr bool default_dircon_mdns = true;
+
+    static const QString latency_trace;
+    static constexpr bool default_latency_trace = false;
+
     /**
      * @brief Write the QSettings values using the constants from this namespace.
      * @param showDefaults Optionally indicates if the default should be shown with the key.
      */
     void qDebugAllSettings(bool showDefaults=false);
+
+    /**
+     * @brief Number of entries in the table of all the settings declared in this class.
+     */
+    static uint32_t settingsCount();
+
+    /**
+     * @brief Key of the settings table entry at the specified index.
+     */
+    static QString settingsKey(uint32_t index);
+
+    /**
+     * @brief Default value of the settings table entry at the specified index.
+     */
+    static QVariant settingsDefault(uint32_t index);
 };
 
 #endif
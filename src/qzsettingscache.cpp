@@ -0,0 +1,200 @@
+#include "qzsettingscache.h"
+#include "qzsettings.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+
+#include <cmath>
+#include <limits>
+
+QZSettingsCache *QZSettingsCache::instance() {
+    static QZSettingsCache *cache = new QZSettingsCache();
+    return cache;
+}
+
+QZSettingsCache::QZSettingsCache() : entries(QZSettings::settingsCount()) {
+    QSettings settings;
+    for (uint32_t i = 0; i < QZSettings::settingsCount(); i++) {
+        Entry &e = entries[i];
+        e.key = QZSettings::settingsKey(i);
+        switch (QZSettings::settingsDefault(i).userType()) {
+        case QMetaType::Bool:
+            e.kind = KIND_BOOL;
+            break;
+        case QMetaType::Int:
+        case QMetaType::UInt:
+            e.kind = KIND_INT;
+            break;
+        case QMetaType::Double:
+        case QMetaType::Float:
+            e.kind = KIND_DOUBLE;
+            break;
+        default:
+            e.kind = KIND_STRING;
+            break;
+        }
+        index.insert(e.key, i);
+        store(e, settings.value(e.key), settings.contains(e.key));
+    }
+    m_status.store(settings.status(), std::memory_order_relaxed);
+
+    reloadTimer.setSingleShot(true);
+    reloadTimer.setInterval(250);
+    connect(&reloadTimer, &QTimer::timeout, this, &QZSettingsCache::reload);
+    connect(&watcher, &QFileSystemWatcher::fileChanged, &reloadTimer, QOverload<>::of(&QTimer::start));
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, &reloadTimer, QOverload<>::of(&QTimer::start));
+    storePath = settings.fileName();
+    watchStore();
+
+    qDebug() << QStringLiteral("QZSettingsCache loaded") << entries.size() << QStringLiteral("keys from") << storePath;
+}
+
+void QZSettingsCache::watchStore() {
+    // QSettings rewrites the INI/plist atomically (rename), so the file watch can be dropped after every save:
+    // the directory is watched too and the file is re-added on each reload.
+    // On Windows the store is the registry and only setValue()/reload() keep the cache in sync: see the reload()
+    // calls in homeform.
+    QFileInfo info(storePath);
+    if (!info.isAbsolute())
+        return;
+    if (info.exists() && !watcher.files().contains(storePath))
+        watcher.addPath(storePath);
+    if (info.absoluteDir().exists() && !watcher.directories().contains(info.absolutePath()))
+        watcher.addPath(info.absolutePath());
+}
+
+static bool isInt(double d) {
+    return std::trunc(d) == d && d >= std::numeric_limits<int>::min() && d <= std::numeric_limits<int>::max();
+}
+
+const QZSettingsCache::Entry *QZSettingsCache::find(const QString &key) const {
+    const int i = index.value(key, -1);
+    if (i < 0)
+        return nullptr;
+    return &entries[i];
+}
+
+bool QZSettingsCache::store(Entry &e, const QVariant &v, bool present) {
+    bool changed = e.present.load(std::memory_order_relaxed) != present;
+    if (present) {
+        if (e.kind == KIND_STRING) {
+            QString s = v.toString();
+            QWriteLocker locker(&textLock);
+            changed |= (e.text != s);
+            e.text = s;
+        } else {
+            // INI and plist stores hand back strings ("true", "1.5"), QVariant converts them for us
+            double d = (e.kind == KIND_BOOL) ? (v.toBool() ? 1.0 : 0.0) : v.toDouble();
+            changed |= (e.number.load(std::memory_order_relaxed) != d);
+            e.number.store(d, std::memory_order_relaxed);
+        }
+    }
+    e.present.store(present, std::memory_order_release);
+    return changed;
+}
+
+QVariant QZSettingsCache::load(const Entry &e) const {
+    switch (e.kind) {
+    case KIND_BOOL:
+        return QVariant(e.number.load(std::memory_order_relaxed) != 0.0);
+    case KIND_INT: {
+        const double d = e.number.load(std::memory_order_relaxed);
+        if (isInt(d))
+            return QVariant((int)d);
+        return QVariant(d);
+    }
+    case KIND_DOUBLE:
+        return QVariant(e.number.load(std::memory_order_relaxed));
+    case KIND_STRING:
+    default: {
+        QReadLocker locker(&textLock);
+        return QVariant(e.text);
+    }
+    }
+}
+
+QVariant QZSettingsCache::value(const QString &key, const QVariant &defaultValue) const {
+    const Entry *e = find(key);
+    if (!e) {
+        QSettings settings;
+        return settings.value(key, defaultValue);
+    }
+    if (!e->present.load(std::memory_order_acquire))
+        return defaultValue;
+    return load(*e);
+}
+
+bool QZSettingsCache::toBool(const QString &key, bool defaultValue) const {
+    const Entry *e = find(key);
+    if (!e || e->kind == KIND_STRING)
+        return value(key, defaultValue).toBool();
+    if (!e->present.load(std::memory_order_acquire))
+        return defaultValue;
+    return e->number.load(std::memory_order_relaxed) != 0.0;
+}
+
+int QZSettingsCache::toInt(const QString &key, int defaultValue) const {
+    const Entry *e = find(key);
+    if (!e || e->kind == KIND_STRING)
+        return value(key, defaultValue).toInt();
+    if (!e->present.load(std::memory_order_acquire))
+        return defaultValue;
+    const double d = e->number.load(std::memory_order_relaxed);
+    if (isInt(d))
+        return (int)d;
+    return QVariant(d).toInt();
+}
+
+double QZSettingsCache::toDouble(const QString &key, double defaultValue) const {
+    const Entry *e = find(key);
+    if (!e || e->kind == KIND_STRING)
+        return value(key, defaultValue).toDouble();
+    if (!e->present.load(std::memory_order_acquire))
+        return defaultValue;
+    return e->number.load(std::memory_order_relaxed);
+}
+
+QString QZSettingsCache::toString(const QString &key, const QString &defaultValue) const {
+    return value(key, defaultValue).toString();
+}
+
+void QZSettingsCache::setValue(const QString &key, const QVariant &value) {
+    {
+        QSettings settings;
+        settings.setValue(key, value);
+    }
+
+    const int i = index.value(key, -1);
+    if (i < 0)
+        return;
+
+    bool changed;
+    {
+        QMutexLocker locker(&writeLock);
+        changed = store(entries[i], value, true);
+    }
+    if (changed)
+        emit valueChanged(key, load(entries[i]));
+}
+
+void QZSettingsCache::reload() {
+    QSettings settings;
+    QList<int> changedKeys;
+    {
+        QMutexLocker locker(&writeLock);
+        for (uint32_t i = 0; i < entries.size(); i++) {
+            Entry &e = entries[i];
+            if (store(e, settings.value(e.key), settings.contains(e.key)))
+                changedKeys.append(i);
+        }
+    }
+    m_status.store(settings.status(), std::memory_order_relaxed);
+    watchStore();
+
+    for (int i : qAsConst(changedKeys)) {
+        const Entry &e = entries[i];
+        emit valueChanged(e.key, e.present.load() ? load(e) : QVariant());
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef QZSETTINGSCACHE_H
+#define QZSETTINGSCACHE_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSettings>
+#include <QString>
+#include <QTimer>
+#include <QVariant>
+
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief The QZSettingsCache class is a process-wide, typed snapshot of every key listed in the QZSettings table.
+ * It is loaded once, refreshed when the settings store changes (or when written through setValue()), and can be
+ * read from any thread. The store is watched only where it is a file and the watch is not reliable on the mobile
+ * plists, so homeform also calls reload() when leaving the settings pages, loading a profile, connecting a device
+ * and starting a workout.
+ * The cache is stale after a write through a plain QSettings: it sees the new value only when the file watch
+ * fires (250 ms later, desktop stores only) or at the next of those reload() points. Code that needs its write
+ * seen at once, or on a store that is not watched, must write through setValue().
+ * Boolean and numeric values are read lock-free, strings take a shared read lock.
+ * Keys that are not in the QZSettings table fall back to a regular QSettings lookup.
+ * An int key holding a fractional value (written by an older version, or by hand) reads back that value as a
+ * double, as QSettings would, instead of truncating it.
+ *
+ * On hot paths it can replace a local QSettings without touching the call sites:
+ *     const QZSettingsCache &settings = *QZSettingsCache::instance();
+ *     bool miles = settings.value(QZSettings::miles_unit, QZSettings::default_miles_unit).toBool();
+ */
+class QZSettingsCache : public QObject {
+    Q_OBJECT
+
+  public:
+    /**
+     * @brief instance Gets the process-wide cache. The first call must happen after the application
+     * organization and name have been set, otherwise the wrong settings store is read.
+     */
+    static QZSettingsCache *instance();
+
+    /**
+     * @brief value Same semantics as QSettings::value(): returns the stored value, or defaultValue
+     * if the key has never been written.
+     */
+    QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
+
+    bool toBool(const QString &key, bool defaultValue) const;
+    int toInt(const QString &key, int defaultValue) const;
+    double toDouble(const QString &key, double defaultValue) const;
+    QString toString(const QString &key, const QString &defaultValue) const;
+
+    /**
+     * @brief status The QSettings status of the last load of the store.
+     */
+    QSettings::Status status() const { return (QSettings::Status)m_status.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief setValue Writes the value through to QSettings and updates the snapshot immediately.
+     */
+    void setValue(const QString &key, const QVariant &value);
+
+  public slots:
+    /**
+     * @brief reload Re-reads every cached key from QSettings, emitting valueChanged() for the ones that differ.
+     */
+    void reload();
+
+  signals:
+    void valueChanged(const QString &key, const QVariant &value);
+
+  private:
+    enum Kind { KIND_BOOL, KIND_INT, KIND_DOUBLE, KIND_STRING };
+
+    struct Entry {
+        QString key;
+        Kind kind = KIND_STRING;
+        std::atomic<bool> present{false};
+        std::atomic<double> number{0};
+        QString text; // guarded by textLock, only for KIND_STRING
+    };
+
+    QZSettingsCache();
+    const Entry *find(const QString &key) const;
+    bool store(Entry &e, const QVariant &v, bool present);
+    QVariant load(const Entry &e) const;
+    void watchStore();
+
+    std::vector<Entry> entries;
+    QHash<QString, int> index; // built once in the constructor, read-only afterwards
+    mutable QReadWriteLock textLock;
+    QMutex writeLock;
+    QFileSystemWatcher watcher;
+    QTimer reloadTimer;
+    QString storePath;
+    std::atomic<int> m_status{QSettings::NoError};
+};
+
+#endif // QZSETTINGSCACHE_H
@@ -1,4 +1,6 @@
 #include "renphobike.h"
+#include "ftmsdata.h"
+#include "qzsettingscache.h"
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
 #include <QBluetoothLocalDevice>
@@ -163,7 +165,7 @@ void renphobike::serviceDiscovered(const QBluetoothUuid &gatt) { debug("serviceD
 void renphobike::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue) {
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName = settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
     debug(" << " + newValue.toHex(' '));
@@ -173,76 +175,34 @@ void renphobike::characteristicChanged(const QLowEnergyCharacteristic &character
 
     lastPacket = newValue;
 
-    union flags {
-        struct {
-            uint16_t moreData : 1;
-            uint16_t avgSpeed : 1;
-            uint16_t instantCadence : 1;
-            uint16_t avgCadence : 1;
-            uint16_t totDistance : 1;
-            uint16_t resistanceLvl : 1;
-            uint16_t instantPower : 1;
-            uint16_t avgPower : 1;
-            uint16_t expEnergy : 1;
-            uint16_t heartRate : 1;
-            uint16_t metabolic : 1;
-            uint16_t elapsedTime : 1;
-            uint16_t remainingTime : 1;
-            uint16_t spare : 3;
-        };
-
-        uint16_t word_flags;
-    };
-
-    flags Flags;
-    int index = 0;
-    Flags.word_flags = (newValue.at(1) << 8) | newValue.at(0);
-    index += 2;
-
-    if (!Flags.moreData) {
+    ftmsdata data;
+    if (!data.decode(ftmsdata::INDOOR_BIKE_DATA, newValue))
+        debug(QStringLiteral("FTMS packet shorter than its flags"));
+
+    if (data.has(ftmsdata::FIELD_SPEED)) {
         if (!settings.value(QZSettings::speed_power_based, QZSettings::default_speed_power_based).toBool())
-            Speed = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                              (uint16_t)((uint8_t)newValue.at(index)))) /
-                    100.0;
+            Speed = data.speed;
         else
             Speed = metric::calculateSpeedFromPower(watts(), Inclination.value(), Speed.value(),fabs(QDateTime::currentDateTime().msecsTo(Speed.lastChanged()) / 1000.0),  this->speedLimit());
-        index += 2;
         debug("Current Speed: " + QString::number(Speed.value()));
     }
 
-    if (Flags.avgSpeed) {
-        double avgSpeed;
-        avgSpeed =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            100.0;
-        index += 2;
-        debug("Current Average Speed: " + QString::number(avgSpeed));
+    if (data.has(ftmsdata::FIELD_AVERAGE_SPEED)) {
+        debug("Current Average Speed: " + QString::number(data.averageSpeed));
     }
 
-    if (Flags.instantCadence) {
+    if (data.has(ftmsdata::FIELD_CADENCE)) {
         if (settings.value(QZSettings::cadence_sensor_name, QZSettings::default_cadence_sensor_name).toString().startsWith("Disabled"))
-            Cadence = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                                (uint16_t)((uint8_t)newValue.at(index)))) /
-                      2.0;
-        index += 2;
+            Cadence = data.cadence;
         debug("Current Cadence: " + QString::number(Cadence.value()));
     }
 
-    if (Flags.avgCadence) {
-        double avgCadence;
-        avgCadence =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            2.0;
-        index += 2;
-        debug("Current Average Cadence: " + QString::number(avgCadence));
+    if (data.has(ftmsdata::FIELD_AVERAGE_CADENCE)) {
+        debug("Current Average Cadence: " + QString::number(data.averageCadence));
     }
 
-    if (Flags.totDistance) {
-        Distance = ((double)((((uint32_t)((uint8_t)newValue.at(index + 2)) << 16) |
-                              (uint32_t)((uint8_t)newValue.at(index + 1)) << 8) |
-                             (uint32_t)((uint8_t)newValue.at(index)))) /
-                   1000.0;
-        index += 3;
+    if (data.has(ftmsdata::FIELD_DISTANCE)) {
+        Distance = data.distance / 1000.0;
     } else {
         Distance += ((Speed.value() / 3600000.0) *
                      ((double)lastRefreshCharacteristicChanged.msecsTo(QDateTime::currentDateTime())));
@@ -250,45 +210,30 @@ void renphobike::characteristicChanged(const QLowEnergyCharacteristic &character
 
     debug("Current Distance: " + QString::number(Distance.value()));
 
-    if (Flags.resistanceLvl) {
-        Resistance =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index)))) /
-            2;
+    if (data.has(ftmsdata::FIELD_RESISTANCE)) {
+        // the Renpho reports the level with a 0.5 resolution
+        Resistance = data.resistance / 2;
         emit resistanceRead(Resistance.value());
         m_pelotonResistance = bikeResistanceToPeloton(Resistance.value());
-        index += 2;
         debug("Current Resistance: " + QString::number(Resistance.value()));
     }
 
-    if (Flags.instantPower) {
-        wattFromBike =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
+    if (data.has(ftmsdata::FIELD_POWER)) {
+        wattFromBike = data.power;
         if (settings.value(QZSettings::power_sensor_name, QZSettings::default_power_sensor_name)
                 .toString()
                 .startsWith(QStringLiteral("Disabled")))
             m_watt = wattFromBike.value();
-        index += 2;
         debug("Current Watt: " + QString::number(m_watt.value()));
         debug("Current Watt from the Bike: " + QString::number(wattFromBike.value()));
     }
 
-    if (Flags.avgPower) {
-        double avgPower;
-        avgPower =
-            ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-        debug("Current Average Watt: " + QString::number(avgPower));
+    if (data.has(ftmsdata::FIELD_AVERAGE_POWER)) {
+        debug("Current Average Watt: " + QString::number(data.averagePower));
     }
 
-    if (Flags.expEnergy) {
-        KCal = ((double)(((uint16_t)((uint8_t)newValue.at(index + 1)) << 8) | (uint16_t)((uint8_t)newValue.at(index))));
-        index += 2;
-
-        // energy per hour
-        index += 2;
-
-        // energy per minute
-        index += 1;
+    if (data.has(ftmsdata::FIELD_ENERGY)) {
+        KCal = data.energy;
     } else {
         if (watts())
             KCal +=
@@ -306,25 +251,12 @@ void renphobike::characteristicChanged(const QLowEnergyCharacteristic &character
     else
 #endif
     {
-        if (Flags.heartRate) {
-            Heart = ((double)((newValue.at(index))));
-            index += 1;
+        if (data.has(ftmsdata::FIELD_HEART)) {
+            Heart = data.heart;
             debug("Current Heart: " + QString::number(Heart.value()));
         }
     }
 
-    if (Flags.metabolic) {
-        // todo
-    }
-
-    if (Flags.elapsedTime) {
-        // todo
-    }
-
-    if (Flags.remainingTime) {
-        // todo
-    }
-
     if (Cadence.value() > 0) {
         CrankRevs++;
         LastCrankEventTime += (uint16_t)(1024.0 / (((double)(Cadence.value())) / 60.0));
@@ -21,17 +21,17 @@ void rower::changePower(int32_t power) {
 }
 double rower::currentCrankRevolutions() { return CrankRevs; }
 uint16_t rower::lastCrankEventTime() { return LastCrankEventTime; }
-metric rower::lastRequestedResistance() { return RequestedResistance; }
-metric rower::lastRequestedPelotonResistance() { return RequestedPelotonResistance; }
-metric rower::lastRequestedCadence() { return RequestedCadence; }
-metric rower::lastRequestedPower() { return RequestedPower; }
-metric rower::currentResistance() { return Resistance; }
-metric rower::currentStrokesCount() { return StrokesCount; }
-metric rower::currentStrokesLength() { return StrokesLength; }
+const metric &rower::lastRequestedResistance() { return RequestedResistance; }
+const metric &rower::lastRequestedPelotonResistance() { return RequestedPelotonResistance; }
+const metric &rower::lastRequestedCadence() { return RequestedCadence; }
+const metric &rower::lastRequestedPower() { return RequestedPower; }
+const metric &rower::currentResistance() { return Resistance; }
+const metric &rower::currentStrokesCount() { return StrokesCount; }
+const metric &rower::currentStrokesLength() { return StrokesLength; }
 uint8_t rower::fanSpeed() { return FanSpeed; }
 bool rower::connected() { return false; }
 uint16_t rower::watts() { return 0; }
-metric rower::pelotonResistance() { return m_pelotonResistance; }
+const metric &rower::pelotonResistance() { return m_pelotonResistance; }
 resistance_t rower::pelotonToBikeResistance(int pelotonResistance) { return pelotonResistance; }
 resistance_t rower::resistanceFromPowerRequest(uint16_t power) { return power / 10; } // in order to have something
 void rower::cadenceSensor(uint8_t cadence) { Cadence.setValue(cadence); }
@@ -10,13 +10,13 @@ class rower : public bluetoothdevice {
 
   public:
     rower();
-    metric lastRequestedResistance();
-    metric lastRequestedPelotonResistance();
-    metric lastRequestedCadence();
-    metric lastRequestedPower();
-    virtual metric currentResistance();
-    virtual metric currentStrokesCount();
-    virtual metric currentStrokesLength();
+    const metric &lastRequestedResistance();
+    const metric &lastRequestedPelotonResistance();
+    const metric &lastRequestedCadence();
+    const metric &lastRequestedPower();
+    virtual const metric &currentResistance();
+    virtual const metric &currentStrokesCount();
+    virtual const metric &currentStrokesLength();
     virtual QTime currentPace();
     virtual uint8_t fanSpeed();
     virtual double currentCrankRevolutions();
@@ -26,7 +26,7 @@ class rower : public bluetoothdevice {
     virtual resistance_t pelotonToBikeResistance(int pelotonResistance);
     virtual resistance_t resistanceFromPowerRequest(uint16_t power);
     bluetoothdevice::BLUETOOTH_TYPE deviceType();
-    metric pelotonResistance();
+    const metric &pelotonResistance();
     void clearStats();
     void setLap();
     void setPaused(bool p);
@@ -1,4 +1,5 @@
 #include "schwinnic4bike.h"
+#include "qzsettingscache.h"
 
 #include "ios/lockscreen.h"
 #include "virtualbike.h"
@@ -119,7 +120,7 @@ void schwinnic4bike::characteristicChanged(const QLowEnergyCharacteristic &chara
 
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
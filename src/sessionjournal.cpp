@@ -0,0 +1,202 @@
+#include "sessionjournal.h"
+#include "qfit.h"
+#include "sessionstore.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char journalMagic[4] = {'Q', 'Z', 'J', '1'};
+const uint16_t journalVersion = 1;
+
+#pragma pack(push, 1)
+struct journalHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t recordSize;
+    uint8_t deviceType;
+    uint8_t sport;
+    uint32_t processFlag;
+};
+
+struct journalRecord {
+    int64_t time; // msecs since epoch
+    uint32_t elapsedTime;
+    double distance;
+    double latitude;
+    double longitude;
+    double altitude;
+    float speed;
+    float pace;
+    float calories;
+    float elevationGain;
+    uint32_t totalStrokes;
+    float avgStrokesRate;
+    float maxStrokesRate;
+    float avgStrokesLength;
+    float instantaneousStrideLengthCM;
+    float groundContactMS;
+    float verticalOscillationMM;
+    uint16_t watt;
+    int16_t resistance;
+    int8_t inclination;
+    int8_t pelotonResistance;
+    uint8_t heart;
+    uint8_t cadence;
+    uint8_t lapTrigger;
+    uint16_t checksum; // CRC-16 of the bytes above
+};
+#pragma pack(pop)
+
+const uint checksumLength = sizeof(journalRecord) - sizeof(uint16_t);
+
+} // namespace
+
+sessionjournal::sessionjournal(const QString &filename) : file(filename), record(sizeof(journalRecord), 0) {}
+
+sessionjournal::~sessionjournal() {
+    if (file.isOpen()) {
+        sync();
+        file.close();
+    }
+}
+
+bool sessionjournal::start(bluetoothdevice::BLUETOOTH_TYPE type, uint32_t processFlag, FIT_SPORT sport) {
+    if (file.isOpen())
+        file.close();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << QStringLiteral("sessionjournal: can't open") << file.fileName() << file.errorString();
+        return false;
+    }
+
+    journalHeader h;
+    memcpy(h.magic, journalMagic, sizeof(h.magic));
+    h.version = journalVersion;
+    h.recordSize = sizeof(journalRecord);
+    h.deviceType = (uint8_t)type;
+    h.sport = (uint8_t)sport;
+    h.processFlag = processFlag;
+    file.write((const char *)&h, sizeof(h));
+    unsynced = 0;
+    sync();
+    return true;
+}
+
+void sessionjournal::append(const SessionLine &s) {
+    if (!file.isOpen())
+        return;
+
+    journalRecord *r = (journalRecord *)record.data();
+    r->time = s.time.toMSecsSinceEpoch();
+    r->elapsedTime = s.elapsedTime;
+    r->distance = s.distance;
+    r->latitude = s.coordinate.latitude();
+    r->longitude = s.coordinate.longitude();
+    r->altitude = s.coordinate.altitude();
+    r->speed = s.speed;
+    r->pace = s.pace;
+    r->calories = s.calories;
+    r->elevationGain = s.elevationGain;
+    r->totalStrokes = s.totalStrokes;
+    r->avgStrokesRate = s.avgStrokesRate;
+    r->maxStrokesRate = s.maxStrokesRate;
+    r->avgStrokesLength = s.avgStrokesLength;
+    r->instantaneousStrideLengthCM = s.instantaneousStrideLengthCM;
+    r->groundContactMS = s.groundContactMS;
+    r->verticalOscillationMM = s.verticalOscillationMM;
+    r->watt = s.watt;
+    r->resistance = s.resistance;
+    r->inclination = s.inclination;
+    r->pelotonResistance = s.peloton_resistance;
+    r->heart = s.heart;
+    r->cadence = s.cadence;
+    r->lapTrigger = s.lapTrigger;
+    r->checksum = qChecksum(record.constData(), checksumLength);
+    file.write(record);
+
+    if (++unsynced >= SYNC_INTERVAL)
+        sync();
+}
+
+void sessionjournal::sync() {
+    if (!file.isOpen() || !unsynced)
+        return;
+    file.flush();
+#ifdef Q_OS_WIN
+    _commit(file.handle());
+#else
+    fsync(file.handle());
+#endif
+    unsynced = 0;
+}
+
+void sessionjournal::discard() {
+    if (file.isOpen())
+        file.close();
+    file.remove();
+    unsynced = 0;
+}
+
+QString sessionjournal::recover(const QString &journalFilename, const QString &fitPath) {
+    QFile journal(journalFilename);
+    if (!journal.exists())
+        return QString();
+    if (!journal.open(QIODevice::ReadOnly)) {
+        qDebug() << QStringLiteral("sessionjournal: can't open") << journalFilename << journal.errorString();
+        return QString();
+    }
+
+    journalHeader h;
+    if (journal.read((char *)&h, sizeof(h)) != sizeof(h) || memcmp(h.magic, journalMagic, sizeof(h.magic)) ||
+        h.version != journalVersion || h.recordSize != sizeof(journalRecord)) {
+        qDebug() << QStringLiteral("sessionjournal: unknown journal format, discarding") << journalFilename;
+        journal.close();
+        journal.remove();
+        return QString();
+    }
+
+    sessionstore session;
+    journalRecord r;
+    while (journal.read((char *)&r, sizeof(r)) == sizeof(r)) {
+        if (qChecksum((const char *)&r, checksumLength) != r.checksum) {
+            qDebug() << QStringLiteral("sessionjournal: bad record after") << session.size() << QStringLiteral("samples");
+            break;
+        }
+        QGeoCoordinate c;
+        c.setLatitude(r.latitude);
+        c.setLongitude(r.longitude);
+        c.setAltitude(r.altitude);
+        session.append(SessionLine(r.speed, r.inclination, r.distance, r.watt, r.resistance, r.pelotonResistance,
+                                   r.heart, r.pace, r.cadence, r.calories, r.elevationGain, r.elapsedTime,
+                                   r.lapTrigger, r.totalStrokes, r.avgStrokesRate, r.maxStrokesRate,
+                                   r.avgStrokesLength, c, r.instantaneousStrideLengthCM, r.groundContactMS,
+                                   r.verticalOscillationMM, QDateTime::fromMSecsSinceEpoch(r.time)));
+    }
+    journal.close();
+
+    QString filename;
+    if (!session.isEmpty()) {
+        filename = fitPath + QStringLiteral("QZ-recovered-") +
+                   session.dateTime(0).toString().replace(QStringLiteral(":"), QStringLiteral("_")) +
+                   QStringLiteral(".fit");
+        qfit::save(filename, session, (bluetoothdevice::BLUETOOTH_TYPE)h.deviceType, h.processFlag,
+                   (FIT_SPORT)h.sport);
+        if (QFileInfo(filename).size() <= 0) {
+            // keep the journal, we'll try again on the next start
+            qDebug() << QStringLiteral("sessionjournal: can't write") << filename;
+            return QString();
+        }
+        qDebug() << QStringLiteral("sessionjournal: recovered") << session.size() << QStringLiteral("samples to")
+                 << filename;
+    }
+    journal.remove();
+    return filename;
+}
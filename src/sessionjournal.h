@@ -0,0 +1,58 @@
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include "bluetoothdevice.h"
+#include "fit_profile.hpp"
+#include "sessionline.h"
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+/**
+ * @brief The sessionjournal class is an append-only, crash-safe log of the session samples.
+ * Each sample is written once as a fixed size, checksummed record and the file is fsync'ed every
+ * SYNC_INTERVAL samples, so keeping the backup costs the same whether the ride is 10 minutes or 3 hours.
+ * After a crash recover() rebuilds a FIT file from the records that made it to disk; a torn last record
+ * is detected by its checksum and dropped.
+ *
+ * The records are written in the native byte order: a journal is only meant to be read back on the same device.
+ */
+class sessionjournal {
+  public:
+    static const int SYNC_INTERVAL = 10;
+
+    explicit sessionjournal(const QString &filename);
+    ~sessionjournal();
+
+    /**
+     * @brief start Truncates the journal and writes the header. The header keeps what qfit::save needs
+     * to rebuild the activity.
+     */
+    bool start(bluetoothdevice::BLUETOOTH_TYPE type, uint32_t processFlag, FIT_SPORT sport);
+    bool isStarted() const { return file.isOpen(); }
+    void append(const SessionLine &s);
+
+    /**
+     * @brief sync Pushes the buffered records to the disk.
+     */
+    void sync();
+
+    /**
+     * @brief discard Closes and deletes the journal, once the session has been saved (or thrown away).
+     */
+    void discard();
+
+    /**
+     * @brief recover Rebuilds a FIT file from a journal left behind by a crash, then deletes the journal.
+     * @param fitPath folder where the FIT file is written
+     * @return the FIT file name, empty if there was nothing to recover
+     */
+    static QString recover(const QString &journalFilename, const QString &fitPath);
+
+  private:
+    QFile file;
+    QByteArray record;
+    int unsynced = 0;
+};
+
+#endif // SESSIONJOURNAL_H
@@ -0,0 +1,81 @@
+#include "sessionstore.h"
+
+#include <cmath>
+
+void sessionstore::append(const SessionLine &s) {
+    m_speed.append(s.speed);
+    m_inclination.append(s.inclination);
+    m_distance.append(s.distance);
+    m_watt.append(s.watt);
+    m_resistance.append(s.resistance);
+    m_pelotonResistance.append(s.peloton_resistance);
+    m_heart.append(s.heart);
+    m_pace.append(s.pace);
+    m_cadence.append(s.cadence);
+    m_time.append(s.time.toMSecsSinceEpoch());
+    m_calories.append(s.calories);
+    m_elevationGain.append(s.elevationGain);
+    m_elapsedTime.append(s.elapsedTime);
+    m_lapTrigger.append(s.lapTrigger);
+    m_totalStrokes.append(s.totalStrokes);
+    m_avgStrokesRate.append(s.avgStrokesRate);
+    m_maxStrokesRate.append(s.maxStrokesRate);
+    m_avgStrokesLength.append(s.avgStrokesLength);
+    m_latitude.append(s.coordinate.latitude());
+    m_longitude.append(s.coordinate.longitude());
+    m_altitude.append(s.coordinate.altitude());
+    m_instantaneousStrideLengthCM.append(s.instantaneousStrideLengthCM);
+    m_groundContactMS.append(s.groundContactMS);
+    m_verticalOscillationMM.append(s.verticalOscillationMM);
+}
+
+void sessionstore::clear() {
+    m_speed.clear();
+    m_inclination.clear();
+    m_distance.clear();
+    m_watt.clear();
+    m_resistance.clear();
+    m_pelotonResistance.clear();
+    m_heart.clear();
+    m_pace.clear();
+    m_cadence.clear();
+    m_time.clear();
+    m_calories.clear();
+    m_elevationGain.clear();
+    m_elapsedTime.clear();
+    m_lapTrigger.clear();
+    m_totalStrokes.clear();
+    m_avgStrokesRate.clear();
+    m_maxStrokesRate.clear();
+    m_avgStrokesLength.clear();
+    m_latitude.clear();
+    m_longitude.clear();
+    m_altitude.clear();
+    m_instantaneousStrideLengthCM.clear();
+    m_groundContactMS.clear();
+    m_verticalOscillationMM.clear();
+}
+
+bool sessionstore::coordinateValid(int i) const {
+    // same rule as QGeoCoordinate::isValid()
+    const double lat = m_latitude.at(i);
+    const double lon = m_longitude.at(i);
+    return !std::isnan(lat) && !std::isnan(lon) && lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0;
+}
+
+QGeoCoordinate sessionstore::coordinate(int i) const {
+    QGeoCoordinate c;
+    c.setLatitude(m_latitude.at(i));
+    c.setLongitude(m_longitude.at(i));
+    c.setAltitude(m_altitude.at(i));
+    return c;
+}
+
+SessionLine sessionstore::at(int i) const {
+    return SessionLine(m_speed.at(i), m_inclination.at(i), m_distance.at(i), m_watt.at(i), m_resistance.at(i),
+                       m_pelotonResistance.at(i), m_heart.at(i), m_pace.at(i), m_cadence.at(i), m_calories.at(i),
+                       m_elevationGain.at(i), m_elapsedTime.at(i), m_lapTrigger.at(i), m_totalStrokes.at(i),
+                       m_avgStrokesRate.at(i), m_maxStrokesRate.at(i), m_avgStrokesLength.at(i), coordinate(i),
+                       m_instantaneousStrideLengthCM.at(i), m_groundContactMS.at(i), m_verticalOscillationMM.at(i),
+                       dateTime(i));
+}
@@ -0,0 +1,158 @@
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include "sessionline.h"
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief The sessioncolumn class is a read-only view of one field of a sessionstore.
+ * Samples are kept in fixed capacity chunks that are never reallocated, so appending never moves what is already
+ * recorded and copying a column (or the whole store) only shares the chunks.
+ */
+template <typename T> class sessioncolumn {
+  public:
+    static const int CHUNK_SHIFT = 10;
+    static const int CHUNK_SIZE = 1 << CHUNK_SHIFT; // ~17 minutes at one sample per second
+    static const int CHUNK_MASK = CHUNK_SIZE - 1;
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    T at(int i) const { return m_chunks.at(i >> CHUNK_SHIFT).at(i & CHUNK_MASK); }
+    T operator[](int i) const { return at(i); }
+    T first() const { return at(0); }
+    T last() const { return at(m_size - 1); }
+
+    /**
+     * @brief chunkCount, chunk, chunkSize Direct access to the contiguous blocks, for tight loops.
+     */
+    int chunkCount() const { return m_chunks.size(); }
+    const T *chunk(int c) const { return m_chunks.at(c).constData(); }
+    int chunkSize(int c) const { return m_chunks.at(c).size(); }
+
+    /**
+     * @brief toList Copies every step-th sample, for the QML properties that need a plain list.
+     */
+    QList<double> toList(int step = 1) const {
+        QList<double> l;
+        if (step < 1)
+            step = 1;
+        l.reserve(m_size / step + 1);
+        for (int i = 0; i < m_size; i += step)
+            l.append(at(i));
+        return l;
+    }
+
+    /**
+     * @brief appendTo Appends the samples from out.size() on, so a list kept across reads only copies the samples
+     * recorded since the previous call. The caller clears the list when the store is cleared.
+     */
+    void appendTo(QList<double> &out) const {
+        if (out.size() >= m_size)
+            return;
+        out.reserve(m_size);
+        for (int i = out.size(); i < m_size; i++)
+            out.append(at(i));
+    }
+
+  private:
+    friend class sessionstore;
+
+    void append(T v) {
+        if ((m_size & CHUNK_MASK) == 0) {
+            m_chunks.append(QVector<T>());
+            m_chunks.last().reserve(CHUNK_SIZE);
+        }
+        m_chunks.last().append(v);
+        m_size++;
+    }
+    void set(int i, T v) { m_chunks[i >> CHUNK_SHIFT][i & CHUNK_MASK] = v; }
+    void clear() {
+        m_chunks.clear();
+        m_size = 0;
+    }
+
+    QVector<QVector<T>> m_chunks;
+    int m_size = 0;
+};
+
+/**
+ * @brief The sessionstore class records a workout one sample per second as typed columns (structure of arrays).
+ * It replaces a QList<SessionLine>, which kept a heap allocated row with a QDateTime and a QGeoCoordinate for every
+ * second. Rows can still be read or appended as SessionLine, but exporters and charts should read the columns.
+ */
+class sessionstore {
+  public:
+    void append(const SessionLine &s);
+    void clear();
+
+    int size() const { return m_watt.size(); }
+    int count() const { return size(); }
+    int length() const { return size(); }
+    bool isEmpty() const { return m_watt.isEmpty(); }
+
+    /**
+     * @brief at Builds the full row i. Prefer the column accessors in loops.
+     */
+    SessionLine at(int i) const;
+    SessionLine constFirst() const { return at(0); }
+    SessionLine last() const { return at(size() - 1); }
+
+    QDateTime dateTime(int i) const { return QDateTime::fromMSecsSinceEpoch(m_time.at(i)); }
+    QGeoCoordinate coordinate(int i) const;
+    bool coordinateValid(int i) const;
+    void setDistance(int i, double distance) { m_distance.set(i, distance); }
+
+    const sessioncolumn<float> &speed() const { return m_speed; }
+    const sessioncolumn<int8_t> &inclination() const { return m_inclination; }
+    const sessioncolumn<double> &distance() const { return m_distance; }
+    const sessioncolumn<uint16_t> &watt() const { return m_watt; }
+    const sessioncolumn<resistance_t> &resistance() const { return m_resistance; }
+    const sessioncolumn<int8_t> &pelotonResistance() const { return m_pelotonResistance; }
+    const sessioncolumn<uint8_t> &heart() const { return m_heart; }
+    const sessioncolumn<float> &pace() const { return m_pace; }
+    const sessioncolumn<uint8_t> &cadence() const { return m_cadence; }
+    const sessioncolumn<qint64> &time() const { return m_time; } // msecs since epoch
+    const sessioncolumn<float> &calories() const { return m_calories; }
+    const sessioncolumn<float> &elevationGain() const { return m_elevationGain; }
+    const sessioncolumn<uint32_t> &elapsedTime() const { return m_elapsedTime; }
+    const sessioncolumn<bool> &lapTrigger() const { return m_lapTrigger; }
+    const sessioncolumn<uint32_t> &totalStrokes() const { return m_totalStrokes; }
+    const sessioncolumn<float> &avgStrokesRate() const { return m_avgStrokesRate; }
+    const sessioncolumn<float> &maxStrokesRate() const { return m_maxStrokesRate; }
+    const sessioncolumn<float> &avgStrokesLength() const { return m_avgStrokesLength; }
+    const sessioncolumn<double> &latitude() const { return m_latitude; } // NaN without a fix
+    const sessioncolumn<double> &longitude() const { return m_longitude; }
+    const sessioncolumn<double> &altitude() const { return m_altitude; }
+    const sessioncolumn<float> &instantaneousStrideLengthCM() const { return m_instantaneousStrideLengthCM; }
+    const sessioncolumn<float> &groundContactMS() const { return m_groundContactMS; }
+    const sessioncolumn<float> &verticalOscillationMM() const { return m_verticalOscillationMM; }
+
+  private:
+    sessioncolumn<float> m_speed;
+    sessioncolumn<int8_t> m_inclination;
+    sessioncolumn<double> m_distance;
+    sessioncolumn<uint16_t> m_watt;
+    sessioncolumn<resistance_t> m_resistance;
+    sessioncolumn<int8_t> m_pelotonResistance;
+    sessioncolumn<uint8_t> m_heart;
+    sessioncolumn<float> m_pace;
+    sessioncolumn<uint8_t> m_cadence;
+    sessioncolumn<qint64> m_time;
+    sessioncolumn<float> m_calories;
+    sessioncolumn<float> m_elevationGain;
+    sessioncolumn<uint32_t> m_elapsedTime;
+    sessioncolumn<bool> m_lapTrigger;
+    sessioncolumn<uint32_t> m_totalStrokes;
+    sessioncolumn<float> m_avgStrokesRate;
+    sessioncolumn<float> m_maxStrokesRate;
+    sessioncolumn<float> m_avgStrokesLength;
+    sessioncolumn<double> m_latitude;
+    sessioncolumn<double> m_longitude;
+    sessioncolumn<double> m_altitude;
+    sessioncolumn<float> m_instantaneousStrideLengthCM;
+    sessioncolumn<float> m_groundContactMS;
+    sessioncolumn<float> m_verticalOscillationMM;
+};
+
+#endif // SESSIONSTORE_H
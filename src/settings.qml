@@ -486,6 +486,19 @@ import Qt.labs.settings 1.0
 
             // from version 2.11.69
             property bool wahoo_rgt_dircon: false
+
+            // from version 2.11.70
+            property bool tile_power_3s_enabled: false
+            property int  tile_power_3s_order: 35
+            property bool tile_power_10s_enabled: false
+            property int  tile_power_10s_order: 36
+            property bool tile_power_30s_enabled: false
+            property int  tile_power_30s_order: 37
+            property bool tile_normalized_power_enabled: false
+            property int  tile_normalized_power_order: 38
+            property int  virtual_device_notification_rate: 4
+            property int  virtual_device_keepalive_ms: 1000
+            property bool latency_trace: false
         }
 
         function paddingZeros(text, limit) {
@@ -3607,6 +3620,130 @@ import Qt.labs.settings 1.0
                             }
                         }
                     }
+                    AccordionCheckElement {
+                        id: power3sEnabledAccordion
+                        title: qsTr("Power 3s")
+                        linkedBoolSetting: "tile_power_3s_enabled"
+                        settings: settings
+                        accordionContent: RowLayout {
+                            spacing: 10
+                            Label {
+                                id: labelpower3sOrder
+                                text: qsTr("order index:")
+                                Layout.fillWidth: true
+                                horizontalAlignment: Text.AlignRight
+                            }
+                            ComboBox {
+                                id: power3sOrderTextField
+                                model: rootItem.tile_order
+                                displayText: settings.tile_power_3s_order
+                                Layout.fillHeight: false
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onActivated: {
+                                    displayText = power3sOrderTextField.currentValue
+                                 }
+                            }
+                            Button {
+                                id: okpower3sOrderButton
+                                text: "OK"
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onClicked: settings.tile_power_3s_order = power3sOrderTextField.displayText
+                            }
+                        }
+                    }
+                    AccordionCheckElement {
+                        id: power10sEnabledAccordion
+                        title: qsTr("Power 10s")
+                        linkedBoolSetting: "tile_power_10s_enabled"
+                        settings: settings
+                        accordionContent: RowLayout {
+                            spacing: 10
+                            Label {
+                                id: labelpower10sOrder
+                                text: qsTr("order index:")
+                                Layout.fillWidth: true
+                                horizontalAlignment: Text.AlignRight
+                            }
+                            ComboBox {
+                                id: power10sOrderTextField
+                                model: rootItem.tile_order
+                                displayText: settings.tile_power_10s_order
+                                Layout.fillHeight: false
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onActivated: {
+                                    displayText = power10sOrderTextField.currentValue
+                                 }
+                            }
+                            Button {
+                                id: okpower10sOrderButton
+                                text: "OK"
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onClicked: settings.tile_power_10s_order = power10sOrderTextField.displayText
+                            }
+                        }
+                    }
+                    AccordionCheckElement {
+                        id: power30sEnabledAccordion
+                        title: qsTr("Power 30s")
+                        linkedBoolSetting: "tile_power_30s_enabled"
+                        settings: settings
+                        accordionContent: RowLayout {
+                            spacing: 10
+                            Label {
+                                id: labelpower30sOrder
+                                text: qsTr("order index:")
+                                Layout.fillWidth: true
+                                horizontalAlignment: Text.AlignRight
+                            }
+                            ComboBox {
+                                id: power30sOrderTextField
+                                model: rootItem.tile_order
+                                displayText: settings.tile_power_30s_order
+                                Layout.fillHeight: false
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onActivated: {
+                                    displayText = power30sOrderTextField.currentValue
+                                 }
+                            }
+                            Button {
+                                id: okpower30sOrderButton
+                                text: "OK"
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onClicked: settings.tile_power_30s_order = power30sOrderTextField.displayText
+                            }
+                        }
+                    }
+                    AccordionCheckElement {
+                        id: normalizedPowerEnabledAccordion
+                        title: qsTr("Normalized Power")
+                        linkedBoolSetting: "tile_normalized_power_enabled"
+                        settings: settings
+                        accordionContent: RowLayout {
+                            spacing: 10
+                            Label {
+                                id: labelnormalizedPowerOrder
+                                text: qsTr("order index:")
+                                Layout.fillWidth: true
+                                horizontalAlignment: Text.AlignRight
+                            }
+                            ComboBox {
+                                id: normalizedPowerOrderTextField
+                                model: rootItem.tile_order
+                                displayText: settings.tile_normalized_power_order
+                                Layout.fillHeight: false
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onActivated: {
+                                    displayText = normalizedPowerOrderTextField.currentValue
+                                 }
+                            }
+                            Button {
+                                id: oknormalizedPowerOrderButton
+                                text: "OK"
+                                Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                onClicked: settings.tile_normalized_power_order = normalizedPowerOrderTextField.displayText
+                            }
+                        }
+                    }
                 }
             }
 
@@ -6574,6 +6711,63 @@ import Qt.labs.settings 1.0
                         linkedBoolSetting: "virtual_device_enabled"
                         settings: settings
                         accordionContent: ColumnLayout {
+                            RowLayout {
+                                spacing: 10
+                                Label {
+                                    id: labelVirtualDeviceNotificationRate
+                                    text: qsTr("Max Notification Rate (Hz):")
+                                    Layout.fillWidth: true
+                                }
+                                TextField {
+                                    id: virtualDeviceNotificationRateTextField
+                                    text: settings.virtual_device_notification_rate
+                                    horizontalAlignment: Text.AlignRight
+                                    Layout.fillHeight: false
+                                    Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                    inputMethodHints: Qt.ImhDigitsOnly
+                                    onAccepted: settings.virtual_device_notification_rate = text
+                                }
+                                Button {
+                                    id: okVirtualDeviceNotificationRate
+                                    text: "OK"
+                                    Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                    onClicked: settings.virtual_device_notification_rate = virtualDeviceNotificationRateTextField.text
+                                }
+                            }
+                            RowLayout {
+                                spacing: 10
+                                Label {
+                                    id: labelVirtualDeviceKeepAlive
+                                    text: qsTr("Keep-alive Interval (ms):")
+                                    Layout.fillWidth: true
+                                }
+                                TextField {
+                                    id: virtualDeviceKeepAliveTextField
+                                    text: settings.virtual_device_keepalive_ms
+                                    horizontalAlignment: Text.AlignRight
+                                    Layout.fillHeight: false
+                                    Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                    inputMethodHints: Qt.ImhDigitsOnly
+                                    onAccepted: settings.virtual_device_keepalive_ms = text
+                                }
+                                Button {
+                                    id: okVirtualDeviceKeepAlive
+                                    text: "OK"
+                                    Layout.alignment: Qt.AlignRight | Qt.AlignVCenter
+                                    onClicked: settings.virtual_device_keepalive_ms = virtualDeviceKeepAliveTextField.text
+                                }
+                            }
+                            Label {
+                                text: qsTr("The virtual device sends its data as soon as the equipment updates it, up to this many times per second, and at least once per keep-alive interval when nothing changes. Lower the rate if your app has issues with fast updates. Restart the app to apply.")
+                                font.bold: true
+                                font.italic: true
+                                font.pixelSize: 8
+                                textFormat: Text.PlainText
+                                wrapMode: Text.WordWrap
+                                verticalAlignment: Text.AlignVCenter
+                                Layout.fillWidth: true
+                                color: Material.color(Material.Red)
+                            }
                             AccordionCheckElement {
                                 id: virtualBeviceBluetoothAccordion
                                 title: qsTr("Virtual Device Bluetooth")
@@ -6894,6 +7088,33 @@ import Qt.labs.settings 1.0
                         onClicked: settings.log_debug = checked
                     }
 
+                    SwitchDelegate {
+                        id: latencyTraceDelegate
+                        text: qsTr("Latency Trace")
+                        spacing: 0
+                        bottomPadding: 0
+                        topPadding: 0
+                        rightPadding: 0
+                        leftPadding: 0
+                        clip: false
+                        checked: settings.latency_trace
+                        Layout.alignment: Qt.AlignLeft | Qt.AlignTop
+                        Layout.fillWidth: true
+                        onClicked: settings.latency_trace = checked
+                    }
+
+                    Label {
+                        text: qsTr("Measures how long the data takes from your equipment to the virtual device, and the commands from your app to the equipment. The results are on the /latency page of the web server. Restart the app to apply.")
+                        font.bold: true
+                        font.italic: true
+                        font.pixelSize: 8
+                        textFormat: Text.PlainText
+                        wrapMode: Text.WordWrap
+                        verticalAlignment: Text.AlignVCenter
+                        Layout.fillWidth: true
+                        color: Material.color(Material.Red)
+                    }
+
                     Button {
                         id: clearLogs
                         text: "Clear History"
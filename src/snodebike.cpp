@@ -1,4 +1,5 @@
 #include "snodebike.h"
+#include "qzsettingscache.h"
 
 #include "ftmsbike.h"
 
@@ -116,7 +117,7 @@ void snodebike::characteristicChanged(const QLowEnergyCharacteristic &characteri
     double heart = 0.0;
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
@@ -1,4 +1,5 @@
 #include "soleelliptical.h"
+#include "qzsettingscache.h"
 
 #include "keepawakehelper.h"
 #include "virtualtreadmill.h"
@@ -231,7 +232,7 @@ void soleelliptical::characteristicChanged(const QLowEnergyCharacteristic &chara
 
     // qDebug() << "characteristicChanged" << characteristic.uuid() << newValue << newValue.length();
     Q_UNUSED(characteristic);
-    QSettings settings;
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     QString heartRateBeltName =
         settings.value(QZSettings::heart_rate_belt_name, QZSettings::default_heart_rate_belt_name).toString();
 
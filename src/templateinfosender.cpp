@@ -1,5 +1,8 @@
 #include "templateinfosender.h"
 #include "qdebugfixup.h"
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
 #include <chrono>
 
 using namespace std::chrono_literals;
@@ -14,19 +17,256 @@ TemplateInfoSender::TemplateInfoSender(const QString &id, QObject *parent) : QOb
 
 TemplateInfoSender::~TemplateInfoSender() { stop(); }
 
-bool TemplateInfoSender::init(const QString &script) {
+// The template scripts are programs whose value is the one of their last expression, e.g.
+//   let pad = function(num, size) { ... };
+//   getstring(this.workout)
+// To parse them once, the statements before the last expression become the body of a function that returns it.
+// scanScript() finds the places where a top level statement may end (after ';', after a closing '}' and at a line
+// break) and tells whether the script declares globals: a top level var or function declaration would become local
+// to that function, and a template keeping state in it across updates would lose it.
+namespace {
+
+struct scriptscan {
+    bool ok = false;
+    bool globals = false;
+    QVector<int> boundaries;
+};
+
+bool identStart(QChar c) { return c.isLetter() || c == QLatin1Char('_') || c == QLatin1Char('$'); }
+bool identPart(QChar c) { return c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('$'); }
+
+// after these tokens an expression starts: a '/' is a regular expression literal, not a division, and
+// 'function' a function expression, not a declaration. orStatement: the start of a statement counts too
+bool expressionExpected(QChar prev, const QString &prevWord, bool orStatement = false) {
+    static const QStringList keywords = {
+        QStringLiteral("return"), QStringLiteral("typeof"), QStringLiteral("case"), QStringLiteral("do"),
+        QStringLiteral("else"),   QStringLiteral("in"),     QStringLiteral("of"),   QStringLiteral("new"),
+        QStringLiteral("delete"), QStringLiteral("void"),   QStringLiteral("throw")};
+    if (!prevWord.isEmpty())
+        return keywords.contains(prevWord);
+    if (prev.isNull())
+        return orStatement;
+    return QStringLiteral("(,=:[!&|?+-*%<>~^").contains(prev) || (orStatement && QStringLiteral("{};").contains(prev));
+}
+
+scriptscan scanScript(const QString &body) {
+    scriptscan r;
+    const int n = body.size();
+    QVector<QChar> brackets;      // the open ( [ { and ${
+    QVector<bool> functionBodies; // per open '{': it is the body of a function
+    int functions = 0;            // function bodies currently open
+    bool functionPending = false; // 'function' or '=>' seen, its body is the next '{'
+    bool arrowPending = false;    // '=>' was the last token
+    QChar prev;                   // last significant character outside a word
+    QString prevWord;             // last word, when it is the last significant token
+    for (int i = 0; i < n; i++) {
+        const QChar c = body.at(i);
+        if (c == QLatin1Char('\n')) {
+            if (brackets.isEmpty())
+                r.boundaries.append(i + 1);
+            continue;
+        }
+        if (c.isSpace())
+            continue;
+        if (c == QLatin1Char('/') && i + 1 < n && body.at(i + 1) == QLatin1Char('/')) {
+            i = body.indexOf(QLatin1Char('\n'), i) - 1; // the line break is a boundary too
+            if (i < 0)
+                break;
+            continue;
+        }
+        if (c == QLatin1Char('/') && i + 1 < n && body.at(i + 1) == QLatin1Char('*')) {
+            i = body.indexOf(QStringLiteral("*/"), i + 2);
+            if (i < 0)
+                return r;
+            i++;
+            continue;
+        }
+        if (arrowPending) {
+            // an arrow function with an expression body has no block
+            arrowPending = false;
+            if (c != QLatin1Char('{'))
+                functionPending = false;
+        }
+        if (identStart(c)) {
+            int j = i;
+            while (j < n && identPart(body.at(j)))
+                j++;
+            const QString word = body.mid(i, j - i);
+            if (functions == 0) {
+                if (word == QStringLiteral("var"))
+                    r.globals = true;
+                else if (word == QStringLiteral("function") && !expressionExpected(prev, prevWord))
+                    r.globals = true; // a declaration, not a function expression
+            }
+            if (word == QStringLiteral("function"))
+                functionPending = true;
+            prevWord = word;
+            prev = QChar();
+            i = j - 1;
+            continue;
+        }
+        if (c.isDigit()) {
+            while (i + 1 < n && (identPart(body.at(i + 1)) || body.at(i + 1) == QLatin1Char('.')))
+                i++;
+            prevWord.clear();
+            prev = QLatin1Char('0');
+            continue;
+        }
+        if (c == QLatin1Char('\'') || c == QLatin1Char('"')) {
+            for (i++; i < n && body.at(i) != c; i++) {
+                if (body.at(i) == QLatin1Char('\\'))
+                    i++;
+                else if (body.at(i) == QLatin1Char('\n'))
+                    return r;
+            }
+            if (i >= n)
+                return r;
+            prevWord.clear();
+            prev = QLatin1Char('0');
+            continue;
+        }
+        if (c == QLatin1Char('`') || (c == QLatin1Char('}') && !brackets.isEmpty() && brackets.last() == QLatin1Char('$'))) {
+            // a template literal, or its text after a ${ } substitution
+            if (c == QLatin1Char('}'))
+                brackets.removeLast();
+            for (i++; i < n && body.at(i) != QLatin1Char('`'); i++) {
+                if (body.at(i) == QLatin1Char('\\')) {
+                    i++;
+                } else if (body.at(i) == QLatin1Char('$') && i + 1 < n && body.at(i + 1) == QLatin1Char('{')) {
+                    brackets.append(QLatin1Char('$'));
+                    i++;
+                    break;
+                }
+            }
+            if (i >= n)
+                return r;
+            prevWord.clear();
+            prev = body.at(i) == QLatin1Char('`') ? QLatin1Char('0') : QLatin1Char('(');
+            continue;
+        }
+        if (c == QLatin1Char('/') && expressionExpected(prev, prevWord, true)) {
+            bool inClass = false;
+            for (i++; i < n; i++) {
+                const QChar d = body.at(i);
+                if (d == QLatin1Char('\n'))
+                    return r;
+                if (d == QLatin1Char('\\'))
+                    i++;
+                else if (d == QLatin1Char('['))
+                    inClass = true;
+                else if (d == QLatin1Char(']'))
+                    inClass = false;
+                else if (d == QLatin1Char('/') && !inClass)
+                    break;
+            }
+            if (i >= n)
+                return r;
+            while (i + 1 < n && identPart(body.at(i + 1)))
+                i++;
+            prevWord.clear();
+            prev = QLatin1Char('0');
+            continue;
+        }
+
+        if (c == QLatin1Char('=') && i + 1 < n && body.at(i + 1) == QLatin1Char('>')) {
+            functionPending = true;
+            arrowPending = true;
+            i++;
+            prevWord.clear();
+            prev = QLatin1Char('=');
+            continue;
+        }
+        if (c == QLatin1Char('{')) {
+            functionBodies.append(functionPending);
+            if (functionPending)
+                functions++;
+            functionPending = false;
+            brackets.append(c);
+        } else if (c == QLatin1Char('(') || c == QLatin1Char('[')) {
+            brackets.append(c);
+        } else if (c == QLatin1Char(')') || c == QLatin1Char(']') || c == QLatin1Char('}')) {
+            const QChar open = c == QLatin1Char(')') ? QLatin1Char('(') : c == QLatin1Char(']') ? QLatin1Char('[')
+                                                                                                 : QLatin1Char('{');
+            if (brackets.isEmpty() || brackets.last() != open)
+                return r;
+            brackets.removeLast();
+            if (c == QLatin1Char('}')) {
+                if (functionBodies.takeLast())
+                    functions--;
+                if (brackets.isEmpty())
+                    r.boundaries.append(i + 1);
+            }
+        } else {
+            if (c == QLatin1Char(';') && brackets.isEmpty())
+                r.boundaries.append(i + 1);
+        }
+        prevWord.clear();
+        prev = c;
+    }
+    r.ok = brackets.isEmpty();
+    return r;
+}
+
+// whether text can start a statement of its own after the previous one: a line starting with one of these
+// continues the expression of the previous line instead
+bool startsStatement(const QString &text) {
+    static const QRegularExpression continuation(
+        QStringLiteral("^([-+*/%(\\[`.,?:=<>&|^]|(in|instanceof|else|catch|finally|while)\\b)"));
+    static const QRegularExpression statement(
+        QStringLiteral("^(let|var|const|function|class|if|for|while|do|switch|try|throw|return|break|continue)\\b"));
+    return !text.isEmpty() && !continuation.match(text).hasMatch() && !statement.match(text).hasMatch();
+}
+
+} // namespace
+
+bool TemplateInfoSender::init(const QString &script, QJSEngine *eng) {
     jscript = script;
+    compile(eng);
     stop();
     return init();
 }
 
+void TemplateInfoSender::setScript(const QString &script, QJSEngine *eng) {
+    jscript = script;
+    compile(eng);
+}
+
+void TemplateInfoSender::compile(QJSEngine *eng) {
+    compiled = QJSValue();
+    QString body = jscript;
+    while (!body.isEmpty() && (body.at(body.size() - 1).isSpace() || body.at(body.size() - 1) == QLatin1Char(';')))
+        body.chop(1);
+    const scriptscan scan = scanScript(body);
+    if (scan.ok && !scan.globals) {
+        // the shortest candidate for the last expression first. The engine rejects a split in the middle of a
+        // statement: the body or the returned expression does not parse, and the previous boundary is tried
+        QString tried;
+        int attempts = 0;
+        for (int b = scan.boundaries.size() - 1; b >= -1 && attempts < 4; b--) {
+            const int at = b < 0 ? 0 : scan.boundaries.at(b);
+            const QString last = body.mid(at).trimmed();
+            if (last == tried || !startsStatement(last))
+                continue;
+            tried = last;
+            attempts++;
+            QJSValue f =
+                eng->evaluate(QStringLiteral("(function() {\n%1\nreturn (\n%2\n);\n})").arg(body.left(at), last));
+            if (f.isCallable()) {
+                compiled = f;
+                return;
+            }
+        }
+    }
+    // top level var or function declarations, or no last expression found: evaluate() keeps the exact semantics
+    qDebug() << QStringLiteral("Template") << templateId << QStringLiteral("script evaluated at every update");
+}
+
 bool TemplateInfoSender::update(QJSEngine *eng) {
     if (!jscript.isEmpty()) {
-        QJSValue jsv = eng->evaluate(jscript);
+        QJSValue jsv =
+            compiled.isCallable() ? compiled.callWithInstance(eng->globalObject()) : eng->evaluate(jscript);
         if (!jsv.isError()) {
-            QString evalres = jsv.toString();
-            qDebug() << QStringLiteral("eval res ") << evalres;
-            return send(evalres);
+            return send(jsv.toString());
         } else {
 #if (QT_VERSION < QT_VERSION_CHECK(5, 12, 0))
             int errorType = 255;
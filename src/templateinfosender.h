@@ -12,7 +12,8 @@ class TemplateInfoSender : public QObject {
     virtual ~TemplateInfoSender();
     virtual bool isRunning() const = 0;
     virtual bool send(const QString &data) = 0;
-    bool init(const QString &script);
+    bool init(const QString &script, QJSEngine *eng);
+    void setScript(const QString &script, QJSEngine *eng);
     void stop();
     bool update(QJSEngine *eng);
     QString js() const;
@@ -26,10 +27,12 @@ class TemplateInfoSender : public QObject {
     QString templateId;
     QSettings settings;
     QString jscript;
+    QJSValue compiled;
   protected slots:
     void reinit();
 
   private:
+    void compile(QJSEngine *eng);
     QTimer retryTimer;
 };
 
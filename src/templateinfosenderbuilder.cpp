@@ -13,17 +13,116 @@
 #include "webserverinfosender.h"
 #endif
 #include "homeform.h"
+#include "qzsettingscache.h"
 #include "tcpclientinfosender.h"
 #include "trainprogram.h"
 #include <chrono>
+#include <cstring>
 
 using namespace std::chrono_literals;
 
+namespace {
+
+enum fieldkind : quint8 { FK_NUMBER, FK_FLAG, FK_TEXT };
+
+struct workoutfieldspec {
+    const char *name;
+    fieldkind kind;
+};
+
+// in the order of TemplateInfoSenderBuilder::workoutfield
+const workoutfieldspec workoutFields[] = {
+    {"BIKE_TYPE", FK_NUMBER},
+    {"ELLIPTICAL_TYPE", FK_NUMBER},
+    {"ROWING_TYPE", FK_NUMBER},
+    {"TREADMILL_TYPE", FK_NUMBER},
+    {"UNKNOWN_TYPE", FK_NUMBER},
+    {"deviceId", FK_TEXT},
+    {"deviceName", FK_TEXT},
+    {"deviceRSSI", FK_NUMBER},
+    {"deviceType", FK_NUMBER},
+    {"deviceConnected", FK_FLAG},
+    {"devicePaused", FK_FLAG},
+    {"elapsed_s", FK_NUMBER},
+    {"elapsed_m", FK_NUMBER},
+    {"elapsed_h", FK_NUMBER},
+    {"pace_s", FK_NUMBER},
+    {"pace_m", FK_NUMBER},
+    {"pace_h", FK_NUMBER},
+    {"moving_s", FK_NUMBER},
+    {"moving_m", FK_NUMBER},
+    {"moving_h", FK_NUMBER},
+    {"speed", FK_NUMBER},
+    {"speed_avg", FK_NUMBER},
+    {"calories", FK_NUMBER},
+    {"distance", FK_NUMBER},
+    {"heart", FK_NUMBER},
+    {"heart_avg", FK_NUMBER},
+    {"heart_max", FK_NUMBER},
+    {"jouls", FK_NUMBER},
+    {"elevation", FK_NUMBER},
+    {"difficult", FK_NUMBER},
+    {"watts", FK_NUMBER},
+    {"watts_avg", FK_NUMBER},
+    {"watts_max", FK_NUMBER},
+    {"watts_3s", FK_NUMBER},
+    {"watts_10s", FK_NUMBER},
+    {"watts_30s", FK_NUMBER},
+    {"watts_np", FK_NUMBER},
+    {"watts_vi", FK_NUMBER},
+    {"kgwatts", FK_NUMBER},
+    {"kgwatts_avg", FK_NUMBER},
+    {"kgwatts_max", FK_NUMBER},
+    {"workoutName", FK_TEXT},
+    {"workoutStartDate", FK_TEXT},
+    {"instructorName", FK_TEXT},
+    {"latitude", FK_NUMBER},
+    {"longitude", FK_NUMBER},
+    {"altitude", FK_NUMBER},
+    {"nickName", FK_TEXT},
+    {"peloton_resistance", FK_NUMBER},
+    {"peloton_req_resistance", FK_NUMBER},
+    {"peloton_resistance_avg", FK_NUMBER},
+    {"cadence", FK_NUMBER},
+    {"cadence_avg", FK_NUMBER},
+    {"resistance", FK_NUMBER},
+    {"resistance_avg", FK_NUMBER},
+    {"cranks", FK_NUMBER},
+    {"cranktime", FK_NUMBER},
+    {"req_power", FK_NUMBER},
+    {"req_cadence", FK_NUMBER},
+    {"req_resistance", FK_NUMBER},
+    {"strokescount", FK_NUMBER},
+    {"strokeslength", FK_NUMBER},
+    {"inclination", FK_NUMBER},
+    {"inclination_avg", FK_NUMBER},
+    {"stridelength", FK_NUMBER},
+    {"groundcontact", FK_NUMBER},
+    {"verticaloscillation", FK_NUMBER},
+};
+
+const QString &fieldName(int f) {
+    static const QVector<QString> names = []() {
+        QVector<QString> rv;
+        for (const workoutfieldspec &spec : workoutFields)
+            rv.append(QString::fromLatin1(spec.name));
+        return rv;
+    }();
+    return names.at(f);
+}
+
+} // namespace
+
 QHash<QString, TemplateInfoSenderBuilder *> TemplateInfoSenderBuilder::instanceMap;
 TemplateInfoSenderBuilder::TemplateInfoSenderBuilder(QObject *parent) : QObject(parent) {
     engine = new QJSEngine(this);
     engine->installExtensions(QJSEngine::AllExtensions);
     connect(&updateTimer, &QTimer::timeout, this, &TemplateInfoSenderBuilder::onUpdateTimeout);
+    connect(&templateWatcher, &QFileSystemWatcher::fileChanged, this,
+            &TemplateInfoSenderBuilder::onTemplateFileChanged);
+    connect(&templateWatcher, &QFileSystemWatcher::directoryChanged, this,
+            &TemplateInfoSenderBuilder::onTemplateDirChanged);
+    static_assert(sizeof(workoutFields) / sizeof(workoutFields[0]) == WF_COUNT, "one spec per workout field");
     updateTimer.setSingleShot(false);
 }
 
@@ -99,7 +198,8 @@ void TemplateInfoSenderBuilder::createTemplatesFromFolder(const QString &idInfo,
                     } else if (settings
                                    .value(QStringLiteral("template_") + templateId + QStringLiteral("_enabled"), false)
                                    .toBool()) {
-                        newTemplate(templateId, tempType, content);
+                        if (newTemplate(templateId, tempType, content))
+                            watchTemplateFile(filePath);
                     } else {
                         qDebug() << QStringLiteral("Template") << templateId
                                  << QStringLiteral(" is disabled: not created");
@@ -123,6 +223,10 @@ void TemplateInfoSenderBuilder::load(const QString &idInfo, const QStringList &f
     foldersToLook = folders;
     templateInfoMap.clear();
     templateFilesList.clear();
+    if (!templateWatcher.files().isEmpty())
+        templateWatcher.removePaths(templateWatcher.files());
+    if (!templateWatcher.directories().isEmpty())
+        templateWatcher.removePaths(templateWatcher.directories());
     QStringList globalIdList, globalFolderList;
     int startIdIndex = 0;
     for (auto &tdir : folders) {
@@ -185,7 +289,7 @@ TemplateInfoSender *TemplateInfoSenderBuilder::newTemplate(const QString &id, co
         qDebug() << QStringLiteral("Template Registered") << id << QStringLiteral(" type") << tp
                  << QStringLiteral(" Template") << dataTempl;
         templateInfoMap.insert(id, tempInfo);
-        tempInfo->init(dataTempl);
+        tempInfo->init(dataTempl, engine);
         connect(tempInfo, &TemplateInfoSender::onDataReceived, this, &TemplateInfoSenderBuilder::onDataReceived);
     }
     return tempInfo;
@@ -193,13 +297,57 @@ TemplateInfoSender *TemplateInfoSenderBuilder::newTemplate(const QString &id, co
 
 void TemplateInfoSenderBuilder::reinit() { load(masterId, foldersToLook); }
 
-void TemplateInfoSenderBuilder::clearSessionArray() {
-    int len = sessionArray.count();
-    for (int i = 0; i < len; i++) {
-        sessionArray.removeAt(0);
+// the script of a running template is compiled again when its file changes, without restarting the sender
+void TemplateInfoSenderBuilder::watchTemplateFile(const QString &path) {
+    // the directory too: editors that save through a rename drop the file from the watcher, and the new file may
+    // not exist yet when fileChanged arrives. Its creation is then seen as a change of the directory
+    if (path.startsWith(QLatin1Char(':')))
+        return; // the inner templates are resources, they never change
+    const QString dir = QFileInfo(path).absolutePath();
+    if (!templateWatcher.directories().contains(dir))
+        templateWatcher.addPath(dir);
+    if (!templateWatcher.files().contains(path) && QFile::exists(path))
+        templateWatcher.addPath(path);
+}
+
+void TemplateInfoSenderBuilder::onTemplateDirChanged(const QString &dir) {
+    for (auto it = templateFilesList.constBegin(); it != templateFilesList.constEnd(); ++it) {
+        if (templateInfoMap.contains(it.key()) && !templateWatcher.files().contains(it.value()) &&
+            QFileInfo(it.value()).absolutePath() == dir && QFile::exists(it.value()))
+            onTemplateFileChanged(it.value());
+    }
+}
+
+void TemplateInfoSenderBuilder::onTemplateFileChanged(const QString &path) {
+    // before reading: a change made between the read and the re-add would be missed
+    watchTemplateFile(path);
+    QFile f(path);
+    if (!f.open(QFile::ReadOnly | QFile::Text))
+        return;
+    QTextStream in(&f);
+    const QString content = in.readAll();
+    if (content.isEmpty())
+        return;
+    for (auto it = templateFilesList.constBegin(); it != templateFilesList.constEnd(); ++it) {
+        TemplateInfoSender *tempInfo;
+        if (it.value() == path && (tempInfo = templateInfoMap.value(it.key(), nullptr))) {
+            qDebug() << QStringLiteral("Template") << it.key() << QStringLiteral("changed: script compiled again");
+            tempInfo->setScript(content, engine);
+        }
     }
 }
 
+void TemplateInfoSenderBuilder::clearSessionArray() {
+    sessionValues.clear();
+    sessionLayouts.clear();
+    sessionStrings.clear();
+    sessionStringIndex.clear();
+    // the text fields hold indexes in sessionStrings: write them again
+    for (int f = 0; f < WF_COUNT; f++)
+        if (workoutFields[f].kind == FK_TEXT)
+            workoutWritten.clearBit(f);
+}
+
 void TemplateInfoSenderBuilder::start(bluetoothdevice *dev) {
     device = nullptr;
     clearSessionArray();
@@ -383,14 +531,17 @@ void TemplateInfoSenderBuilder::onSetSettings(const QJsonValue &msgContent, Temp
             valConv = val.toVariant();
             settingVal = settings.value(key);
             if (valConv.type() == settingVal.type()) {
-                settings.setValue(key, valConv);
+                // through the cache, so the app sees the new value at once
+                QZSettingsCache::instance()->setValue(key, valConv);
+                setSetting(key, valConv);
                 outObj.insert(key, val);
             } else {
                 outObj.insert(key, QJsonValue::fromVariant(settingVal));
             }
         } else {
             val = obj[key];
-            settings.setValue(key, val.toVariant());
+            QZSettingsCache::instance()->setValue(key, val.toVariant());
+            setSetting(key, val.toVariant());
             outObj.insert(key, val);
         }
     }
@@ -471,7 +622,7 @@ void TemplateInfoSenderBuilder::onAppendActivityDescription(const QJsonValue &ms
 
 void TemplateInfoSenderBuilder::onGetSessionArray(TemplateInfoSender *tempSender) {
     QJsonObject main;
-    main[QStringLiteral("content")] = sessionArray;
+    main[QStringLiteral("content")] = sessionJson();
     main[QStringLiteral("msg")] = QStringLiteral("R_getsessionarray");
     QJsonDocument out(main);
     tempSender->send(out.toJson());
@@ -735,153 +886,279 @@ void TemplateInfoSenderBuilder::onDataReceived(const QByteArray &data) {
     // qDebug() << QStringLiteral("Unrecognized message") << data;
 }
 
-void TemplateInfoSenderBuilder::buildContext(bool forceReinit) {
-    QJSValue glob = engine->globalObject();
-    QJSValue obj;
-    if (!glob.hasOwnProperty(QStringLiteral("workout")) || forceReinit) {
-        obj = engine->newObject();
-        glob.setProperty(QStringLiteral("workout"), obj);
-    } else
-        obj = glob.property(QStringLiteral("workout"));
+bool TemplateInfoSenderBuilder::workoutChanged(workoutfield f, double v) {
+    if (workoutWritten.testBit(f) && (workoutValues[f] == v || (qIsNaN(v) && qIsNaN(workoutValues[f]))))
+        return false;
+    workoutWritten.setBit(f);
+    workoutValues[f] = v;
+    return true;
+}
+
+void TemplateInfoSenderBuilder::setWorkoutNumber(workoutfield f, double v) {
+    if (workoutChanged(f, v))
+        workoutObj.setProperty(fieldName(f), v);
+}
 
-    if (!glob.hasOwnProperty(QStringLiteral("settings")) || forceReinit) {
-        QJSValue sett = engine->newObject();
-        glob.setProperty(QStringLiteral("settings"), sett);
-        QVariant::Type typesett;
-        QVariant valsett;
+void TemplateInfoSenderBuilder::setWorkoutFlag(workoutfield f, bool v) {
+    if (workoutChanged(f, v ? 1 : 0))
+        workoutObj.setProperty(fieldName(f), v);
+}
+
+void TemplateInfoSenderBuilder::setWorkoutText(workoutfield f, const QString &v) {
+    if (workoutChanged(f, sessionString(v)))
+        workoutObj.setProperty(fieldName(f), v);
+}
+
+void TemplateInfoSenderBuilder::unsetWorkout(workoutfield f) {
+    if (workoutWritten.testBit(f) || !workoutObj.hasOwnProperty(fieldName(f))) {
+        workoutWritten.clearBit(f);
+        workoutObj.setProperty(fieldName(f), QJSValue());
+    }
+}
+
+int TemplateInfoSenderBuilder::sessionString(const QString &s) {
+    auto it = sessionStringIndex.constFind(s);
+    if (it != sessionStringIndex.constEnd())
+        return it.value();
+    sessionStrings.append(s);
+    sessionStringIndex.insert(s, sessionStrings.size() - 1);
+    return sessionStrings.size() - 1;
+}
+
+void TemplateInfoSenderBuilder::setSetting(const QString &key, const QVariant &value) {
+    if (settingsObj.isUndefined())
+        return;
+    switch (value.type()) {
+    case QVariant::Int:
+        settingsObj.setProperty(key, value.toInt());
+        break;
+    case QVariant::Double:
+        settingsObj.setProperty(key, value.toDouble());
+        break;
+    case QVariant::String:
+        settingsObj.setProperty(key, value.toString());
+        break;
+    case QVariant::Bool:
+        settingsObj.setProperty(key, value.toBool());
+        break;
+    case QVariant::UInt:
+        settingsObj.setProperty(key, value.toUInt());
+        break;
+    case QVariant::StringList: {
+        const QStringList settL = value.toStringList();
+        QJSValue settLJ = engine->newArray(settL.size());
         int i = 0;
+        for (const auto &settLK : settL) {
+            settLJ.setProperty(i++, settLK);
+        }
+        settingsObj.setProperty(key, settLJ);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void TemplateInfoSenderBuilder::onSettingChanged(const QString &key, const QVariant &value) {
+    if (value.isValid())
+        setSetting(key, value);
+    else if (!settingsObj.isUndefined())
+        settingsObj.deleteProperty(key);
+}
+
+void TemplateInfoSenderBuilder::appendSessionSample() {
+    if (sessionLayouts.isEmpty() || sessionLayouts.last().fields != workoutWritten)
+        sessionLayouts.append({sessionValues.size() / WF_COUNT, workoutWritten});
+    const int at = sessionValues.size();
+    sessionValues.resize(at + WF_COUNT);
+    memcpy(sessionValues.data() + at, workoutValues, sizeof(workoutValues));
+}
+
+QJsonArray TemplateInfoSenderBuilder::sessionJson() const {
+    QJsonArray rv;
+    const int samples = sessionValues.size() / WF_COUNT;
+    int layout = 0;
+    for (int s = 0; s < samples; s++) {
+        while (layout + 1 < sessionLayouts.size() && sessionLayouts.at(layout + 1).from <= s)
+            layout++;
+        const QBitArray &fields = sessionLayouts.at(layout).fields;
+        const double *row = sessionValues.constData() + s * WF_COUNT;
+        QJsonObject sample;
+        for (int f = 0; f < WF_COUNT; f++) {
+            if (!fields.testBit(f))
+                continue;
+            switch (workoutFields[f].kind) {
+            case FK_NUMBER:
+                sample.insert(fieldName(f), row[f]);
+                break;
+            case FK_FLAG:
+                sample.insert(fieldName(f), row[f] != 0);
+                break;
+            case FK_TEXT:
+                sample.insert(fieldName(f), sessionStrings.at((int)row[f]));
+                break;
+            }
+        }
+        rv.append(sample);
+    }
+    return rv;
+}
+
+void TemplateInfoSenderBuilder::buildContext(bool forceReinit) {
+    QJSValue glob = engine->globalObject();
+    if (settingsObj.isUndefined()) {
+        // mirrored once: then QZSettingsCache::valueChanged (writes through the cache and its reloads) and
+        // onSetSettings keep it in sync
+        settingsObj = engine->newObject();
+        glob.setProperty(QStringLiteral("settings"), settingsObj);
         auto allKeys_list = settings.allKeys();
         for (const auto &key : allKeys_list) {
-            valsett.setValue(settings.value(key));
-            typesett = valsett.type();
-            if (typesett == QVariant::Int) {
-                sett.setProperty(key, valsett.toInt());
-            } else if (typesett == QVariant::Double) {
-                sett.setProperty(key, valsett.toDouble());
-            } else if (typesett == QVariant::String) {
-                sett.setProperty(key, valsett.toString());
-            } else if (typesett == QVariant::Bool) {
-                sett.setProperty(key, valsett.toBool());
-            } else if (typesett == QVariant::UInt) {
-                sett.setProperty(key, valsett.toUInt());
-            } else if (typesett == QVariant::StringList) {
-                QStringList settL = valsett.toStringList();
-                QJSValue settLJ = engine->newArray(settL.size());
-                i = 0;
-                for (const auto &settLK : qAsConst(settL)) {
-                    settLJ.setProperty(i++, settLK);
-                }
-                sett.setProperty(key, settLJ);
-            }
+            setSetting(key, settings.value(key));
         }
-        obj.setProperty(QStringLiteral("BIKE_TYPE"), (int)bluetoothdevice::BIKE);
-        obj.setProperty(QStringLiteral("ELLIPTICAL_TYPE"), (int)bluetoothdevice::ELLIPTICAL);
-        obj.setProperty(QStringLiteral("ROWING_TYPE"), (int)bluetoothdevice::ROWING);
-        obj.setProperty(QStringLiteral("TREADMILL_TYPE"), (int)bluetoothdevice::TREADMILL);
-        obj.setProperty(QStringLiteral("UNKNOWN_TYPE"), (int)bluetoothdevice::UNKNOWN);
+        connect(QZSettingsCache::instance(), &QZSettingsCache::valueChanged, this,
+                &TemplateInfoSenderBuilder::onSettingChanged, Qt::UniqueConnection);
+    }
+    if (workoutObj.isUndefined() || forceReinit) {
+        workoutObj = engine->newObject();
+        QJSValue names = engine->newArray(WF_COUNT);
+        for (int f = 0; f < WF_COUNT; f++)
+            names.setProperty(f, fieldName(f));
+        // this.workout is a frozen object with one getter per field reading workoutObj: an assignment from a
+        // script is ignored (or throws in strict mode) instead of leaking into the other templates
+        QJSValue publish = engine->evaluate(QStringLiteral(
+            "(function(global, data, names) {\n"
+            "    var view = {};\n"
+            "    names.forEach(function(name) {\n"
+            "        Object.defineProperty(view, name, {get: function() { return data[name]; }, enumerable: true});\n"
+            "    });\n"
+            "    Object.defineProperty(global, 'workout', {value: Object.freeze(view), writable: false,\n"
+            "                                              enumerable: true, configurable: true});\n"
+            "})"));
+        QJSValue rv = publish.call({glob, workoutObj, names});
+        if (rv.isError())
+            qDebug() << QStringLiteral("Cannot publish this.workout:") << rv.toString();
+        workoutWritten.fill(false);
+        setWorkoutNumber(WF_BIKE_TYPE, (int)bluetoothdevice::BIKE);
+        setWorkoutNumber(WF_ELLIPTICAL_TYPE, (int)bluetoothdevice::ELLIPTICAL);
+        setWorkoutNumber(WF_ROWING_TYPE, (int)bluetoothdevice::ROWING);
+        setWorkoutNumber(WF_TREADMILL_TYPE, (int)bluetoothdevice::TREADMILL);
+        setWorkoutNumber(WF_UNKNOWN_TYPE, (int)bluetoothdevice::UNKNOWN);
     }
     if (!device) {
-        obj.setProperty(QStringLiteral("deviceId"), QJSValue());
+        unsetWorkout(WF_DEVICE_ID);
     } else {
         QTime el = device->elapsedTime();
         QString name;
         QString nickName;
         bluetoothdevice::BLUETOOTH_TYPE tp = device->deviceType();
 
-        metric dep;
 #ifdef Q_OS_IOS
-        obj.setProperty("deviceId", device->bluetoothDevice.deviceUuid().toString());
+        setWorkoutText(WF_DEVICE_ID, device->bluetoothDevice.deviceUuid().toString());
 #else
-        obj.setProperty(QStringLiteral("deviceId"), device->bluetoothDevice.address().toString());
+        setWorkoutText(WF_DEVICE_ID, device->bluetoothDevice.address().toString());
 #endif
-        obj.setProperty(QStringLiteral("deviceName"),
-                        (name = device->bluetoothDevice.name()).isEmpty() ? QString(QStringLiteral("N/A")) : name);
-        obj.setProperty(QStringLiteral("deviceRSSI"), device->bluetoothDevice.rssi());
-        obj.setProperty(QStringLiteral("deviceType"), (int)device->deviceType());
-        obj.setProperty(QStringLiteral("deviceConnected"), (bool)device->connected());
-        obj.setProperty(QStringLiteral("devicePaused"), (bool)device->isPaused());
-        obj.setProperty(QStringLiteral("elapsed_s"), el.second());
-        obj.setProperty(QStringLiteral("elapsed_m"), el.minute());
-        obj.setProperty(QStringLiteral("elapsed_h"), el.hour());
+        setWorkoutText(WF_DEVICE_NAME,
+                       (name = device->bluetoothDevice.name()).isEmpty() ? QString(QStringLiteral("N/A")) : name);
+        setWorkoutNumber(WF_DEVICE_RSSI, device->bluetoothDevice.rssi());
+        setWorkoutNumber(WF_DEVICE_TYPE, (int)device->deviceType());
+        setWorkoutFlag(WF_DEVICE_CONNECTED, (bool)device->connected());
+        setWorkoutFlag(WF_DEVICE_PAUSED, (bool)device->isPaused());
+        setWorkoutNumber(WF_ELAPSED_S, el.second());
+        setWorkoutNumber(WF_ELAPSED_M, el.minute());
+        setWorkoutNumber(WF_ELAPSED_H, el.hour());
         el = device->currentPace();
-        obj.setProperty(QStringLiteral("pace_s"), el.second());
-        obj.setProperty(QStringLiteral("pace_m"), el.minute());
-        obj.setProperty(QStringLiteral("pace_h"), el.hour());
+        setWorkoutNumber(WF_PACE_S, el.second());
+        setWorkoutNumber(WF_PACE_M, el.minute());
+        setWorkoutNumber(WF_PACE_H, el.hour());
         el = device->movingTime();
-        obj.setProperty(QStringLiteral("moving_s"), el.second());
-        obj.setProperty(QStringLiteral("moving_m"), el.minute());
-        obj.setProperty(QStringLiteral("moving_h"), el.hour());
-        obj.setProperty(QStringLiteral("speed"), (dep = device->currentSpeed()).value());
-        obj.setProperty(QStringLiteral("speed_avg"), dep.average());
-        obj.setProperty(QStringLiteral("calories"), device->calories().value());
-        obj.setProperty(QStringLiteral("distance"), device->odometer());
-        obj.setProperty(QStringLiteral("heart"), (dep = device->currentHeart()).value());
-        obj.setProperty(QStringLiteral("heart_avg"), dep.average());
-        obj.setProperty(QStringLiteral("heart_max"), dep.max());
-        obj.setProperty(QStringLiteral("jouls"), device->jouls().value());
-        obj.setProperty(QStringLiteral("elevation"), device->elevationGain().value());
-        obj.setProperty(QStringLiteral("difficult"), device->difficult());
-        obj.setProperty(QStringLiteral("watts"), (dep = device->wattsMetric()).value());
-        obj.setProperty(QStringLiteral("watts_avg"), dep.average());
-        obj.setProperty(QStringLiteral("watts_max"), dep.max());
-        obj.setProperty(QStringLiteral("kgwatts"), (dep = device->wattKg()).value());
-        obj.setProperty(QStringLiteral("kgwatts_avg"), dep.average());
-        obj.setProperty(QStringLiteral("kgwatts_max"), dep.max());
-        obj.setProperty(QStringLiteral("workoutName"), workoutName);
-        obj.setProperty(QStringLiteral("workoutStartDate"), workoutStartDate);
-        obj.setProperty(QStringLiteral("instructorName"), instructorName);
-        obj.setProperty(QStringLiteral("latitude"), device->currentCordinate().latitude());
-        obj.setProperty(QStringLiteral("longitude"), device->currentCordinate().longitude());
-        obj.setProperty(QStringLiteral("altitude"), device->currentCordinate().altitude());
-        obj.setProperty(
-            QStringLiteral("nickName"),
-            (nickName = settings.value(QZSettings::user_nickname, QZSettings::default_user_nickname).toString()).isEmpty()
-                ? QString(QStringLiteral("N/A"))
-                : nickName);
+        setWorkoutNumber(WF_MOVING_S, el.second());
+        setWorkoutNumber(WF_MOVING_M, el.minute());
+        setWorkoutNumber(WF_MOVING_H, el.hour());
+        const metric &speed = device->currentSpeed();
+        setWorkoutNumber(WF_SPEED, speed.value());
+        setWorkoutNumber(WF_SPEED_AVG, speed.average());
+        setWorkoutNumber(WF_CALORIES, device->calories().value());
+        setWorkoutNumber(WF_DISTANCE, device->odometer());
+        const metric &heart = device->currentHeart();
+        setWorkoutNumber(WF_HEART, heart.value());
+        setWorkoutNumber(WF_HEART_AVG, heart.average());
+        setWorkoutNumber(WF_HEART_MAX, heart.max());
+        setWorkoutNumber(WF_JOULS, device->jouls().value());
+        setWorkoutNumber(WF_ELEVATION, device->elevationGain().value());
+        setWorkoutNumber(WF_DIFFICULT, device->difficult());
+        const metric &watts = device->wattsMetric();
+        setWorkoutNumber(WF_WATTS, watts.value());
+        setWorkoutNumber(WF_WATTS_AVG, watts.average());
+        setWorkoutNumber(WF_WATTS_MAX, watts.max());
+        setWorkoutNumber(WF_WATTS_3S, watts.windowAverage(3));
+        setWorkoutNumber(WF_WATTS_10S, watts.windowAverage(10));
+        setWorkoutNumber(WF_WATTS_30S, watts.windowAverage(30));
+        setWorkoutNumber(WF_WATTS_NP, watts.normalizedPower());
+        setWorkoutNumber(WF_WATTS_VI, watts.variabilityIndex());
+        const metric &kgwatts = device->wattKg();
+        setWorkoutNumber(WF_KGWATTS, kgwatts.value());
+        setWorkoutNumber(WF_KGWATTS_AVG, kgwatts.average());
+        setWorkoutNumber(WF_KGWATTS_MAX, kgwatts.max());
+        setWorkoutText(WF_WORKOUT_NAME, workoutName);
+        setWorkoutText(WF_WORKOUT_START_DATE, workoutStartDate);
+        setWorkoutText(WF_INSTRUCTOR_NAME, instructorName);
+        const QGeoCoordinate coordinate = device->currentCordinate();
+        setWorkoutNumber(WF_LATITUDE, coordinate.latitude());
+        setWorkoutNumber(WF_LONGITUDE, coordinate.longitude());
+        setWorkoutNumber(WF_ALTITUDE, coordinate.altitude());
+        setWorkoutText(WF_NICKNAME,
+                       (nickName = QZSettingsCache::instance()->toString(QZSettings::user_nickname,
+                                                                         QZSettings::default_user_nickname))
+                               .isEmpty()
+                           ? QString(QStringLiteral("N/A"))
+                           : nickName);
         if (tp == bluetoothdevice::BIKE) {
-            obj.setProperty(QStringLiteral("peloton_resistance"),
-                            (dep = ((bike *)device)->pelotonResistance()).value());
-            obj.setProperty(QStringLiteral("peloton_req_resistance"),
-                            (dep = ((bike *)device)->lastRequestedPelotonResistance()).value());
-            obj.setProperty(QStringLiteral("peloton_resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cadence"), (dep = ((bike *)device)->currentCadence()).value());
-            obj.setProperty(QStringLiteral("cadence_avg"), dep.average());
-            obj.setProperty(QStringLiteral("resistance"), (dep = ((bike *)device)->currentResistance()).value());
-            obj.setProperty(QStringLiteral("resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cranks"), ((bike *)device)->currentCrankRevolutions());
-            obj.setProperty(QStringLiteral("cranktime"), ((bike *)device)->lastCrankEventTime());
-            obj.setProperty(QStringLiteral("req_power"), (dep = ((bike *)device)->lastRequestedPower()).value());
-            obj.setProperty(QStringLiteral("req_cadence"), (dep = ((bike *)device)->lastRequestedCadence()).value());
-            obj.setProperty(QStringLiteral("req_resistance"),
-                            (dep = ((bike *)device)->lastRequestedResistance()).value());
+            bike *b = (bike *)device;
+            setWorkoutNumber(WF_PELOTON_RESISTANCE, b->pelotonResistance().value());
+            const metric &pelotonRequested = b->lastRequestedPelotonResistance();
+            setWorkoutNumber(WF_PELOTON_REQ_RESISTANCE, pelotonRequested.value());
+            setWorkoutNumber(WF_PELOTON_RESISTANCE_AVG, pelotonRequested.average());
+            const metric &cadence = b->currentCadence();
+            setWorkoutNumber(WF_CADENCE, cadence.value());
+            setWorkoutNumber(WF_CADENCE_AVG, cadence.average());
+            const metric &resistance = b->currentResistance();
+            setWorkoutNumber(WF_RESISTANCE, resistance.value());
+            setWorkoutNumber(WF_RESISTANCE_AVG, resistance.average());
+            setWorkoutNumber(WF_CRANKS, b->currentCrankRevolutions());
+            setWorkoutNumber(WF_CRANKTIME, b->lastCrankEventTime());
+            setWorkoutNumber(WF_REQ_POWER, b->lastRequestedPower().value());
+            setWorkoutNumber(WF_REQ_CADENCE, b->lastRequestedCadence().value());
+            setWorkoutNumber(WF_REQ_RESISTANCE, b->lastRequestedResistance().value());
         } else if (tp == bluetoothdevice::ROWING) {
-            obj.setProperty(QStringLiteral("peloton_resistance"),
-                            (dep = ((rower *)device)->pelotonResistance()).value());
-            obj.setProperty(QStringLiteral("peloton_resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cadence"), (dep = ((rower *)device)->currentCadence()).value());
-            obj.setProperty(QStringLiteral("cadence_avg"), dep.average());
-            obj.setProperty(QStringLiteral("resistance"), (dep = ((rower *)device)->currentResistance()).value());
-            obj.setProperty(QStringLiteral("resistance_avg"), dep.average());
-            obj.setProperty(QStringLiteral("cranks"), ((rower *)device)->currentCrankRevolutions());
-            obj.setProperty(QStringLiteral("cranktime"), ((rower *)device)->lastCrankEventTime());
-            obj.setProperty(QStringLiteral("strokescount"), ((rower *)device)->currentStrokesCount().value());
-            obj.setProperty(QStringLiteral("strokeslength"), ((rower *)device)->currentStrokesLength().value());
+            rower *r = (rower *)device;
+            const metric &peloton = r->pelotonResistance();
+            setWorkoutNumber(WF_PELOTON_RESISTANCE, peloton.value());
+            setWorkoutNumber(WF_PELOTON_RESISTANCE_AVG, peloton.average());
+            const metric &cadence = r->currentCadence();
+            setWorkoutNumber(WF_CADENCE, cadence.value());
+            setWorkoutNumber(WF_CADENCE_AVG, cadence.average());
+            const metric &resistance = r->currentResistance();
+            setWorkoutNumber(WF_RESISTANCE, resistance.value());
+            setWorkoutNumber(WF_RESISTANCE_AVG, resistance.average());
+            setWorkoutNumber(WF_CRANKS, r->currentCrankRevolutions());
+            setWorkoutNumber(WF_CRANKTIME, r->lastCrankEventTime());
+            setWorkoutNumber(WF_STROKESCOUNT, r->currentStrokesCount().value());
+            setWorkoutNumber(WF_STROKESLENGTH, r->currentStrokesLength().value());
         } else if (tp == bluetoothdevice::TREADMILL) {
-            obj.setProperty(QStringLiteral("inclination"), (dep = ((treadmill *)device)->currentInclination()).value());
-            obj.setProperty(QStringLiteral("inclination_avg"), dep.average());
-            obj.setProperty(QStringLiteral("stridelength"),
-                            (dep = ((treadmill *)device)->currentStrideLength()).value());
-            obj.setProperty(QStringLiteral("groundcontact"),
-                            (dep = ((treadmill *)device)->currentGroundContact()).value());
-            obj.setProperty(QStringLiteral("verticaloscillation"),
-                            (dep = ((treadmill *)device)->currentVerticalOscillation()).value());
+            treadmill *t = (treadmill *)device;
+            const metric &inclination = t->currentInclination();
+            setWorkoutNumber(WF_INCLINATION, inclination.value());
+            setWorkoutNumber(WF_INCLINATION_AVG, inclination.average());
+            setWorkoutNumber(WF_STRIDELENGTH, t->currentStrideLength().value());
+            setWorkoutNumber(WF_GROUNDCONTACT, t->currentGroundContact().value());
+            setWorkoutNumber(WF_VERTICALOSCILLATION, t->currentVerticalOscillation().value());
         } else if (tp == bluetoothdevice::ELLIPTICAL) {
-            obj.setProperty(QStringLiteral("inclination"),
-                            (dep = ((elliptical *)device)->currentInclination()).value());
-            obj.setProperty(QStringLiteral("inclination_avg"), dep.average());
+            const metric &inclination = ((elliptical *)device)->currentInclination();
+            setWorkoutNumber(WF_INCLINATION, inclination.value());
+            setWorkoutNumber(WF_INCLINATION_AVG, inclination.average());
         }
         if (!device->isPaused()) {
-            sessionArray.append(QJsonObject::fromVariantMap(obj.toVariant().toMap()));
+            appendSessionSample();
         }
     }
 }
@@ -2,6 +2,8 @@
 #define TEMPLATEINFOSENDERBUILDER_H
 #include "bluetoothdevice.h"
 #include "templateinfosender.h"
+#include <QBitArray>
+#include <QFileSystemWatcher>
 #include <QHash>
 #include <QJSEngine>
 #include <QJsonArray>
@@ -26,8 +28,98 @@ class TemplateInfoSenderBuilder : public QObject {
     void chartSaved(QString filename);
 
   private:
+    /**
+     * @brief The properties of the JS workout object. They are written only when their value changes and every
+     * second of activity is recorded as one row of values in the session history.
+     */
+    enum workoutfield : quint8 {
+        WF_BIKE_TYPE,
+        WF_ELLIPTICAL_TYPE,
+        WF_ROWING_TYPE,
+        WF_TREADMILL_TYPE,
+        WF_UNKNOWN_TYPE,
+        WF_DEVICE_ID,
+        WF_DEVICE_NAME,
+        WF_DEVICE_RSSI,
+        WF_DEVICE_TYPE,
+        WF_DEVICE_CONNECTED,
+        WF_DEVICE_PAUSED,
+        WF_ELAPSED_S,
+        WF_ELAPSED_M,
+        WF_ELAPSED_H,
+        WF_PACE_S,
+        WF_PACE_M,
+        WF_PACE_H,
+        WF_MOVING_S,
+        WF_MOVING_M,
+        WF_MOVING_H,
+        WF_SPEED,
+        WF_SPEED_AVG,
+        WF_CALORIES,
+        WF_DISTANCE,
+        WF_HEART,
+        WF_HEART_AVG,
+        WF_HEART_MAX,
+        WF_JOULS,
+        WF_ELEVATION,
+        WF_DIFFICULT,
+        WF_WATTS,
+        WF_WATTS_AVG,
+        WF_WATTS_MAX,
+        WF_WATTS_3S,
+        WF_WATTS_10S,
+        WF_WATTS_30S,
+        WF_WATTS_NP,
+        WF_WATTS_VI,
+        WF_KGWATTS,
+        WF_KGWATTS_AVG,
+        WF_KGWATTS_MAX,
+        WF_WORKOUT_NAME,
+        WF_WORKOUT_START_DATE,
+        WF_INSTRUCTOR_NAME,
+        WF_LATITUDE,
+        WF_LONGITUDE,
+        WF_ALTITUDE,
+        WF_NICKNAME,
+        WF_PELOTON_RESISTANCE,
+        WF_PELOTON_REQ_RESISTANCE,
+        WF_PELOTON_RESISTANCE_AVG,
+        WF_CADENCE,
+        WF_CADENCE_AVG,
+        WF_RESISTANCE,
+        WF_RESISTANCE_AVG,
+        WF_CRANKS,
+        WF_CRANKTIME,
+        WF_REQ_POWER,
+        WF_REQ_CADENCE,
+        WF_REQ_RESISTANCE,
+        WF_STROKESCOUNT,
+        WF_STROKESLENGTH,
+        WF_INCLINATION,
+        WF_INCLINATION_AVG,
+        WF_STRIDELENGTH,
+        WF_GROUNDCONTACT,
+        WF_VERTICALOSCILLATION,
+        WF_COUNT
+    };
+
+    // the fields a run of the session history has, from the sample `from` on
+    struct sessionlayout {
+        int from;
+        QBitArray fields;
+    };
+
     bool validFileTemplateType(const QString &tp) const;
     void buildContext(bool forceReinit = false);
+    bool workoutChanged(workoutfield f, double v);
+    void setWorkoutNumber(workoutfield f, double v);
+    void setWorkoutFlag(workoutfield f, bool v);
+    void setWorkoutText(workoutfield f, const QString &v);
+    void unsetWorkout(workoutfield f);
+    void setSetting(const QString &key, const QVariant &value);
+    int sessionString(const QString &s);
+    void appendSessionSample();
+    QJsonArray sessionJson() const;
     QString activityDescription;
     void createTemplatesFromFolder(const QString &idInfo, const QString &folder, QStringList &dirTemplates);
     void clearSessionArray();
@@ -35,9 +127,17 @@ class TemplateInfoSenderBuilder : public QObject {
     QTimer updateTimer;
     QString masterId;
     QStringList foldersToLook;
-    QJsonArray sessionArray;
-    QHash<QString, QVariant> context;
     QJSEngine *engine = nullptr;
+    // the values behind this.workout, written by the builder only: the scripts see them through a frozen object of
+    // getters (see buildContext()), so a script cannot change what the others read
+    QJSValue workoutObj;
+    QJSValue settingsObj;
+    double workoutValues[WF_COUNT] = {}; // last written, for the text fields the index in sessionStrings
+    QBitArray workoutWritten = QBitArray(WF_COUNT);
+    QVector<double> sessionValues; // WF_COUNT values per sample
+    QVector<sessionlayout> sessionLayouts;
+    QStringList sessionStrings;
+    QHash<QString, int> sessionStringIndex;
     TemplateInfoSenderBuilder(QObject *parent);
     void load(const QString &idInfo, const QStringList &folders);
     static QHash<QString, TemplateInfoSenderBuilder *> instanceMap;
@@ -45,6 +145,8 @@ class TemplateInfoSenderBuilder : public QObject {
     QHash<QString, TemplateInfoSender *> templateInfoMap;
     TemplateInfoSender *newTemplate(const QString &id, const QString &tp, const QString &dataTempl);
     QHash<QString, QString> templateFilesList;
+    QFileSystemWatcher templateWatcher;
+    void watchTemplateFile(const QString &path);
     void onSetSettings(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
     void onGetSettings(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
     void onSetResistance(const QJsonValue &msgContent, TemplateInfoSender *tempSender);
@@ -70,6 +172,9 @@ class TemplateInfoSenderBuilder : public QObject {
   private slots:
     void onUpdateTimeout();
     void onDataReceived(const QByteArray &data);
+    void onTemplateFileChanged(const QString &path);
+    void onTemplateDirChanged(const QString &dir);
+    void onSettingChanged(const QString &key, const QVariant &value);
   public slots:
     void onWorkoutNameChanged(QString name) { workoutName = name; }
     void onWorkoutStartDate(QString name) { workoutStartDate = name; }
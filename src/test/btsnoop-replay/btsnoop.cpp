@@ -0,0 +1,113 @@
+#include "btsnoop.h"
+
+#include <QFile>
+#include <QtEndian>
+
+static quint16 le16(const QByteArray &b, int i) { return qFromLittleEndian<quint16>(b.constData() + i); }
+
+// attribute UUIDs are little endian on the air, QBluetoothUuid wants them most significant byte first
+static QBluetoothUuid attUuid(const QByteArray &b, int i, int size) {
+    if (size == 2)
+        return QBluetoothUuid(le16(b, i));
+    quint128 u;
+    for (int k = 0; k < 16; k++)
+        u.data[k] = (quint8)b.at(i + 15 - k);
+    return QBluetoothUuid(u);
+}
+
+bool btsnoop::open(const QString &filename) {
+    QFile f(filename);
+    if (!f.open(QIODevice::ReadOnly)) {
+        m_error = f.errorString();
+        return false;
+    }
+    const QByteArray d = f.readAll();
+    if (d.size() < 16 || !d.startsWith(QByteArrayLiteral("btsnoop\0"))) {
+        m_error = QStringLiteral("not a btsnoop file");
+        return false;
+    }
+    const quint32 datalink = qFromBigEndian<quint32>(d.constData() + 12);
+    if (datalink != DATALINK_HCI_UNENCAPSULATED && datalink != DATALINK_HCI_UART) {
+        m_error = QStringLiteral("unsupported datalink type %1").arg(datalink);
+        return false;
+    }
+
+    qint64 first = -1;
+    int offset = 16;
+    while (offset + 24 <= d.size()) {
+        const quint32 included = qFromBigEndian<quint32>(d.constData() + offset + 4);
+        const quint32 flags = qFromBigEndian<quint32>(d.constData() + offset + 8);
+        const qint64 timestamp = qFromBigEndian<qint64>(d.constData() + offset + 16);
+        offset += 24;
+        if (offset + (int)included > d.size())
+            break; // truncated capture
+        QByteArray packet = d.mid(offset, included);
+        offset += included;
+        m_packets++;
+
+        if (first < 0)
+            first = timestamp;
+        const bool received = flags & 0x01;
+        if (datalink == DATALINK_HCI_UART) {
+            if (packet.isEmpty() || packet.at(0) != HCI_ACL)
+                continue;
+            packet.remove(0, 1);
+        } else if (flags & 0x02) {
+            continue; // command or event
+        }
+        acl(packet, received, timestamp - first);
+    }
+
+    for (notification &n : m_notifications)
+        n.uuid = m_forced.value(n.handle, m_handles.value(n.handle));
+    return true;
+}
+
+void btsnoop::map(quint16 handle, const QBluetoothUuid &uuid) {
+    m_forced.insert(handle, uuid);
+    for (notification &n : m_notifications)
+        if (n.handle == handle)
+            n.uuid = uuid;
+}
+
+void btsnoop::acl(const QByteArray &packet, bool received, qint64 timestamp) {
+    if (packet.size() < 4)
+        return;
+    const quint16 header = le16(packet, 0);
+    const quint16 connection = header & 0x0FFF;
+    const int boundary = (header >> 12) & 0x03;
+    QByteArray &buffer = m_fragments[connection];
+    if (boundary == 0x01)
+        buffer.append(packet.mid(4)); // continuing fragment
+    else
+        buffer = packet.mid(4);
+
+    while (buffer.size() >= 4) {
+        const int length = le16(buffer, 0);
+        if (buffer.size() < 4 + length)
+            return; // wait for the next fragment
+        if (le16(buffer, 2) == L2CAP_CID_ATT)
+            att(buffer.mid(4, length), received, timestamp);
+        buffer.remove(0, 4 + length);
+    }
+}
+
+void btsnoop::att(const QByteArray &pdu, bool received, qint64 timestamp) {
+    if (pdu.isEmpty() || !received)
+        return;
+    const quint8 opcode = pdu.at(0);
+    if ((opcode == ATT_HANDLE_VALUE_NTF || opcode == ATT_HANDLE_VALUE_IND) && pdu.size() >= 3) {
+        notification n;
+        n.timestamp = timestamp;
+        n.handle = le16(pdu, 1);
+        n.value = pdu.mid(3);
+        m_notifications.append(n);
+    } else if (opcode == ATT_READ_BY_TYPE_RSP && pdu.size() >= 2) {
+        // characteristic declarations: declaration handle, properties, value handle, 16 or 128 bit UUID
+        const int length = (quint8)pdu.at(1);
+        if (length != 7 && length != 21)
+            return;
+        for (int i = 2; i + length <= pdu.size(); i += length)
+            m_handles.insert(le16(pdu, i + 3), attUuid(pdu, i + 5, length - 5));
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef BTSNOOP_H
+#define BTSNOOP_H
+
+#include <QBluetoothUuid>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The btsnoop class reads a btsnoop HCI capture (the Android "Bluetooth HCI snoop log", like the ones in
+ * btlogs/) and extracts the ATT handle value notifications and indications received from the device.
+ * Handles are mapped to characteristic UUIDs by following the GATT discovery recorded in the same capture
+ * (Read By Type responses for the characteristic declarations); handles not discovered there can be mapped by hand.
+ */
+class btsnoop {
+  public:
+    struct notification {
+        qint64 timestamp = 0; // microseconds since the first packet of the capture
+        quint16 handle = 0;
+        QBluetoothUuid uuid;
+        QByteArray value;
+    };
+
+    bool open(const QString &filename);
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief map Forces the UUID of an attribute handle, overriding what was discovered in the capture.
+     */
+    void map(quint16 handle, const QBluetoothUuid &uuid);
+
+    const QVector<notification> &notifications() const { return m_notifications; }
+    const QHash<quint16, QBluetoothUuid> &handles() const { return m_handles; }
+    int packets() const { return m_packets; }
+
+  private:
+    enum {
+        DATALINK_HCI_UNENCAPSULATED = 1001,
+        DATALINK_HCI_UART = 1002,
+        HCI_ACL = 0x02,
+        L2CAP_CID_ATT = 0x0004,
+        ATT_READ_BY_TYPE_RSP = 0x09,
+        ATT_HANDLE_VALUE_NTF = 0x1B,
+        ATT_HANDLE_VALUE_IND = 0x1D,
+    };
+
+    void acl(const QByteArray &packet, bool received, qint64 timestamp);
+    void att(const QByteArray &pdu, bool received, qint64 timestamp);
+
+    QString m_error;
+    QVector<notification> m_notifications;
+    QHash<quint16, QBluetoothUuid> m_handles;
+    QHash<quint16, QBluetoothUuid> m_forced;
+    QHash<quint16, QByteArray> m_fragments; // L2CAP reassembly, per connection handle
+    int m_packets = 0;
+};
+
+#endif // BTSNOOP_H
@@ -0,0 +1,124 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMetaMethod>
+
+#include <cstdio>
+#include <functional>
+
+#include "btsnoop.h"
+#include "domyostreadmill.h"
+#include "ftmsbike.h"
+#include "horizontreadmill.h"
+
+// Feeds the notifications recorded in a btsnoop capture to a device driver, as fast as possible, and prints the
+// metrics the driver decoded plus the parser throughput. Example:
+//   btsnoop-replay --device domyostreadmill --trace ../../../btlogs/btsnoop_hci.log
+
+struct driver {
+    const char *name;
+    std::function<bluetoothdevice *()> create;
+};
+
+static const driver drivers[] = {
+    {"ftmsbike", []() -> bluetoothdevice * { return new ftmsbike(false, false, 1, 1.0); }},
+    {"horizontreadmill", []() -> bluetoothdevice * { return new horizontreadmill(false, false); }},
+    {"domyostreadmill", []() -> bluetoothdevice * { return new domyostreadmill(); }},
+};
+
+static void trace(const btsnoop::notification &n, bluetoothdevice *device) {
+    printf("%.3f,%s,%s,%.2f,%.1f,%.0f,%.0f,%.0f,%.0f,%.3f,%.1f\n", n.timestamp / 1000000.0,
+           qPrintable(n.uuid.toString()), n.value.toHex(' ').constData(), device->currentSpeed().value(),
+           device->currentInclination().value(), device->currentCadence().value(), device->currentResistance().value(),
+           device->wattsMetric().value(), device->currentHeart().value(), device->odometer(),
+           device->calories().value());
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    // same settings store as the app, so the drivers decode with the user's configuration
+    app.setOrganizationName(QStringLiteral("Roberto Viola"));
+    app.setOrganizationDomain(QStringLiteral("robertoviola.cloud"));
+    app.setApplicationName(QStringLiteral("qDomyos-Zwift"));
+
+    QStringList names;
+    for (const driver &d : drivers)
+        names << QString::fromLatin1(d.name);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a btsnoop HCI capture through a device parser"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("device"), names.join(QStringLiteral(", ")), QStringLiteral("name")});
+    parser.addOption({QStringLiteral("map"), QStringLiteral("Maps an attribute handle to a UUID, e.g. 0x0052=2acd"),
+                      QStringLiteral("handle=uuid")});
+    parser.addOption({QStringLiteral("repeat"), QStringLiteral("Replays the capture n times (default 1)"),
+                      QStringLiteral("n"), QStringLiteral("1")});
+    parser.addOption({QStringLiteral("trace"), QStringLiteral("Prints the metrics after every notification")});
+    parser.addPositionalArgument(QStringLiteral("capture"), QStringLiteral("btsnoop_hci.log file"));
+    parser.process(app);
+
+    const driver *selected = nullptr;
+    for (const driver &d : drivers)
+        if (parser.value(QStringLiteral("device")) == QLatin1String(d.name))
+            selected = &d;
+    if (!selected || parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    btsnoop capture;
+    if (!capture.open(parser.positionalArguments().constFirst())) {
+        fprintf(stderr, "%s\n", qPrintable(capture.errorString()));
+        return 1;
+    }
+    for (const QString &m : parser.values(QStringLiteral("map"))) {
+        bool ok = false;
+        const quint16 handle = m.section(QLatin1Char('='), 0, 0).toUShort(&ok, 0);
+        QString uuid = m.section(QLatin1Char('='), 1);
+        if (!ok || uuid.isEmpty()) {
+            fprintf(stderr, "invalid --map %s\n", qPrintable(m));
+            return 1;
+        }
+        capture.map(handle, uuid.length() <= 4 ? QBluetoothUuid((quint16)uuid.toUShort(nullptr, 16))
+                                               : QBluetoothUuid(uuid));
+    }
+
+    bluetoothdevice *device = selected->create();
+    const QMetaObject *mo = device->metaObject();
+    const int index = mo->indexOfMethod("parseNotification(QBluetoothUuid,QByteArray)");
+    if (index < 0) {
+        fprintf(stderr, "%s has no parseNotification slot\n", selected->name);
+        return 1;
+    }
+    const QMetaMethod parse = mo->method(index);
+
+    const QVector<btsnoop::notification> &notifications = capture.notifications();
+    fprintf(stderr, "%d packets, %d notifications\n", capture.packets(), notifications.size());
+    for (auto i = capture.handles().constBegin(); i != capture.handles().constEnd(); ++i)
+        fprintf(stderr, "handle 0x%04x %s\n", i.key(), qPrintable(i.value().toString()));
+
+    const bool tracing = parser.isSet(QStringLiteral("trace"));
+    if (tracing)
+        printf("time,uuid,value,speed,inclination,cadence,resistance,watt,heart,distance,kcal\n");
+
+    const int repeat = qMax(1, parser.value(QStringLiteral("repeat")).toInt());
+    QElapsedTimer t;
+    t.start();
+    for (int r = 0; r < repeat; r++) {
+        for (const btsnoop::notification &n : notifications) {
+            parse.invoke(device, Qt::DirectConnection, Q_ARG(QBluetoothUuid, n.uuid), Q_ARG(QByteArray, n.value));
+            if (tracing)
+                trace(n, device);
+        }
+    }
+    const qint64 ns = t.nsecsElapsed();
+    const qint64 total = (qint64)notifications.size() * repeat;
+
+    fprintf(stderr, "%s: %lld notifications in %.3f ms, %.0f notifications/s, %.2f us/notification\n",
+            selected->name, total, ns / 1000000.0, ns ? total * 1e9 / ns : 0.0, total ? ns / 1000.0 / total : 0.0);
+    fprintf(stderr, "final: speed %.2f inclination %.1f cadence %.0f watt %.0f heart %.0f distance %.3f kcal %.1f\n",
+            device->currentSpeed().value(), device->currentInclination().value(), device->currentCadence().value(),
+            device->wattsMetric().value(), device->currentHeart().value(), device->odometer(),
+            device->calories().value());
+
+    delete device;
+    return 0;
+}
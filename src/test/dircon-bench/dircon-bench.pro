@@ -0,0 +1,87 @@
+QT -= gui
+QT += bluetooth network positioning
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../.. ../../qmdnsengine/src/include
+
+# the dircon stack and what the characteristic notifiers pull in; mDNS is linked but turned off (dircon_mdns)
+SOURCES += \
+        main.cpp \
+        ../../bike.cpp \
+        ../../blewritequeue.cpp \
+        ../../bluetoothdevice.cpp \
+        ../../characteristicnotifier2a37.cpp \
+        ../../characteristicnotifier2a53.cpp \
+        ../../characteristicnotifier2a5b.cpp \
+        ../../characteristicnotifier2a63.cpp \
+        ../../characteristicnotifier2acc.cpp \
+        ../../characteristicnotifier2acd.cpp \
+        ../../characteristicnotifier2ad2.cpp \
+        ../../characteristicnotifier2ad9.cpp \
+        ../../characteristicsnapshot.cpp \
+        ../../characteristicwriteprocessor2ad9.cpp \
+        ../../dirconmanager.cpp \
+        ../../dirconpacket.cpp \
+        ../../dirconprocessor.cpp \
+        ../../elliptical.cpp \
+        ../../latencytrace.cpp \
+        ../../metric.cpp \
+        ../../notificationscheduler.cpp \
+        ../../powercurve.cpp \
+        ../../qzdebug.cpp \
+        ../../qzsettings.cpp \
+        ../../qzsettingscache.cpp \
+        ../../sessionline.cpp \
+        ../../treadmill.cpp \
+        ../../qmdnsengine/src/src/abstractserver.cpp \
+        ../../qmdnsengine/src/src/bitmap.cpp \
+        ../../qmdnsengine/src/src/browser.cpp \
+        ../../qmdnsengine/src/src/cache.cpp \
+        ../../qmdnsengine/src/src/dns.cpp \
+        ../../qmdnsengine/src/src/hostname.cpp \
+        ../../qmdnsengine/src/src/mdns.cpp \
+        ../../qmdnsengine/src/src/message.cpp \
+        ../../qmdnsengine/src/src/prober.cpp \
+        ../../qmdnsengine/src/src/provider.cpp \
+        ../../qmdnsengine/src/src/query.cpp \
+        ../../qmdnsengine/src/src/record.cpp \
+        ../../qmdnsengine/src/src/resolver.cpp \
+        ../../qmdnsengine/src/src/server.cpp \
+        ../../qmdnsengine/src/src/service.cpp
+
+HEADERS += \
+        ../../bike.h \
+        ../../blewritequeue.h \
+        ../../bluetoothdevice.h \
+        ../../characteristicnotifier2a37.h \
+        ../../characteristicnotifier2a53.h \
+        ../../characteristicnotifier2a5b.h \
+        ../../characteristicnotifier2a63.h \
+        ../../characteristicnotifier2acc.h \
+        ../../characteristicnotifier2acd.h \
+        ../../characteristicnotifier2ad2.h \
+        ../../characteristicnotifier2ad9.h \
+        ../../characteristicsnapshot.h \
+        ../../characteristicwriteprocessor2ad9.h \
+        ../../dirconmanager.h \
+        ../../dirconpacket.h \
+        ../../dirconprocessor.h \
+        ../../elliptical.h \
+        ../../latencytrace.h \
+        ../../metric.h \
+        ../../notificationscheduler.h \
+        ../../powercurve.h \
+        ../../qzdebug.h \
+        ../../qzsettings.h \
+        ../../qzsettingscache.h \
+        ../../sessionline.h \
+        ../../treadmill.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,293 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSettings>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QtMath>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+#include "bike.h"
+#include "dirconmanager.h"
+#include "dirconpacket.h"
+
+// Load test of the dircon stack: a DirconManager over a simulated bike, listening on loopback without mDNS, and n
+// clients that discover the services, enable every notification and then write the FTMS control point. Example:
+//   dircon-bench --clients 8 --seconds 20 --writes 10 --rate 20
+// Reports the request/response latency percentiles, the jitter of the Indoor Bike Data notifications and the CPU
+// time of the server thread per client. The clients run in their own thread so they are not counted.
+
+static QElapsedTimer monotonic;
+
+static double threadCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double processCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// a bike pedalling a slow sine: every sample of the notification scheduler sees new values
+class simulatedbike : public bike {
+  public:
+    simulatedbike() {
+        timer.setTimerType(Qt::PreciseTimer);
+        QObject::connect(&timer, &QTimer::timeout, [this]() {
+            const double t = monotonic.elapsed() / 1000.0;
+            Speed.setValue(30 + 5 * qSin(t / 7));
+            Cadence.setValue(90 + 10 * qSin(t / 5));
+            m_watt.setValue(200 + 50 * qSin(t / 3));
+            Heart.setValue(130 + 10 * qSin(t / 11));
+            Distance.setValue(Distance.value() + Speed.value() / 3600.0 / 50);
+        });
+        timer.start(20);
+    }
+    bool connected() override { return true; }
+
+  private:
+    QTimer timer;
+};
+
+class benchclient : public QObject {
+  public:
+    benchclient(quint16 port, int writesPerSecond)
+        : socket(new QTcpSocket(this)), writeTimer(new QTimer(this)), port(port) {
+        out.reserve(64);
+        connect(socket, &QTcpSocket::connected, [this]() {
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            DirconPacket p;
+            p.Identifier = DPKT_MSGID_DISCOVER_SERVICES;
+            send(p);
+        });
+        connect(socket, &QTcpSocket::readyRead, [this]() { received(); });
+        connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), [this]() { errors++; });
+        writeTimer->setTimerType(Qt::PreciseTimer);
+        writeTimer->setInterval(1000 / qMax(1, writesPerSecond));
+        connect(writeTimer, &QTimer::timeout, [this]() { writeControlPoint(); });
+    }
+
+    void start() { socket->connectToHost(QHostAddress::LocalHost, port); }
+
+    QVector<qint64> setupLatency;   // ns, discovery and notification switches
+    QVector<qint64> writeLatency;   // ns, control point writes
+    QVector<qint64> notifyInterval; // ns, between two 0x2AD2 notifications
+    int errors = 0;
+    int skippedWrites = 0; // the previous write was still waiting for its response
+    bool running = false;
+
+  private:
+    void send(DirconPacket &p) {
+        p.isRequest = true;
+        p.encode(++seq, out);
+        sentAt = monotonic.nsecsElapsed();
+        pending = true;
+        socket->write(out.constData(), out.size());
+    }
+
+    void writeControlPoint() {
+        if (pending) {
+            skippedWrites++;
+            return;
+        }
+        DirconPacket p;
+        p.Identifier = DPKT_MSGID_WRITE_CHARACTERISTIC;
+        p.uuid = 0x2AD9;
+        if (!controlRequested) {
+            p.additional_data = QByteArray(1, 0x00); // request control
+            controlRequested = true;
+        } else {
+            const quint16 watt = 100 + (writes++ % 20) * 10; // set target power
+            p.additional_data = QByteArray(1, 0x05);
+            p.additional_data.append((char)(watt & 0xFF)).append((char)(watt >> 8));
+        }
+        send(p);
+    }
+
+    // the next step of the discovery: characteristics of each service, then one notification switch each
+    void next() {
+        DirconPacket p;
+        if (!services.isEmpty()) {
+            p.Identifier = DPKT_MSGID_DISCOVER_CHARACTERISTICS;
+            p.uuid = services.takeFirst();
+        } else if (!notifying.isEmpty()) {
+            p.Identifier = DPKT_MSGID_ENABLE_CHARACTERISTIC_NOTIFICATIONS;
+            p.uuid = notifying.takeFirst();
+            p.additional_data = QByteArray(1, 0x01);
+        } else {
+            running = true;
+            writeTimer->start();
+            return;
+        }
+        send(p);
+    }
+
+    void received() {
+        buffer.append(socket->readAll());
+        const qint64 now = monotonic.nsecsElapsed();
+        while (1) {
+            DirconPacket p;
+            const int n = p.parse(buffer, 0);
+            if (n == DPKT_PARSE_WAIT)
+                break;
+            if (n < 0) {
+                errors++;
+                buffer.remove(0, -n + DPKT_PARSE_ERROR);
+                continue;
+            }
+            buffer.remove(0, n);
+            if (p.Identifier == DPKT_MSGID_UNSOLICITED_CHARACTERISTIC_NOTIFICATION) {
+                if (p.uuid == 0x2AD2) {
+                    if (lastNotification)
+                        notifyInterval.append(now - lastNotification);
+                    lastNotification = now;
+                }
+                continue;
+            }
+            pending = false;
+            if (p.ResponseCode != DPKT_RESPCODE_SUCCESS_REQUEST)
+                errors++;
+            if (running) {
+                writeLatency.append(now - sentAt);
+                continue;
+            }
+            setupLatency.append(now - sentAt);
+            if (p.Identifier == DPKT_MSGID_DISCOVER_SERVICES)
+                services = p.uuids;
+            else if (p.Identifier == DPKT_MSGID_DISCOVER_CHARACTERISTICS)
+                for (int i = 0; i < p.uuids.size(); i++)
+                    if (p.additional_data.at(i) & DPKT_CHAR_PROP_FLAG_NOTIFY)
+                        notifying.append(p.uuids.at(i));
+            next();
+        }
+    }
+
+    QTcpSocket *socket;
+    QTimer *writeTimer;
+    quint16 port;
+    quint8 seq = 0;
+    QByteArray buffer;
+    QByteArray out;
+    QList<quint16> services;
+    QList<quint16> notifying;
+    qint64 sentAt = 0;
+    qint64 lastNotification = 0;
+    bool pending = false;
+    bool controlRequested = false;
+    int writes = 0;
+};
+
+static void printLatency(const char *name, QVector<qint64> v) {
+    if (v.isEmpty()) {
+        printf("%-10s %8d\n", name, 0);
+        return;
+    }
+    std::sort(v.begin(), v.end());
+    auto at = [&v](double p) { return v.at(qMin(v.size() - 1, (int)(p * v.size()))) / 1000.0; };
+    printf("%-10s %8d %9.1f %9.1f %9.1f %9.1f\n", name, v.size(), at(0.5), at(0.9), at(0.99), v.last() / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName(QStringLiteral("qDomyos-Zwift"));
+    app.setApplicationName(QStringLiteral("dircon-bench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Load test of the dircon server over loopback"));
+    parser.addHelpOption();
+    parser.addOption({QStringLiteral("clients"), QStringLiteral("Simulated clients (default 4)"), QStringLiteral("n"),
+                      QStringLiteral("4")});
+    parser.addOption({QStringLiteral("seconds"), QStringLiteral("Duration (default 10)"), QStringLiteral("s"),
+                      QStringLiteral("10")});
+    parser.addOption({QStringLiteral("writes"),
+                      QStringLiteral("Control point writes per second and client (default 4)"), QStringLiteral("n"),
+                      QStringLiteral("4")});
+    parser.addOption({QStringLiteral("rate"), QStringLiteral("Notification rate in Hz, 1 to 20 (default 20)"),
+                      QStringLiteral("hz"), QStringLiteral("20")});
+    parser.addOption({QStringLiteral("port"), QStringLiteral("Dircon base port (default 36866)"),
+                      QStringLiteral("port"), QString::number(QZSettings::default_dircon_server_base_port)});
+    parser.process(app);
+
+    const int clients = qMax(1, parser.value(QStringLiteral("clients")).toInt());
+    const int seconds = qMax(1, parser.value(QStringLiteral("seconds")).toInt());
+    const int writes = qMax(1, parser.value(QStringLiteral("writes")).toInt());
+    const int rate = qBound(1, parser.value(QStringLiteral("rate")).toInt(), 20);
+    const quint16 port = parser.value(QStringLiteral("port")).toUShort();
+
+    {
+        // private settings store: no mDNS, notifications only for the subscribed characteristics
+        QSettings settings;
+        settings.clear();
+        settings.setValue(QZSettings::dircon_mdns, false);
+        settings.setValue(QZSettings::dircon_server_base_port, port);
+        settings.setValue(QZSettings::wahoo_rgt_dircon, true);
+        settings.setValue(QZSettings::virtual_device_notification_rate, rate);
+    }
+    qzdebug::setEnabled(false);
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext &, const QString &) {});
+    monotonic.start();
+
+    simulatedbike device;
+    DirconManager manager(&device);
+
+    // the bike machine (Wahoo KICKR) listens on the base port
+    QThread clientThread;
+    QVector<benchclient *> benchclients;
+    for (int i = 0; i < clients; i++) {
+        benchclient *c = new benchclient(port, writes);
+        c->moveToThread(&clientThread);
+        benchclients.append(c);
+    }
+    clientThread.start();
+    for (benchclient *c : qAsConst(benchclients))
+        QMetaObject::invokeMethod(c, [c]() { c->start(); }, Qt::QueuedConnection);
+
+    const double cpu = threadCpuSeconds();
+    const double processCpu = processCpuSeconds();
+    QTimer::singleShot(seconds * 1000, &app, &QCoreApplication::quit);
+    app.exec();
+    const double serverCpu = threadCpuSeconds() - cpu;
+    const double totalCpu = processCpuSeconds() - processCpu;
+
+    clientThread.quit();
+    clientThread.wait();
+
+    QVector<qint64> setup, write, interval;
+    int errors = 0, skipped = 0, running = 0;
+    for (benchclient *c : qAsConst(benchclients)) {
+        setup += c->setupLatency;
+        write += c->writeLatency;
+        interval += c->notifyInterval;
+        errors += c->errors;
+        skipped += c->skippedWrites;
+        running += c->running;
+        delete c;
+    }
+
+    printf("%d clients (%d running), %d s, %d writes/s, notifications at %d Hz\n", clients, running, seconds, writes,
+           rate);
+    printf("%-10s %8s %9s %9s %9s %9s\n", "latency", "n", "p50 us", "p90 us", "p99 us", "max us");
+    printLatency("setup", setup);
+    printLatency("write", write);
+
+    // jitter: distance of every interval from the period the scheduler runs at
+    const qint64 period = 1000000000LL / rate;
+    QVector<qint64> jitter;
+    jitter.reserve(interval.size());
+    for (qint64 i : qAsConst(interval))
+        jitter.append(qAbs(i - period));
+    printLatency("jitter", jitter);
+
+    printf("server cpu %.3f s, %.3f ms/s per client; process cpu %.3f s\n", serverCpu,
+           serverCpu * 1000.0 / seconds / clients, totalCpu);
+    printf("errors %d, writes skipped while waiting for a response %d\n", errors, skipped);
+    return errors ? 1 : 0;
+}
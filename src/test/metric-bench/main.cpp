@@ -0,0 +1,95 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QList>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "metric.h"
+
+// counts every heap allocation done by the process, so the benchmark can report allocations per read
+static std::atomic<quint64> allocations{0};
+
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// the layout metric had before the ring buffer: returned by value it copies a QList and a QDateTime
+class legacy_metric {
+  public:
+    void setValue(double v) {
+        m_value = v;
+        m_lastChanged = QDateTime::currentDateTime();
+        m_last5.append(v);
+        if (m_last5.count() > 5)
+            m_last5.removeAt(0);
+    }
+    double value() { return m_value; }
+    double average5s() {
+        if (m_last5.count() == 0)
+            return 0;
+        double sum = 0;
+        for (double b : qAsConst(m_last5))
+            sum += b;
+        return sum / m_last5.count();
+    }
+
+  private:
+    double m_value = 0;
+    QList<double> m_last5;
+    QDateTime m_lastChanged = QDateTime::currentDateTime();
+};
+
+class legacy_device {
+  public:
+    legacy_metric wattsMetric() { return m_watt; }
+    legacy_metric m_watt;
+};
+
+class device {
+  public:
+    const metric &wattsMetric() { return m_watt; }
+    metric m_watt;
+};
+
+static const int ITERATIONS = 1000000;
+
+template <typename D> static void run(const char *name, D &d) {
+    double sink = 0;
+    QElapsedTimer t;
+    quint64 a = allocations;
+    t.start();
+    for (int i = 0; i < ITERATIONS; i++) {
+        sink += d.wattsMetric().value();
+        sink += d.wattsMetric().average5s();
+    }
+    qint64 ns = t.nsecsElapsed();
+    a = allocations - a;
+    printf("%-8s %8.2f ns/read %8.3f allocs/read (checksum %.0f)\n", name, (double)ns / (ITERATIONS * 2),
+           (double)a / (ITERATIONS * 2), sink);
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+    a.setOrganizationName(QStringLiteral("Roberto Viola"));
+    a.setApplicationName(QStringLiteral("qDomyos-Zwift"));
+
+    legacy_device before;
+    device after;
+    for (int i = 0; i < 10; i++) {
+        before.m_watt.setValue(100 + i);
+        after.m_watt.setValue(100 + i, false);
+    }
+
+    run("before", before);
+    run("after", after);
+    return 0;
+}
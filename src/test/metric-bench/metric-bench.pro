@@ -0,0 +1,27 @@
+QT -= gui
+QT += positioning
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+        main.cpp \
+        ../../metric.cpp \
+        ../../qzsettings.cpp \
+        ../../qzsettingscache.cpp \
+        ../../sessionline.cpp
+
+HEADERS += \
+        ../../metric.h \
+        ../../qzsettings.h \
+        ../../qzsettingscache.h \
+        ../../sessionline.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
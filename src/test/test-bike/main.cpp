@@ -1,8 +1,218 @@
+#include <QBluetoothUuid>
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMetaMethod>
+#include <QSettings>
 
-int main(int argc, char *argv[])
-{
-    QCoreApplication a(argc, argv);
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <new>
 
-    return a.exec();
+#include "domyostreadmill.h"
+#include "echelonconnectsport.h"
+#include "ftmsbike.h"
+#include "horizontreadmill.h"
+#include "m3ibike.h"
+#include "proformbike.h"
+#include "qzdebug.h"
+
+// Feeds every driver a corpus of canonical packets and reports the parser cost per packet and the metrics it
+// decoded, so a driver getting slower (or decoding something else) shows up in CI:
+//   test-bike [rounds]
+// The drivers run with the default settings (a private settings store) and with logging off, like the app.
+// It exits with 1 when a driver decodes a value other than the one in its corpus, or allocates more per packet
+// than its ceiling.
+
+static std::atomic<quint64> allocations{0};
+
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+struct packet {
+    quint16 uuid; // 0 for the drivers that only listen to one characteristic and ignore it
+    const char *hex;
+};
+
+typedef std::function<void(bluetoothdevice *, const QBluetoothUuid &, const QByteArray &)> feeder;
+
+// a metric the driver does not decode from its corpus
+static const double any = std::numeric_limits<double>::quiet_NaN();
+
+// the metrics after the last packet of the corpus
+struct decoded {
+    double speed;
+    double inclination;
+    double cadence;
+    double resistance;
+    double watt;
+    double heart;
+};
+
+struct driverbench {
+    const char *name;
+    std::function<bluetoothdevice *()> create;
+    feeder feed;
+    QVector<packet> corpus;
+    decoded expected;
+    // heap allocations per packet: the drivers that still open QSettings and build their debug strings on every
+    // packet get a loose ceiling
+    double maxAllocations;
+};
+
+template <class T> static void parse(bluetoothdevice *device, const QBluetoothUuid &uuid, const QByteArray &value) {
+    static_cast<T *>(device)->parseNotification(uuid, value);
+}
+
+// the M3i has no GATT service: it broadcasts its data in the manufacturer data of the advertisement
+static void advertisement(bluetoothdevice *device, const QBluetoothUuid &, const QByteArray &value) {
+    static const QMetaMethod process =
+        device->metaObject()->method(device->metaObject()->indexOfMethod("processAdvertising(QByteArray)"));
+    process.invoke(device, Qt::DirectConnection, Q_ARG(QByteArray, value));
+}
+
+static const QVector<driverbench> &benches() {
+    static const QVector<driverbench> b = {
+        {"ftmsbike",
+         []() -> bluetoothdevice * { return new ftmsbike(false, false, 1, 1.0); },
+         parse<ftmsbike>,
+         {
+             // indoor bike data: speed 25 km/h, cadence 90 rpm, resistance 20, power 200 W, heart 130 bpm
+             {0x2AD2, "64 02 c4 09 b4 00 14 00 c8 00 82"},
+             // speed 30 km/h, cadence 95 rpm, resistance 22, power 240 W, heart 135 bpm
+             {0x2AD2, "64 02 b8 0b be 00 16 00 f0 00 87"},
+         },
+         {30.0, any, 95, 22, 240, 135},
+         4},
+        {"horizontreadmill",
+         []() -> bluetoothdevice * { return new horizontreadmill(false, false); },
+         parse<horizontreadmill>,
+         {
+             // treadmill data: speed 10 km/h, distance 1500 m, inclination 2%
+             {0x2ACD, "0c 00 e8 03 dc 05 00 14 00 0b 00"},
+             // horizon custom frame, 29 bytes: speed 10.0 km/h
+             {0xFFF4, "55 aa 00 00 00 00 13 00 00 00 00 00 00 00 64 00 00 00 00 00 00 00 00 00 00 00 00 00 00"},
+         },
+         {10.0, 2.0, any, any, any, any},
+         256},
+        {"domyostreadmill",
+         []() -> bluetoothdevice * { return new domyostreadmill(); },
+         parse<domyostreadmill>,
+         {
+             // status frame split in 20 + 6 bytes (btlogs/btsnoop_hci.log): speed 6.1 km/h, inclination 1%
+             {0, "f0 bc 03 f2 00 64 00 3d 00 3c 00 01 00 00 0a 00 01 00 00 00"},
+             {0, "4a 01 00 00 01 d6"},
+             // the same status frame in one 26 bytes notification
+             {0, "f0 bc 03 f2 00 64 00 3d 00 3c 00 01 00 00 0a 00 01 00 00 00 4a 01 00 00 01 d6"},
+         },
+         {6.1, 1.0, any, any, any, any},
+         256},
+        {"echelonconnectsport",
+         []() -> bluetoothdevice * { return new echelonconnectsport(false, false, 1, 1.0); },
+         parse<echelonconnectsport>,
+         {
+             // resistance frame: resistance 20
+             {0, "f0 d2 01 14 c7"},
+             // metrics frame: cadence 90 rpm
+             {0, "f0 d1 09 00 00 01 2c 00 00 00 5a 00 00"},
+         },
+         // the speed is derived from the cadence
+         {0.37497622 * 90, any, 90, 20, any, any},
+         256},
+        {"proformbike",
+         []() -> bluetoothdevice * { return new proformbike(false, false, 1, 1.0); },
+         parse<proformbike>,
+         {
+             // resistance level 6, power 150 W
+             {0, "00 12 01 04 02 30 00 00 00 00 00 0e 96 00 00 00 00 00 5a 00"},
+         },
+         // the power is published by update(), not by the parser
+         {any, any, 90, 6, any, any},
+         256},
+        {"m3ibike",
+         []() -> bluetoothdevice * { return new m3ibike(false, false); },
+         advertisement,
+         {
+             // firmware 6.30, id 1: 90.0 rpm, 130 bpm, 150 W, 32 kcal, 5:30, 4.4 km, gear 10
+             {0, "02 01 06 30 00 01 84 03 82 00 96 00 20 00 05 1e 2c 00 0a"},
+         },
+         // the same elapsed time in every advertisement reads as a pause, which zeroes cadence and power
+         {any, any, any, 10, any, any},
+         256},
+    };
+    return b;
+}
+
+static bool check(const char *driver, const char *name, double value, double expected) {
+    if (std::isnan(expected) || qAbs(value - expected) < 0.01)
+        return true;
+    fprintf(stderr, "%s: %s is %.2f, expected %.2f\n", driver, name, value, expected);
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName(QStringLiteral("qDomyos-Zwift"));
+    app.setApplicationName(QStringLiteral("test-bike"));
+    {
+        QSettings settings;
+        settings.clear();
+        // the drivers would start advertising a virtual device on the first packet
+        settings.setValue(QZSettings::virtual_device_enabled, false);
+    }
+    qzdebug::setEnabled(false);
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext &, const QString &) {});
+
+    const int rounds = argc > 1 ? qMax(1, atoi(argv[1])) : 20000;
+    bool ok = true;
+    printf("%-20s %10s %10s %8s %8s %6s %6s %6s %6s\n", "driver", "ns/packet", "alloc/pkt", "speed", "incline",
+           "cad", "res", "watt", "heart");
+
+    for (const driverbench &b : benches()) {
+        QVector<QPair<QBluetoothUuid, QByteArray>> packets;
+        for (const packet &p : b.corpus)
+            packets.append({QBluetoothUuid(p.uuid), QByteArray::fromHex(p.hex)});
+
+        bluetoothdevice *device = b.create();
+        // warm up: first packet side effects (init flags, settings cache)
+        for (const auto &p : qAsConst(packets))
+            b.feed(device, p.first, p.second);
+
+        QElapsedTimer t;
+        const quint64 a = allocations;
+        t.start();
+        for (int r = 0; r < rounds; r++)
+            for (const auto &p : qAsConst(packets))
+                b.feed(device, p.first, p.second);
+        const qint64 ns = t.nsecsElapsed();
+        const double n = (double)rounds * packets.size();
+        const double perPacket = (allocations - a) / n;
+
+        printf("%-20s %10.1f %10.2f %8.2f %8.1f %6.0f %6.0f %6.0f %6.0f\n", b.name, ns / n, perPacket,
+               device->currentSpeed().value(), device->currentInclination().value(), device->currentCadence().value(),
+               device->currentResistance().value(), device->wattsMetric().value(), device->currentHeart().value());
+
+        ok &= check(b.name, "speed", device->currentSpeed().value(), b.expected.speed);
+        ok &= check(b.name, "inclination", device->currentInclination().value(), b.expected.inclination);
+        ok &= check(b.name, "cadence", device->currentCadence().value(), b.expected.cadence);
+        ok &= check(b.name, "resistance", device->currentResistance().value(), b.expected.resistance);
+        ok &= check(b.name, "watt", device->wattsMetric().value(), b.expected.watt);
+        ok &= check(b.name, "heart", device->currentHeart().value(), b.expected.heart);
+        if (perPacket > b.maxAllocations) {
+            fprintf(stderr, "%s: %.2f allocations per packet, the ceiling is %.0f\n", b.name, perPacket,
+                    b.maxAllocations);
+            ok = false;
+        }
+        delete device;
+    }
+    return ok ? 0 : 1;
 }
@@ -1,6 +1,7 @@
 QT -= gui
+QT += bluetooth network positioning
 
-CONFIG += c++11 console
+CONFIG += c++17 console
 CONFIG -= app_bundle
 
 # The following define makes your compiler emit warnings if you use
@@ -14,8 +15,102 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+INCLUDEPATH += ../.. ../../qmdnsengine/src/include
+
+# the drivers under test and what they pull in: the virtual devices and dircon are built but never started
 SOURCES += \
-        main.cpp
+        main.cpp \
+        ../../bike.cpp \
+        ../../blewritequeue.cpp \
+        ../../bluetoothdevice.cpp \
+        ../../characteristicnotifier2a37.cpp \
+        ../../characteristicnotifier2a53.cpp \
+        ../../characteristicnotifier2a5b.cpp \
+        ../../characteristicnotifier2a63.cpp \
+        ../../characteristicnotifier2acc.cpp \
+        ../../characteristicnotifier2acd.cpp \
+        ../../characteristicnotifier2ad2.cpp \
+        ../../characteristicnotifier2ad9.cpp \
+        ../../characteristicsnapshot.cpp \
+        ../../characteristicwriteprocessor2ad9.cpp \
+        ../../commandslot.cpp \
+        ../../dirconmanager.cpp \
+        ../../dirconpacket.cpp \
+        ../../dirconprocessor.cpp \
+        ../../domyostreadmill.cpp \
+        ../../echelonconnectsport.cpp \
+        ../../elliptical.cpp \
+        ../../ftmsbike.cpp \
+        ../../ftmsdata.cpp \
+        ../../gattcache.cpp \
+        ../../horizontreadmill.cpp \
+        ../../latencytrace.cpp \
+        ../../m3ibike.cpp \
+        ../../metric.cpp \
+        ../../notificationscheduler.cpp \
+        ../../powercurve.cpp \
+        ../../proformbike.cpp \
+        ../../qzdebug.cpp \
+        ../../qzsettings.cpp \
+        ../../qzsettingscache.cpp \
+        ../../sessionline.cpp \
+        ../../treadmill.cpp \
+        ../../virtualbike.cpp \
+        ../../virtualtreadmill.cpp \
+        ../../qmdnsengine/src/src/abstractserver.cpp \
+        ../../qmdnsengine/src/src/bitmap.cpp \
+        ../../qmdnsengine/src/src/browser.cpp \
+        ../../qmdnsengine/src/src/cache.cpp \
+        ../../qmdnsengine/src/src/dns.cpp \
+        ../../qmdnsengine/src/src/hostname.cpp \
+        ../../qmdnsengine/src/src/mdns.cpp \
+        ../../qmdnsengine/src/src/message.cpp \
+        ../../qmdnsengine/src/src/prober.cpp \
+        ../../qmdnsengine/src/src/provider.cpp \
+        ../../qmdnsengine/src/src/query.cpp \
+        ../../qmdnsengine/src/src/record.cpp \
+        ../../qmdnsengine/src/src/resolver.cpp \
+        ../../qmdnsengine/src/src/server.cpp \
+        ../../qmdnsengine/src/src/service.cpp
+
+HEADERS += \
+        ../../bike.h \
+        ../../blewritequeue.h \
+        ../../bluetoothdevice.h \
+        ../../characteristicnotifier2a37.h \
+        ../../characteristicnotifier2a53.h \
+        ../../characteristicnotifier2a5b.h \
+        ../../characteristicnotifier2a63.h \
+        ../../characteristicnotifier2acc.h \
+        ../../characteristicnotifier2acd.h \
+        ../../characteristicnotifier2ad2.h \
+        ../../characteristicnotifier2ad9.h \
+        ../../characteristicsnapshot.h \
+        ../../characteristicwriteprocessor2ad9.h \
+        ../../commandslot.h \
+        ../../dirconmanager.h \
+        ../../dirconpacket.h \
+        ../../dirconprocessor.h \
+        ../../domyostreadmill.h \
+        ../../echelonconnectsport.h \
+        ../../elliptical.h \
+        ../../ftmsbike.h \
+        ../../ftmsdata.h \
+        ../../gattcache.h \
+        ../../horizontreadmill.h \
+        ../../latencytrace.h \
+        ../../m3ibike.h \
+        ../../metric.h \
+        ../../notificationscheduler.h \
+        ../../powercurve.h \
+        ../../proformbike.h \
+        ../../qzdebug.h \
+        ../../qzsettings.h \
+        ../../qzsettingscache.h \
+        ../../sessionline.h \
+        ../../treadmill.h \
+        ../../virtualbike.h \
+        ../../virtualtreadmill.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -0,0 +1,115 @@
+#include <QByteArray>
+#include <QtMath>
+
+#include <cstdio>
+
+#include "ftmsdata.h"
+
+// Packets built field by field from the FTMS specification, decoded by ftmsdata. Returns the number of failures.
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                                                    \
+    do {                                                                                                               \
+        if (!(cond)) {                                                                                                 \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);                                                     \
+            failures++;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+#define CHECK_VALUE(data, f, member, expected) CHECK((data).has(ftmsdata::f) && qFuzzyCompare((data).member, (double)(expected)))
+
+static bool decode(ftmsdata &d, ftmsdata::characteristic type, const char *hex) {
+    return d.decode(type, QByteArray::fromHex(hex));
+}
+
+static void indoorBikeData() {
+    ftmsdata d;
+    // speed, cadence, resistance, power, heart rate
+    CHECK(decode(d, ftmsdata::INDOOR_BIKE_DATA, "6402c409b4001400c80082"));
+    CHECK_VALUE(d, FIELD_SPEED, speed, 25.0);
+    CHECK_VALUE(d, FIELD_CADENCE, cadence, 90.0);
+    CHECK_VALUE(d, FIELD_RESISTANCE, resistance, 20);
+    CHECK_VALUE(d, FIELD_POWER, power, 200);
+    CHECK_VALUE(d, FIELD_HEART, heart, 130); // above 127: unsigned
+    CHECK(!d.has(ftmsdata::FIELD_DISTANCE));
+
+    // more data set: no speed, power only
+    CHECK(decode(d, ftmsdata::INDOOR_BIKE_DATA, "41002c01"));
+    CHECK(!d.has(ftmsdata::FIELD_SPEED));
+    CHECK_VALUE(d, FIELD_POWER, power, 300);
+
+    // distance and the three expended energy fields
+    CHECK(decode(d, ftmsdata::INDOOR_BIKE_DATA, "11011027002c0158020a"));
+    CHECK_VALUE(d, FIELD_DISTANCE, distance, 10000);
+    CHECK_VALUE(d, FIELD_ENERGY, energy, 300);
+    CHECK_VALUE(d, FIELD_ENERGY_PER_HOUR, energyPerHour, 600);
+    CHECK_VALUE(d, FIELD_ENERGY_PER_MINUTE, energyPerMinute, 10);
+
+    // negative power
+    CHECK(decode(d, ftmsdata::INDOOR_BIKE_DATA, "4100f6ff"));
+    CHECK_VALUE(d, FIELD_POWER, power, -10);
+
+    // truncated after the speed: what was there is decoded
+    CHECK(!decode(d, ftmsdata::INDOOR_BIKE_DATA, "4000c409"));
+    CHECK_VALUE(d, FIELD_SPEED, speed, 25.0);
+    CHECK(!d.has(ftmsdata::FIELD_POWER));
+
+    CHECK(!decode(d, ftmsdata::INDOOR_BIKE_DATA, "40"));
+    CHECK(d.present == 0);
+}
+
+static void treadmillData() {
+    ftmsdata d;
+    // speed, distance, negative inclination and ramp angle
+    CHECK(decode(d, ftmsdata::TREADMILL_DATA, "0c00e803dc0500ecff0b00"));
+    CHECK_VALUE(d, FIELD_SPEED, speed, 10.0);
+    CHECK_VALUE(d, FIELD_DISTANCE, distance, 1500);
+    CHECK_VALUE(d, FIELD_INCLINATION, inclination, -2.0);
+    CHECK_VALUE(d, FIELD_RAMP_ANGLE, rampAngle, 1.1);
+
+    // speed, elevation gain, heart rate, elapsed time
+    CHECK(decode(d, ftmsdata::TREADMILL_DATA, "1005200364000000963c00"));
+    CHECK_VALUE(d, FIELD_SPEED, speed, 8.0);
+    CHECK_VALUE(d, FIELD_ELEVATION_GAIN, positiveElevationGain, 10.0);
+    CHECK_VALUE(d, FIELD_HEART, heart, 150);
+    CHECK_VALUE(d, FIELD_ELAPSED_TIME, elapsedTime, 60);
+    CHECK(!d.has(ftmsdata::FIELD_INCLINATION));
+
+    // force on belt and power output
+    CHECK(decode(d, ftmsdata::TREADMILL_DATA, "011032006400"));
+    CHECK_VALUE(d, FIELD_FORCE_ON_BELT, forceOnBelt, 50);
+    CHECK_VALUE(d, FIELD_POWER_OUTPUT, powerOutput, 100);
+}
+
+static void rowerData() {
+    ftmsdata d;
+    // stroke rate and count, distance, pace, power
+    CHECK(decode(d, ftmsdata::ROWER_DATA, "2c003c6400e803007800c800"));
+    CHECK_VALUE(d, FIELD_CADENCE, cadence, 30);
+    CHECK_VALUE(d, FIELD_STROKE_COUNT, strokeCount, 100);
+    CHECK_VALUE(d, FIELD_DISTANCE, distance, 1000);
+    CHECK_VALUE(d, FIELD_PACE, pace, 120);
+    CHECK_VALUE(d, FIELD_POWER, power, 200);
+}
+
+static void crossTrainerData() {
+    ftmsdata d;
+    // 24 bit flags: speed, step rates, inclination, power, backward
+    CHECK(decode(d, ftmsdata::CROSS_TRAINER_DATA, "488100b00478006e00320000009600"));
+    CHECK_VALUE(d, FIELD_SPEED, speed, 12.0);
+    CHECK_VALUE(d, FIELD_CADENCE, cadence, 120);
+    CHECK_VALUE(d, FIELD_AVERAGE_CADENCE, averageCadence, 110);
+    CHECK_VALUE(d, FIELD_INCLINATION, inclination, 5.0);
+    CHECK_VALUE(d, FIELD_POWER, power, 150);
+    CHECK(d.backward);
+}
+
+int main() {
+    indoorBikeData();
+    treadmillData();
+    rowerData();
+    crossTrainerData();
+    printf("%s: %d failures\n", failures ? "FAILED" : "PASSED", failures);
+    return failures;
+}
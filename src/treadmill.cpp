@@ -5,14 +5,14 @@
 treadmill::treadmill() {}
 
 void treadmill::changeSpeed(double speed) {
-    qDebug() << "changeSpeed" << speed << autoResistanceEnable;
+    qzCDebug(qzDevice) << "changeSpeed" << speed << autoResistanceEnable;
     RequestedSpeed = speed;
     if (autoResistanceEnable)
         requestSpeed = speed;
 }
 void treadmill::changeInclination(double grade, double inclination) {
     Q_UNUSED(inclination);
-    qDebug() << "changeInclination" << grade << autoResistanceEnable;
+    qzCDebug(qzDevice) << "changeInclination" << grade << autoResistanceEnable;
     RequestedInclination = grade;
     if (autoResistanceEnable) {
         requestInclination = grade;
@@ -22,7 +22,7 @@ void treadmill::changeSpeedAndInclination(double speed, double inclination) {
     changeSpeed(speed);
     changeInclination(inclination, inclination);
 }
-metric treadmill::currentInclination() { return Inclination; }
+const metric &treadmill::currentInclination() { return Inclination; }
 bool treadmill::connected() { return false; }
 bluetoothdevice::BLUETOOTH_TYPE treadmill::deviceType() { return bluetoothdevice::TREADMILL; }
 
@@ -9,18 +9,18 @@ class treadmill : public bluetoothdevice {
   public:
     treadmill();
     void update_metrics(bool watt_calc, const double watts);
-    metric lastRequestedSpeed() { return RequestedSpeed; }
-    metric lastRequestedInclination() { return RequestedInclination; }
+    const metric &lastRequestedSpeed() { return RequestedSpeed; }
+    const metric &lastRequestedInclination() { return RequestedInclination; }
     virtual bool connected();
-    virtual metric currentInclination();
+    virtual const metric &currentInclination();
     virtual double requestedSpeed();
     virtual double currentTargetSpeed();
     virtual double requestedInclination();
     virtual double minStepInclination();
     virtual double minStepSpeed();
-    metric currentStrideLength() { return InstantaneousStrideLengthCM; }
-    metric currentGroundContact() { return GroundContactMS; }
-    metric currentVerticalOscillation() { return VerticalOscillationMM; }
+    const metric &currentStrideLength() { return InstantaneousStrideLengthCM; }
+    const metric &currentGroundContact() { return GroundContactMS; }
+    const metric &currentVerticalOscillation() { return VerticalOscillationMM; }
     uint16_t watts(double weight);
     bluetoothdevice::BLUETOOTH_TYPE deviceType();
     void clearStats();
@@ -1,5 +1,7 @@
 #include "virtualbike.h"
 #include "ftmsbike.h"
+#include "latencytrace.h"
+#include "qzsettingscache.h"
 
 #include <QDataStream>
 #include <QMetaEnum>
@@ -438,7 +440,9 @@ virtualbike::virtualbike(bluetoothdevice *t, bool noWriteResistance, bool noHear
     }
 
     //! [Provide Heartbeat]
-    QObject::connect(&bikeTimer, &QTimer::timeout, this, &virtualbike::bikeProvider);
+    QObject::connect(&bikeScheduler, &NotificationScheduler::notify, this, &virtualbike::bikeProvider);
+    bikeScheduler.start(Bike);
+    QObject::connect(&bikeTimer, &QTimer::timeout, this, &virtualbike::bikeTick);
     bikeTimer.start(1s);
     //! [Provide Heartbeat]
     QObject::connect(leController, &QLowEnergyController::disconnected, this, &virtualbike::reconnect);
@@ -909,6 +913,7 @@ void virtualbike::writeCharacteristic(QLowEnergyService *service, const QLowEner
         qDebug() << QStringLiteral("virtualbike::writeCharacteristic ") + service->serviceName() + QStringLiteral(" ") +
                         characteristic.name() + QStringLiteral(" ") + value.toHex(' ');
         service->writeCharacteristic(characteristic, value); // Potentially causes notification.
+        latencytrace::mark(latencytrace::FRAME_SENT);
     } catch (...) {
         qDebug() << QStringLiteral("virtual bike error!");
     }
@@ -968,16 +973,60 @@ void virtualbike::reconnect() {
     leController->startAdvertising(pars, advertisingData, advertisingData);
 }
 
-void virtualbike::bikeProvider() {
-
+void virtualbike::bikeTick() {
+    // once a second whatever the notification rate: these write to the bike and to the advertising, the provider
+    // below only encodes and sends the frames
     QSettings settings;
+    bool erg_mode = settings.value(QZSettings::zwift_erg, QZSettings::default_zwift_erg).toBool();
+
+#ifdef Q_OS_IOS
+#ifndef IO_UNDER_QT
+    if (h) {
+        qDebug() << "last FTMS rcv" << lastFTMSFrameReceived;
+        if (lastFTMSFrameReceived > 0 && QDateTime::currentMSecsSinceEpoch() < (lastFTMSFrameReceived + 30000)) {
+            if (!erg_mode)
+                writeP2AD9->changeSlope(h->virtualbike_getCurrentSlope());
+            else {
+                qDebug() << "ios workaround power changed request" << h->virtualbike_getPowerRequested();
+                writeP2AD9->changePower(h->virtualbike_getPowerRequested());
+            }
+        }
+        return;
+    }
+#endif
+#endif
+
+    qDebug() << QStringLiteral("bikeProvider") << whenLastFTMSFrameReceived()
+             << (qint64)(whenLastFTMSFrameReceived() + ((qint64)2000)) << erg_mode;
+    // zwift with the last update, seems to sending power request only when it actually wants to change it
+    // so i need to keep this on to the bike
+    if (whenLastFTMSFrameReceived() > 0 &&
+        (QDateTime::currentMSecsSinceEpoch() > (qint64)(whenLastFTMSFrameReceived() + ((qint64)2000))) && erg_mode) {
+        qDebug() << QStringLiteral("zwift is not sending the power anymore, let's continue with the last value");
+        writeP2AD9->changePower(((bike *)Bike)->lastRequestedPower().value());
+    }
+
+    if (leController->state() != QLowEnergyController::ConnectedState) {
+        qDebug() << QStringLiteral("virtual bike bluetooth not connected");
+    } else {
+        bool bluetooth_relaxed = settings.value(QZSettings::bluetooth_relaxed, QZSettings::default_bluetooth_relaxed).toBool();
+        if (bluetooth_relaxed) {
+
+            leController->stopAdvertising();
+        }
+        qDebug() << QStringLiteral("virtual bike connected");
+    }
+}
+
+void virtualbike::bikeProvider(const CharacteristicSnapshot &snapshot) {
+
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     bool cadence = settings.value(QZSettings::bike_cadence_sensor, QZSettings::default_bike_cadence_sensor).toBool();
     bool battery = settings.value(QZSettings::battery_service, QZSettings::default_battery_service).toBool();
     bool power = settings.value(QZSettings::bike_power_sensor, QZSettings::default_bike_power_sensor).toBool();
     bool heart_only = settings.value(QZSettings::virtual_device_onlyheart, QZSettings::default_virtual_device_onlyheart).toBool();
     bool echelon = settings.value(QZSettings::virtual_device_echelon, QZSettings::default_virtual_device_echelon).toBool();
     bool ifit = settings.value(QZSettings::virtual_device_ifit, QZSettings::default_virtual_device_ifit).toBool();
-    bool erg_mode = settings.value(QZSettings::zwift_erg, QZSettings::default_zwift_erg).toBool();
 
     double normalizeWattage = Bike->wattsMetric().value();
     if (normalizeWattage < 0)
@@ -1002,45 +1051,16 @@ void virtualbike::bikeProvider() {
                 emit ftmsCharacteristicChanged(QLowEnergyCharacteristic(),
                                                QByteArray::fromRawData((char *)ftms_message, ret));
             }
-            qDebug() << "last FTMS rcv" << lastFTMSFrameReceived;
-            if (lastFTMSFrameReceived > 0 && QDateTime::currentMSecsSinceEpoch() < (lastFTMSFrameReceived + 30000)) {
-                if (!erg_mode)
-                    writeP2AD9->changeSlope(h->virtualbike_getCurrentSlope());
-                else {
-                    qDebug() << "ios workaround power changed request" << h->virtualbike_getPowerRequested();
-                    writeP2AD9->changePower(h->virtualbike_getPowerRequested());
-                }
-            }
         }
         return;
     }
 #endif
-#else
-    Q_UNUSED(erg_mode);
 #endif
 
-    qDebug() << QStringLiteral("bikeProvider") << whenLastFTMSFrameReceived()
-             << (qint64)(whenLastFTMSFrameReceived() + ((qint64)2000)) << erg_mode;
-    // zwift with the last update, seems to sending power request only when it actually wants to change it
-    // so i need to keep this on to the bike
-    if (whenLastFTMSFrameReceived() > 0 &&
-        (QDateTime::currentMSecsSinceEpoch() > (qint64)(whenLastFTMSFrameReceived() + ((qint64)2000))) && erg_mode) {
-        qDebug() << QStringLiteral("zwift is not sending the power anymore, let's continue with the last value");
-        writeP2AD9->changePower(((bike *)Bike)->lastRequestedPower().value());
-    }
-
     if (leController->state() != QLowEnergyController::ConnectedState) {
-        qDebug() << QStringLiteral("virtual bike bluetooth not connected");
-
         return;
     } else {
-        bool bluetooth_relaxed = settings.value(QZSettings::bluetooth_relaxed, QZSettings::default_bluetooth_relaxed).toBool();
         bool bluetooth_30m_hangs = settings.value(QZSettings::bluetooth_30m_hangs, QZSettings::default_bluetooth_30m_hangs).toBool();
-        if (bluetooth_relaxed) {
-
-            leController->stopAdvertising();
-        }
-
         if (lastFTMSFrameReceived > 0 && QDateTime::currentMSecsSinceEpoch() > (lastFTMSFrameReceived + 5000) &&
             bluetooth_30m_hangs) {
             lastFTMSFrameReceived = 0;
@@ -1049,17 +1069,17 @@ void virtualbike::bikeProvider() {
             reconnect();
             return;
         }
-
-        qDebug() << QStringLiteral("virtual bike connected");
     }
 
+    // the scheduler's snapshot: every characteristic below reports the same values
+    latencytrace::mark(latencytrace::SNAPSHOT_TAKEN);
     QByteArray value;
 
     if (!echelon && !ifit) {
         if (!heart_only) {
             if (!cadence && !power) {
                 value.clear();
-                if (notif2AD2->notify(value) == CN_OK) {
+                if (notif2AD2->notify(snapshot, value) == CN_OK) {
                     if (!serviceFIT) {
                         qDebug() << QStringLiteral("serviceFIT not available");
 
@@ -1078,7 +1098,7 @@ void virtualbike::bikeProvider() {
                 }
             } else if (power) {
                 value.clear();
-                if (notif2A63->notify(value) == CN_OK) {
+                if (notif2A63->notify(snapshot, value) == CN_OK) {
 
                     if (!service) {
                         qDebug() << QStringLiteral("service not available");
@@ -1098,7 +1118,7 @@ void virtualbike::bikeProvider() {
                 }
             } else {
                 value.clear();
-                if (notif2A5B->notify(value) == CN_OK) {
+                if (notif2A5B->notify(snapshot, value) == CN_OK) {
 
                     if (!service) {
                         qDebug() << QStringLiteral("service not available");
@@ -1172,7 +1192,7 @@ void virtualbike::bikeProvider() {
         }
 
         QByteArray valueHR;
-        if (notif2A37->notify(valueHR) == CN_OK) {
+        if (notif2A37->notify(snapshot, valueHR) == CN_OK) {
             QLowEnergyCharacteristic characteristicHR = serviceHR->characteristic(QBluetoothUuid::HeartRateMeasurement);
 
             Q_ASSERT(characteristicHR.isValid());
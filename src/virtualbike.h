@@ -27,6 +27,7 @@
 #endif
 #include "bike.h"
 #include "dirconmanager.h"
+#include "notificationscheduler.h"
 
 class virtualbike : public QObject {
 
@@ -57,6 +58,7 @@ class virtualbike : public QObject {
     QLowEnergyServiceData serviceData;
     QLowEnergyServiceData serviceDataChanged;
     QLowEnergyServiceData serviceEchelon;
+    NotificationScheduler bikeScheduler;
     QTimer bikeTimer;
     bluetoothdevice *Bike;
     CharacteristicWriteProcessor2AD9 *writeP2AD9 = 0;
@@ -98,7 +100,8 @@ class virtualbike : public QObject {
   private slots:
     void dirconFtmsCharacteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
     void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void bikeProvider();
+    void bikeProvider(const CharacteristicSnapshot &snapshot);
+    void bikeTick();
     void reconnect();
     void error(QLowEnergyController::Error newError);
 };
@@ -1,6 +1,7 @@
 #include "virtualrower.h"
 #include "ftmsrower.h"
 #include "qsettings.h"
+#include "qzsettingscache.h"
 
 #include <QDataStream>
 #include <QMetaEnum>
@@ -12,6 +13,8 @@ using namespace std::chrono_literals;
 
 virtualrower::virtualrower(bluetoothdevice *t, bool noWriteResistance, bool noHeartService) {
     Rower = t;
+    notif2AD1 = new CharacteristicNotifier2AD1(t, this);
+    notif2A37 = new CharacteristicNotifier2A37(t, this);
 
     this->noHeartService = noHeartService;
 
@@ -171,7 +174,9 @@ virtualrower::virtualrower(bluetoothdevice *t, bool noWriteResistance, bool noHe
     }
 
     //! [Provide Heartbeat]
-    QObject::connect(&rowerTimer, &QTimer::timeout, this, &virtualrower::rowerProvider);
+    QObject::connect(&rowerScheduler, &NotificationScheduler::notify, this, &virtualrower::rowerProvider);
+    rowerScheduler.start(Rower);
+    QObject::connect(&rowerTimer, &QTimer::timeout, this, &virtualrower::rowerTick);
     rowerTimer.start(1s);
     //! [Provide Heartbeat]
     QObject::connect(leController, &QLowEnergyController::disconnected, this, &virtualrower::reconnect);
@@ -297,9 +302,41 @@ void virtualrower::reconnect() {
     leController->startAdvertising(pars, advertisingData, advertisingData);
 }
 
-void virtualrower::rowerProvider() {
+void virtualrower::rowerTick() {
+    // once a second whatever the notification rate, the provider below only encodes and sends the frames
+#ifdef Q_OS_IOS
+#ifndef IO_UNDER_QT
+    if (h) {
+        qDebug() << "last FTMS rcv" << lastFTMSFrameReceived;
+        if (lastFTMSFrameReceived > 0 && QDateTime::currentMSecsSinceEpoch() < (lastFTMSFrameReceived + 30000)) {/*
+            if (!erg_mode)
+                writeP2AD9->changeSlope(h->virtualbike_getCurrentSlope());
+            else {
+                qDebug() << "ios workaround power changed request" << h->virtualbike_getPowerRequested();
+                writeP2AD9->changePower(h->virtualbike_getPowerRequested());
+            }*/
+        }
+        return;
+    }
+#endif
+#endif
 
-    QSettings settings;
+    if (leController->state() != QLowEnergyController::ConnectedState) {
+        qDebug() << QStringLiteral("virtual rower not connected");
+    } else {
+        QSettings settings;
+        bool bluetooth_relaxed = settings.value(QZSettings::bluetooth_relaxed, QZSettings::default_bluetooth_relaxed).toBool();
+        if (bluetooth_relaxed) {
+
+            leController->stopAdvertising();
+        }
+        qDebug() << QStringLiteral("virtual rower connected");
+    }
+}
+
+void virtualrower::rowerProvider(const CharacteristicSnapshot &snapshot) {
+
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
     bool heart_only = settings.value(QZSettings::virtual_device_onlyheart, QZSettings::default_virtual_device_onlyheart).toBool();
 
     double normalizeWattage = Rower->wattsMetric().value();
@@ -325,15 +362,6 @@ void virtualrower::rowerProvider() {
                 emit ftmsCharacteristicChanged(QLowEnergyCharacteristic(),
                                                QByteArray::fromRawData((char *)ftms_message, ret));
             }
-            qDebug() << "last FTMS rcv" << lastFTMSFrameReceived;
-            if (lastFTMSFrameReceived > 0 && QDateTime::currentMSecsSinceEpoch() < (lastFTMSFrameReceived + 30000)) {/*
-                if (!erg_mode)
-                    writeP2AD9->changeSlope(h->virtualbike_getCurrentSlope());
-                else {
-                    qDebug() << "ios workaround power changed request" << h->virtualbike_getPowerRequested();
-                    writeP2AD9->changePower(h->virtualbike_getPowerRequested());
-                }*/
-            }
         }
         return;
     }
@@ -341,17 +369,9 @@ void virtualrower::rowerProvider() {
 #endif
 
     if (leController->state() != QLowEnergyController::ConnectedState) {
-        qDebug() << QStringLiteral("virtual rower not connected");
-
         return;
     } else {
-        bool bluetooth_relaxed = settings.value(QZSettings::bluetooth_relaxed, QZSettings::default_bluetooth_relaxed).toBool();
         bool bluetooth_30m_hangs = settings.value(QZSettings::bluetooth_30m_hangs, QZSettings::default_bluetooth_30m_hangs).toBool();
-        if (bluetooth_relaxed) {
-
-            leController->stopAdvertising();
-        }
-
         if (lastFTMSFrameReceived > 0 && QDateTime::currentMSecsSinceEpoch() > (lastFTMSFrameReceived + 5000) &&
             bluetooth_30m_hangs) {
             lastFTMSFrameReceived = 0;
@@ -360,31 +380,12 @@ void virtualrower::rowerProvider() {
             reconnect();
             return;
         }
-
-        qDebug() << QStringLiteral("virtual rower connected");
     }
 
+    // the scheduler's snapshot: the FTMS and heart rate frames report the same values
     QByteArray value;
 
-    if (!heart_only) {
-
-        value.append((char)0xA0); // resistance level, power and speed
-        value.append((char)0x02); // heart rate
-
-        value.append((char)((uint8_t)Rower->currentCadence().value() & 0xFF)); // Stroke Rate
-
-        value.append((char)((uint16_t)(((rower *)Rower)->currentStrokesCount().value()) & 0xFF));        // Stroke Count
-        value.append((char)(((uint16_t)(((rower *)Rower)->currentStrokesCount().value()) >> 8) & 0xFF)); // Stroke Count
-
-        value.append((char)(((uint16_t)Rower->wattsMetric().value()) & 0xFF));      // watts
-        value.append((char)(((uint16_t)Rower->wattsMetric().value()) >> 8) & 0xFF); // watts
-
-        value.append((char)((uint16_t)(Rower->currentResistance().value()) & 0xFF));        // resistance
-        value.append((char)(((uint16_t)(Rower->currentResistance().value()) >> 8) & 0xFF)); // resistance
-
-        value.append(char(Rower->currentHeart().value())); // Actual value.
-        value.append((char)0);                             // Bkool FTMS protocol HRM offset 1280 fix
-
+    if (!heart_only && notif2AD1->notify(snapshot, value) == CN_OK) {
         if (!serviceFIT) {
             qDebug() << QStringLiteral("serviceFIT not available");
 
@@ -418,8 +419,7 @@ void virtualrower::rowerProvider() {
         }
 
         QByteArray valueHR;
-        valueHR.append(char(0));                                   // Flags that specify the format of the value.
-        valueHR.append(char(Rower->metrics_override_heartrate())); // Actual value.
+        notif2A37->notify(snapshot, valueHR);
         QLowEnergyCharacteristic characteristicHR = serviceHR->characteristic(QBluetoothUuid::HeartRateMeasurement);
 
         Q_ASSERT(characteristicHR.isValid());
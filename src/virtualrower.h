@@ -26,6 +26,9 @@
 #include "ios/lockscreen.h"
 #endif
 #include "bike.h"
+#include "characteristicnotifier2a37.h"
+#include "characteristicnotifier2ad1.h"
+#include "notificationscheduler.h"
 
 class virtualrower : public QObject {
 
@@ -42,8 +45,11 @@ class virtualrower : public QObject {
     QLowEnergyAdvertisingData advertisingData;
     QLowEnergyServiceData serviceDataHR;
     QLowEnergyServiceData serviceDataFIT;
+    NotificationScheduler rowerScheduler;
     QTimer rowerTimer;
     bluetoothdevice *Rower;
+    CharacteristicNotifier2AD1 *notif2AD1 = 0;
+    CharacteristicNotifier2A37 *notif2A37 = 0;
 
     uint16_t lastWheelTime = 0;
     uint32_t wheelRevs = 0;
@@ -63,7 +69,8 @@ class virtualrower : public QObject {
     
   private slots:
     void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void rowerProvider();
+    void rowerProvider(const CharacteristicSnapshot &snapshot);
+    void rowerTick();
     void reconnect();
     void error(QLowEnergyController::Error newError);
 };
@@ -1,6 +1,8 @@
 #include "virtualtreadmill.h"
 #include "elliptical.h"
 #include "ftmsbike.h"
+#include "latencytrace.h"
+#include "qzsettingscache.h"
 #include <QSettings>
 #include <QtMath>
 #include <chrono>
@@ -250,7 +252,9 @@ virtualtreadmill::virtualtreadmill(bluetoothdevice *t, bool noHeartService) {
         QObject::connect(leController, &QLowEnergyController::disconnected, this, &virtualtreadmill::reconnect);
     }
     //! [Provide Heartbeat]
-    QObject::connect(&treadmillTimer, &QTimer::timeout, this, &virtualtreadmill::treadmillProvider);
+    QObject::connect(&treadmillScheduler, &NotificationScheduler::notify, this, &virtualtreadmill::treadmillProvider);
+    treadmillScheduler.start(treadMill);
+    QObject::connect(&treadmillTimer, &QTimer::timeout, this, &virtualtreadmill::treadmillTick);
     treadmillTimer.start(1s);
 }
 
@@ -320,9 +324,32 @@ void virtualtreadmill::reconnect() {
     }
 }
 
-void virtualtreadmill::treadmillProvider() {
-    const uint64_t slopeTimeoutSecs = 30;
-    QSettings settings;
+void virtualtreadmill::treadmillTick() {
+    // once a second whatever the notification rate: these write to the treadmill and to the advertising, the
+    // provider below only encodes and sends the frames
+#ifdef Q_OS_IOS
+#ifndef IO_UNDER_QT
+    if (h) {
+        if ((uint64_t)QDateTime::currentSecsSinceEpoch() < lastSlopeChanged + slopeTimeoutSecs)
+            writeP2AD9->changeSlope(h->virtualtreadmill_getCurrentSlope());
+        return;
+    }
+#endif
+#endif
+
+    if (leController->state() != QLowEnergyController::ConnectedState) {
+        qDebug() << QStringLiteral("virtualtreadmill connection error");
+    } else {
+        QSettings settings;
+        bool bluetooth_relaxed = settings.value(QZSettings::bluetooth_relaxed, QZSettings::default_bluetooth_relaxed).toBool();
+        if (bluetooth_relaxed) {
+            leController->stopAdvertising();
+        }
+    }
+}
+
+void virtualtreadmill::treadmillProvider(const CharacteristicSnapshot &snapshot) {
+    const QZSettingsCache &settings = *QZSettingsCache::instance();
 
     if ((uint64_t)QDateTime::currentSecsSinceEpoch() > lastSlopeChanged + slopeTimeoutSecs)
         m_autoInclinationEnabled = false;
@@ -342,31 +369,23 @@ void virtualtreadmill::treadmillProvider() {
                 (uint16_t)((treadmill *)treadMill)->wattsMetric().value())) {
             h->virtualtreadmill_setHeartRate(((treadmill *)treadMill)->currentHeart().value());
             lastSlopeChanged = h->virtualtreadmill_lastChangeCurrentSlope();
-            if ((uint64_t)QDateTime::currentSecsSinceEpoch() < lastSlopeChanged + slopeTimeoutSecs)
-                writeP2AD9->changeSlope(h->virtualtreadmill_getCurrentSlope());
         }
         return;
     }
 #endif
 #endif
 
-    if (leController->state() != QLowEnergyController::ConnectedState) {
-        qDebug() << QStringLiteral("virtualtreadmill connection error");
+    if (leController->state() != QLowEnergyController::ConnectedState)
         return;
-    } else {
-        QSettings settings;
-        bool bluetooth_relaxed = settings.value(QZSettings::bluetooth_relaxed, QZSettings::default_bluetooth_relaxed).toBool();
-        if (bluetooth_relaxed) {
-            leController->stopAdvertising();
-        }
-    }
 
+    // the scheduler's snapshot: every characteristic below reports the same values
+    latencytrace::mark(latencytrace::SNAPSHOT_TAKEN);
     QByteArray value;
 
     if (ftmsServiceEnable()) {
         if (ftmsTreadmillEnable()) {
             value.clear();
-            if (notif2ACD->notify(value) == CN_OK) {
+            if (notif2ACD->notify(snapshot, value) == CN_OK) {
                 if (!serviceFTMS) {
                     qDebug() << QStringLiteral("service not available");
 
@@ -383,13 +402,14 @@ void virtualtreadmill::treadmillProvider() {
                 }
                 try {
                     serviceFTMS->writeCharacteristic(characteristic, value); // Potentially causes notification.
+                    latencytrace::mark(latencytrace::FRAME_SENT);
                 } catch (...) {
                     qDebug() << QStringLiteral("virtualtreadmill error!");
                 }
             }
         }
         value.clear();
-        if (notif2AD2->notify(value) == CN_OK) {
+        if (notif2AD2->notify(snapshot, value) == CN_OK) {
             if (!serviceFTMS) {
                 qDebug() << QStringLiteral("serviceFIT not available");
 
@@ -406,6 +426,7 @@ void virtualtreadmill::treadmillProvider() {
             }
             try {
                 serviceFTMS->writeCharacteristic(characteristic, value); // Potentially causes notification.
+                latencytrace::mark(latencytrace::FRAME_SENT);
             } catch (...) {
                 qDebug() << QStringLiteral("virtualtreadmill error!");
             }
@@ -413,7 +434,7 @@ void virtualtreadmill::treadmillProvider() {
     }
     if (RSCEnable()) {
         value.clear();
-        if (notif2A53->notify(value) == CN_OK) {
+        if (notif2A53->notify(snapshot, value) == CN_OK) {
             if (!serviceRSC) {
                 qDebug() << QStringLiteral("serviceFIT not available");
 
@@ -430,6 +451,7 @@ void virtualtreadmill::treadmillProvider() {
             }
             try {
                 serviceRSC->writeCharacteristic(characteristic, value); // Potentially causes notification.
+                latencytrace::mark(latencytrace::FRAME_SENT);
             } catch (...) {
                 qDebug() << QStringLiteral("virtualtreadmill error!");
             }
@@ -443,7 +465,7 @@ void virtualtreadmill::treadmillProvider() {
 
     if (noHeartService == false) {
         value.clear();
-        if (notif2A53->notify(value) == CN_OK) {
+        if (notif2A37->notify(snapshot, value) == CN_OK) {
             if (!serviceHR) {
                 qDebug() << QStringLiteral("serviceFIT not available");
 
@@ -460,6 +482,7 @@ void virtualtreadmill::treadmillProvider() {
             }
             try {
                 serviceHR->writeCharacteristic(characteristic, value); // Potentially causes notification.
+                latencytrace::mark(latencytrace::FRAME_SENT);
             } catch (...) {
                 qDebug() << QStringLiteral("virtualtreadmill error!");
             }
@@ -27,6 +27,7 @@
 #include <QtCore/qtimer.h>
 
 #include "dirconmanager.h"
+#include "notificationscheduler.h"
 #include "treadmill.h"
 
 class virtualtreadmill : public QObject {
@@ -45,9 +46,11 @@ class virtualtreadmill : public QObject {
     QLowEnergyServiceData serviceDataFTMS;
     QLowEnergyServiceData serviceDataRSC;
     QLowEnergyServiceData serviceDataHR;
+    NotificationScheduler treadmillScheduler;
     QTimer treadmillTimer;
     bluetoothdevice *treadMill;
 
+    static const uint64_t slopeTimeoutSecs = 30;
     uint64_t lastSlopeChanged = 0;
 
     CharacteristicWriteProcessor2AD9 *writeP2AD9 = 0;
@@ -77,7 +80,8 @@ class virtualtreadmill : public QObject {
 
   private slots:
     void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue);
-    void treadmillProvider();
+    void treadmillProvider(const CharacteristicSnapshot &snapshot);
+    void treadmillTick();
     void reconnect();
     void slopeChanged();
 };
@@ -1,4 +1,5 @@
 #include "webserverinfosender.h"
+#include "latencytrace.h"
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -81,6 +82,10 @@ bool WebServerInfoSender::init() {
         if (!httpServer)
             httpServer = new QHttpServer(this);
         relative2Absolute.clear();
+        httpServer->route(QStringLiteral("/latency"),
+                          []() { return QHttpServerResponse("application/json", latencytrace::json()); });
+        httpServer->route(QStringLiteral("/latency.txt"),
+                          []() { return QHttpServerResponse("text/plain", latencytrace::text().toUtf8()); });
         for (auto fld : folders) {
             idx = fld.lastIndexOf('/');
             qDebug() << QStringLiteral("Folder") << fld;